@@ -0,0 +1,384 @@
+#include <strolb/vulkan.h>
+
+typedef struct
+{
+    VkDeviceSize offset;
+    VkDeviceSize size;
+} slb_MemoryRange;
+
+struct slb_MemoryBlock
+{
+    VkDeviceMemory memory;
+    VkDeviceSize   size;
+    VkDeviceSize   used;
+    uint32_t       memoryTypeIndex;
+    bool           linear;
+    bool           dedicated;
+    void*          mapped;
+    slb_Vector*    freeRanges; // slb_MemoryRange, sorted by offset
+};
+
+static VkDeviceSize slb_AlignUp(VkDeviceSize value,
+                                VkDeviceSize alignment)
+{
+    if (alignment == 0)
+    {
+        return value;
+    }
+
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+slb_Allocator* slb_Allocator_Create(VkDevice         device,
+                                    VkPhysicalDevice physicalDevice)
+{
+    slb_Allocator* allocator = malloc(sizeof(slb_Allocator));
+    allocator->device = device;
+    allocator->blocks = slb_Vector_Create(sizeof(slb_MemoryBlock*), 8);
+    allocator->allocationCount = 0;
+
+    vkGetPhysicalDeviceMemoryProperties(physicalDevice,
+                                        &allocator->memoryProperties);
+
+    return allocator;
+}
+
+static void slb_MemoryBlock_Destroy(slb_Allocator*   allocator,
+                                    slb_MemoryBlock* block)
+{
+    if (block->mapped)
+    {
+        vkUnmapMemory(allocator->device, block->memory);
+    }
+
+    vkFreeMemory(allocator->device, block->memory, NULL);
+    slb_Vector_Free(block->freeRanges);
+    free(block);
+}
+
+void slb_Allocator_Destroy(slb_Allocator* allocator)
+{
+    for (size_t i = 0; i < allocator->blocks->size; i++)
+    {
+        slb_MemoryBlock** block = slb_Vector_Get(allocator->blocks, i);
+        slb_MemoryBlock_Destroy(allocator, *block);
+    }
+
+    slb_Vector_Free(allocator->blocks);
+    free(allocator);
+}
+
+static int slb_Allocator_FindMemoryType(
+    slb_Allocator* allocator, uint32_t typeFilter,
+    VkMemoryPropertyFlags properties)
+{
+    for (uint32_t i = 0;
+         i < allocator->memoryProperties.memoryTypeCount; i++)
+    {
+        if ((typeFilter & (1 << i)) &&
+            (allocator->memoryProperties.memoryTypes[i].propertyFlags &
+             properties) == properties)
+        {
+            return i;
+        }
+    }
+
+    return -1;
+}
+
+static slb_MemoryBlock* slb_Allocator_CreateBlock(
+    slb_Allocator* allocator, VkDeviceSize size,
+    uint32_t memoryTypeIndex, bool linear, bool dedicated)
+{
+    VkMemoryAllocateInfo allocInfo = {0};
+    allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+    allocInfo.allocationSize = size;
+    allocInfo.memoryTypeIndex = memoryTypeIndex;
+
+    VkDeviceMemory memory;
+    if (vkAllocateMemory(allocator->device, &allocInfo, NULL,
+                         &memory) != VK_SUCCESS)
+    {
+        slb_Error("Failed to allocate device memory block",
+                  slb_ErrorType_Error);
+        return NULL;
+    }
+
+    slb_MemoryBlock* block = malloc(sizeof(slb_MemoryBlock));
+    block->memory = memory;
+    block->size = size;
+    block->used = 0;
+    block->memoryTypeIndex = memoryTypeIndex;
+    block->linear = linear;
+    block->dedicated = dedicated;
+    block->mapped = NULL;
+    block->freeRanges = slb_Vector_Create(sizeof(slb_MemoryRange), 8);
+
+    slb_MemoryRange whole = {0, size};
+    slb_Vector_PushBack(block->freeRanges, &whole);
+
+    VkMemoryPropertyFlags flags =
+        allocator->memoryProperties.memoryTypes[memoryTypeIndex]
+            .propertyFlags;
+    if (flags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT)
+    {
+        vkMapMemory(allocator->device, memory, 0, size, 0,
+                    &block->mapped);
+    }
+
+    slb_Vector_PushBack(allocator->blocks, &block);
+
+    return block;
+}
+
+// First fit. The padding in front of an aligned allocation stays in
+// the free list, so a free returns exactly the range it was given.
+static bool slb_MemoryBlock_Allocate(slb_MemoryBlock* block,
+                                     VkDeviceSize     size,
+                                     VkDeviceSize     alignment,
+                                     VkDeviceSize*    offset)
+{
+    for (size_t i = 0; i < block->freeRanges->size; i++)
+    {
+        slb_MemoryRange* range = slb_Vector_Get(block->freeRanges, i);
+
+        VkDeviceSize alignedOffset =
+            slb_AlignUp(range->offset, alignment);
+        VkDeviceSize rangeEnd = range->offset + range->size;
+
+        if (alignedOffset + size > rangeEnd)
+        {
+            continue;
+        }
+
+        slb_MemoryRange before = {range->offset,
+                                  alignedOffset - range->offset};
+        slb_MemoryRange after = {alignedOffset + size,
+                                 rangeEnd - (alignedOffset + size)};
+
+        slb_Vector_Remove(block->freeRanges, i);
+
+        if (after.size > 0)
+        {
+            slb_Vector_Insert(block->freeRanges, i, &after);
+        }
+        if (before.size > 0)
+        {
+            slb_Vector_Insert(block->freeRanges, i, &before);
+        }
+
+        block->used += size;
+        *offset = alignedOffset;
+        return true;
+    }
+
+    return false;
+}
+
+static void slb_MemoryBlock_Free(slb_MemoryBlock* block,
+                                 VkDeviceSize offset, VkDeviceSize size)
+{
+    // Find the first free range after the freed one
+    size_t index = 0;
+    while (index < block->freeRanges->size)
+    {
+        slb_MemoryRange* range =
+            slb_Vector_Get(block->freeRanges, index);
+        if (range->offset > offset)
+        {
+            break;
+        }
+        index++;
+    }
+
+    slb_MemoryRange freed = {offset, size};
+
+    // Merge with the next range
+    if (index < block->freeRanges->size)
+    {
+        slb_MemoryRange* next =
+            slb_Vector_Get(block->freeRanges, index);
+        if (freed.offset + freed.size == next->offset)
+        {
+            freed.size += next->size;
+            slb_Vector_Remove(block->freeRanges, index);
+        }
+    }
+
+    // Merge with the previous range
+    if (index > 0)
+    {
+        slb_MemoryRange* prev =
+            slb_Vector_Get(block->freeRanges, index - 1);
+        if (prev->offset + prev->size == freed.offset)
+        {
+            prev->size += freed.size;
+            block->used -= size;
+            return;
+        }
+    }
+
+    slb_Vector_Insert(block->freeRanges, index, &freed);
+    block->used -= size;
+}
+
+slb_Allocation slb_Allocator_Allocate(
+    slb_Allocator* allocator, VkMemoryRequirements requirements,
+    VkMemoryPropertyFlags properties, bool linear)
+{
+    slb_Allocation allocation = {0};
+
+    int memoryTypeIndex = slb_Allocator_FindMemoryType(
+        allocator, requirements.memoryTypeBits, properties);
+    if (memoryTypeIndex < 0)
+    {
+        slb_Error("Failed to find suitable memory type",
+                  slb_ErrorType_Error);
+        return allocation;
+    }
+
+    slb_MemoryBlock* block = NULL;
+    VkDeviceSize     offset = 0;
+
+    if (requirements.size > SLB_MEMORY_BLOCK_SIZE / 2)
+    {
+        block = slb_Allocator_CreateBlock(allocator, requirements.size,
+                                          memoryTypeIndex, linear,
+                                          true);
+        if (block == NULL)
+        {
+            return allocation;
+        }
+
+        slb_MemoryBlock_Allocate(block, requirements.size,
+                                 requirements.alignment, &offset);
+    }
+    else
+    {
+        for (size_t i = 0; i < allocator->blocks->size; i++)
+        {
+            slb_MemoryBlock* candidate =
+                *(slb_MemoryBlock**)slb_Vector_Get(allocator->blocks,
+                                                    i);
+
+            if (candidate->dedicated ||
+                candidate->memoryTypeIndex != memoryTypeIndex ||
+                candidate->linear != linear ||
+                candidate->size - candidate->used < requirements.size)
+            {
+                continue;
+            }
+
+            if (slb_MemoryBlock_Allocate(candidate, requirements.size,
+                                         requirements.alignment,
+                                         &offset))
+            {
+                block = candidate;
+                break;
+            }
+        }
+
+        if (block == NULL)
+        {
+            block = slb_Allocator_CreateBlock(
+                allocator, SLB_MEMORY_BLOCK_SIZE, memoryTypeIndex,
+                linear, false);
+            if (block == NULL)
+            {
+                return allocation;
+            }
+
+            slb_MemoryBlock_Allocate(block, requirements.size,
+                                     requirements.alignment, &offset);
+        }
+    }
+
+    allocation.block = block;
+    allocation.memory = block->memory;
+    allocation.offset = offset;
+    allocation.size = requirements.size;
+    allocation.mapped =
+        block->mapped ? (char*)block->mapped + offset : NULL;
+
+    allocator->allocationCount++;
+
+    return allocation;
+}
+
+static bool slb_Allocator_HasSpareBlock(slb_Allocator*   allocator,
+                                        slb_MemoryBlock* emptied)
+{
+    for (size_t i = 0; i < allocator->blocks->size; i++)
+    {
+        slb_MemoryBlock* block =
+            *(slb_MemoryBlock**)slb_Vector_Get(allocator->blocks, i);
+
+        if (block != emptied && !block->dedicated &&
+            block->used == 0 &&
+            block->memoryTypeIndex == emptied->memoryTypeIndex &&
+            block->linear == emptied->linear)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void slb_Allocator_Free(slb_Allocator*  allocator,
+                        slb_Allocation* allocation)
+{
+    slb_MemoryBlock* block = allocation->block;
+    if (block == NULL)
+    {
+        return;
+    }
+
+    slb_MemoryBlock_Free(block, allocation->offset, allocation->size);
+    allocator->allocationCount--;
+
+    // Give empty blocks back to the driver, but keep one spare block
+    // of each kind around so a staging buffer created and destroyed
+    // every frame does not allocate every frame
+    if (block->used == 0 &&
+        (block->dedicated ||
+         slb_Allocator_HasSpareBlock(allocator, block)))
+    {
+        for (size_t i = 0; i < allocator->blocks->size; i++)
+        {
+            if (*(slb_MemoryBlock**)slb_Vector_Get(allocator->blocks,
+                                                    i) == block)
+            {
+                slb_Vector_Remove(allocator->blocks, i);
+                break;
+            }
+        }
+
+        slb_MemoryBlock_Destroy(allocator, block);
+    }
+
+    *allocation = (slb_Allocation) {0};
+}
+
+slb_AllocatorStats slb_Allocator_GetStats(slb_Allocator* allocator)
+{
+    slb_AllocatorStats stats = {0};
+    stats.allocationCount = allocator->allocationCount;
+
+    for (size_t i = 0; i < allocator->blocks->size; i++)
+    {
+        slb_MemoryBlock* block =
+            *(slb_MemoryBlock**)slb_Vector_Get(allocator->blocks, i);
+
+        stats.blockCount++;
+        stats.reservedBytes += block->size;
+        stats.usedBytes += block->used;
+
+        if (block->dedicated)
+        {
+            stats.dedicatedBlockCount++;
+        }
+    }
+
+    return stats;
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#define GLFW_INCLUDE_VULKAN
+#include <GLFW/glfw3.h>
+#include <stdbool.h>
+
+#include <strolb/vector.h>
+
+// Size of the VkDeviceMemory blocks resources are carved out of.
+// Anything bigger than half a block gets a dedicated allocation.
+#define SLB_MEMORY_BLOCK_SIZE (32ull * 1024 * 1024)
+
+typedef struct slb_MemoryBlock slb_MemoryBlock;
+
+// A range of a shared memory block, bound to one buffer or image
+typedef struct
+{
+    slb_MemoryBlock* block;
+    VkDeviceMemory   memory;
+    VkDeviceSize     offset;
+    VkDeviceSize     size;
+    void*            mapped; // NULL unless host visible
+} slb_Allocation;
+
+typedef struct
+{
+    uint32_t     blockCount;          // vkAllocateMemory calls alive
+    uint32_t     dedicatedBlockCount; // of which hold one resource
+    uint32_t     allocationCount;     // buffers and images
+    VkDeviceSize reservedBytes;       // Sum of all block sizes
+    VkDeviceSize usedBytes;           // Sum of all allocation sizes
+} slb_AllocatorStats;
+
+// Sub-allocates buffers and images out of large blocks per memory
+// type. Buffers and linear images never share a block with optimal
+// images, so bufferImageGranularity never has to be padded for.
+// Host visible blocks are mapped once for their whole lifetime.
+typedef struct
+{
+    VkDevice                         device;
+    VkPhysicalDeviceMemoryProperties memoryProperties;
+    slb_Vector*                      blocks; // slb_MemoryBlock*
+    uint32_t                         allocationCount;
+} slb_Allocator;
+
+slb_Allocator* slb_Allocator_Create(VkDevice         device,
+                                    VkPhysicalDevice physicalDevice);
+
+// Frees every block, any allocation still alive becomes invalid
+void slb_Allocator_Destroy(slb_Allocator* allocator);
+
+// [linear] is true for buffers and linear tiled images
+slb_Allocation slb_Allocator_Allocate(
+    slb_Allocator* allocator, VkMemoryRequirements requirements,
+    VkMemoryPropertyFlags properties, bool linear);
+
+void slb_Allocator_Free(slb_Allocator*  allocator,
+                        slb_Allocation* allocation);
+
+slb_AllocatorStats slb_Allocator_GetStats(slb_Allocator* allocator);
@@ -0,0 +1,180 @@
+#include <strolb/descriptor.h>
+
+// Pools stop growing past this many sets
+#define SLB_MAX_DESCRIPTOR_POOL_SIZE 4096
+
+static slb_DescriptorPoolEntry*
+slb_DescriptorAllocator_AddPool(slb_DescriptorAllocator* allocator)
+{
+    VkDescriptorPoolSize poolSizes[16] = {0};
+    uint32_t             poolSizeCount = 0;
+
+    for (uint32_t i = 0; i < allocator->ratioCount && i < 16; i++)
+    {
+        uint32_t count = (uint32_t)(allocator->ratios[i].ratio *
+                                    allocator->nextPoolSize);
+
+        poolSizes[poolSizeCount].type = allocator->ratios[i].type;
+        poolSizes[poolSizeCount].descriptorCount =
+            count > 0 ? count : 1;
+        poolSizeCount++;
+    }
+
+    slb_DescriptorPoolEntry entry = {0};
+    entry.maxSets = allocator->nextPoolSize;
+    entry.pool = slb_DescriptorPool_Create(
+        poolSizes, poolSizeCount, entry.maxSets, allocator->device);
+
+    slb_Vector_PushBack(allocator->pools, &entry);
+
+    allocator->nextPoolSize *= 2;
+    if (allocator->nextPoolSize > SLB_MAX_DESCRIPTOR_POOL_SIZE)
+    {
+        allocator->nextPoolSize = SLB_MAX_DESCRIPTOR_POOL_SIZE;
+    }
+
+    return slb_Vector_Get(allocator->pools, allocator->pools->size - 1);
+}
+
+static VkResult slb_DescriptorAllocator_AllocateFromPool(
+    slb_DescriptorAllocator* allocator, slb_DescriptorPoolEntry* entry,
+    VkDescriptorSetLayout layout, VkDescriptorSet* set)
+{
+    VkDescriptorSetAllocateInfo allocInfo = {0};
+    allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+    allocInfo.descriptorPool = entry->pool;
+    allocInfo.descriptorSetCount = 1;
+    allocInfo.pSetLayouts = &layout;
+
+    VkResult result = vkAllocateDescriptorSets(
+        allocator->device->device, &allocInfo, set);
+
+    if (result == VK_SUCCESS)
+    {
+        entry->allocatedSets++;
+    }
+
+    return result;
+}
+
+slb_DescriptorAllocator slb_DescriptorAllocator_Create(
+    slb_Device* device, slb_DescriptorPoolRatio* ratios,
+    uint32_t ratioCount, uint32_t initialPoolSize)
+{
+    slb_DescriptorAllocator allocator = {0};
+    allocator.device = device;
+    allocator.ratioCount = ratioCount;
+    allocator.nextPoolSize = initialPoolSize > 0 ? initialPoolSize : 1;
+    allocator.pools =
+        slb_Vector_Create(sizeof(slb_DescriptorPoolEntry), 4);
+    allocator.freeSets =
+        slb_Vector_Create(sizeof(slb_FreeDescriptorSet), 16);
+
+    allocator.ratios =
+        malloc(sizeof(slb_DescriptorPoolRatio) * ratioCount);
+    memcpy(allocator.ratios, ratios,
+           sizeof(slb_DescriptorPoolRatio) * ratioCount);
+
+    return allocator;
+}
+
+void slb_DescriptorAllocator_Destroy(slb_DescriptorAllocator* allocator)
+{
+    for (size_t i = 0; i < allocator->pools->size; i++)
+    {
+        slb_DescriptorPoolEntry* entry =
+            slb_Vector_Get(allocator->pools, i);
+        vkDestroyDescriptorPool(allocator->device->device, entry->pool,
+                                NULL);
+    }
+
+    slb_Vector_Free(allocator->pools);
+    slb_Vector_Free(allocator->freeSets);
+    free(allocator->ratios);
+
+    *allocator = (slb_DescriptorAllocator) {0};
+}
+
+VkDescriptorSet slb_DescriptorAllocator_Allocate(
+    slb_DescriptorAllocator* allocator, VkDescriptorSetLayout layout)
+{
+    VkDescriptorSet set = VK_NULL_HANDLE;
+
+    // Sets freed most recently are at the back
+    for (size_t i = allocator->freeSets->size; i-- > 0;)
+    {
+        slb_FreeDescriptorSet* freeSet =
+            slb_Vector_Get(allocator->freeSets, i);
+
+        if (freeSet->layout == layout)
+        {
+            set = freeSet->set;
+            slb_Vector_Remove(allocator->freeSets, i);
+            allocator->liveSets++;
+            return set;
+        }
+    }
+
+    // Only the newest pool can have room, older ones were exhausted
+    VkResult result = VK_ERROR_OUT_OF_POOL_MEMORY;
+    if (allocator->pools->size > 0)
+    {
+        slb_DescriptorPoolEntry* entry = slb_Vector_Get(
+            allocator->pools, allocator->pools->size - 1);
+        result = slb_DescriptorAllocator_AllocateFromPool(
+            allocator, entry, layout, &set);
+    }
+
+    if (result == VK_ERROR_OUT_OF_POOL_MEMORY ||
+        result == VK_ERROR_FRAGMENTED_POOL)
+    {
+        slb_DescriptorPoolEntry* entry =
+            slb_DescriptorAllocator_AddPool(allocator);
+        result = slb_DescriptorAllocator_AllocateFromPool(
+            allocator, entry, layout, &set);
+    }
+
+    if (result != VK_SUCCESS)
+    {
+        slb_Error("Failed to allocate descriptor sets",
+                  slb_ErrorType_Error);
+        return VK_NULL_HANDLE;
+    }
+
+    allocator->liveSets++;
+
+    return set;
+}
+
+void slb_DescriptorAllocator_Free(slb_DescriptorAllocator* allocator,
+                                  VkDescriptorSetLayout    layout,
+                                  VkDescriptorSet          set)
+{
+    if (set == VK_NULL_HANDLE)
+    {
+        return;
+    }
+
+    slb_FreeDescriptorSet freeSet = {layout, set};
+    slb_Vector_PushBack(allocator->freeSets, &freeSet);
+    allocator->liveSets--;
+}
+
+slb_DescriptorAllocatorStats
+slb_DescriptorAllocator_GetStats(slb_DescriptorAllocator* allocator)
+{
+    slb_DescriptorAllocatorStats stats = {0};
+    stats.poolCount = allocator->pools->size;
+    stats.liveSets = allocator->liveSets;
+    stats.recycledSets = allocator->freeSets->size;
+
+    for (size_t i = 0; i < allocator->pools->size; i++)
+    {
+        slb_DescriptorPoolEntry* entry =
+            slb_Vector_Get(allocator->pools, i);
+        stats.setCapacity += entry->maxSets;
+        stats.allocatedSets += entry->allocatedSets;
+    }
+
+    return stats;
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <strolb/vulkan.h>
+
+// How many descriptors of [type] a pool reserves per set it can hold
+typedef struct
+{
+    VkDescriptorType type;
+    float            ratio;
+} slb_DescriptorPoolRatio;
+
+typedef struct
+{
+    VkDescriptorPool pool;
+    uint32_t         maxSets;
+    uint32_t         allocatedSets;
+} slb_DescriptorPoolEntry;
+
+typedef struct
+{
+    VkDescriptorSetLayout layout;
+    VkDescriptorSet       set;
+} slb_FreeDescriptorSet;
+
+typedef struct
+{
+    uint32_t poolCount;
+    uint32_t setCapacity;   // Sum of maxSets over all pools
+    uint32_t allocatedSets; // Taken out of a pool, live or recycled
+    uint32_t liveSets;      // Handed out and not freed
+    uint32_t recycledSets;  // Freed and waiting to be handed out
+} slb_DescriptorAllocatorStats;
+
+// Hands out descriptor sets without a fixed upper bound. When the
+// current pool runs out a new, bigger one is chained on. Freed sets
+// are kept per layout and handed out again before touching a pool,
+// so their descriptors have to be rewritten after allocation.
+typedef struct
+{
+    slb_Device*              device;
+    slb_DescriptorPoolRatio* ratios;
+    uint32_t                 ratioCount;
+    uint32_t                 nextPoolSize; // in sets
+    slb_Vector*              pools;        // slb_DescriptorPoolEntry
+    slb_Vector*              freeSets;     // slb_FreeDescriptorSet
+    uint32_t                 liveSets;
+} slb_DescriptorAllocator;
+
+// The first pool holds [initialPoolSize] sets, each pool after that
+// twice as many as the last, up to a cap
+slb_DescriptorAllocator slb_DescriptorAllocator_Create(
+    slb_Device* device, slb_DescriptorPoolRatio* ratios,
+    uint32_t ratioCount, uint32_t initialPoolSize);
+
+// Destroys every pool, which frees every set it allocated
+void slb_DescriptorAllocator_Destroy(
+    slb_DescriptorAllocator* allocator);
+
+VkDescriptorSet slb_DescriptorAllocator_Allocate(
+    slb_DescriptorAllocator* allocator, VkDescriptorSetLayout layout);
+
+// Returns [set] for reuse by the next allocation with the same
+// [layout]. The GPU must be done with it.
+void slb_DescriptorAllocator_Free(slb_DescriptorAllocator* allocator,
+                                  VkDescriptorSetLayout    layout,
+                                  VkDescriptorSet          set);
+
+slb_DescriptorAllocatorStats
+slb_DescriptorAllocator_GetStats(slb_DescriptorAllocator* allocator);
@@ -0,0 +1,558 @@
+#include <strolb/font.h>
+#include FT_MODULE_H
+
+// Gap between glyphs so bilinear filtering never reads a neighbour
+#define SLB_GLYPH_PADDING 2
+
+// Frames in a row a glyph that found no room is tried again
+#define SLB_GLYPH_RETRY_FRAMES 8
+
+static uint32_t slb_GlyphCache_Hash(uint32_t codepoint, uint32_t mask)
+{
+    return (codepoint * 2654435761u) & mask;
+}
+
+static int32_t slb_GlyphCache_Find(slb_GlyphCache* cache,
+                                   uint32_t        codepoint)
+{
+    uint32_t mask = cache->tableCapacity - 1;
+    uint32_t slot = slb_GlyphCache_Hash(codepoint, mask);
+
+    while (cache->table[slot] != -1)
+    {
+        slb_Glyph* glyph = slb_Vector_Get(cache->glyphs,
+                                          cache->table[slot]);
+        if (glyph->codepoint == codepoint)
+        {
+            return cache->table[slot];
+        }
+
+        slot = (slot + 1) & mask;
+    }
+
+    return -1;
+}
+
+static void slb_GlyphCache_InsertIndex(slb_GlyphCache* cache,
+                                       int32_t         index)
+{
+    slb_Glyph* glyph = slb_Vector_Get(cache->glyphs, index);
+
+    uint32_t mask = cache->tableCapacity - 1;
+    uint32_t slot = slb_GlyphCache_Hash(glyph->codepoint, mask);
+
+    while (cache->table[slot] != -1)
+    {
+        slot = (slot + 1) & mask;
+    }
+
+    cache->table[slot] = index;
+}
+
+static void slb_GlyphCache_RebuildTable(slb_GlyphCache* cache,
+                                        uint32_t        capacity)
+{
+    free(cache->table);
+
+    cache->tableCapacity = capacity;
+    cache->table = malloc(sizeof(int32_t) * capacity);
+    memset(cache->table, 0xff, sizeof(int32_t) * capacity);
+
+    for (size_t i = 0; i < cache->glyphs->size; i++)
+    {
+        slb_GlyphCache_InsertIndex(cache, (int32_t)i);
+    }
+}
+
+static void slb_GlyphPage_MarkDirty(slb_GlyphPage* page, int x, int y,
+                                    int width, int height)
+{
+    if (page->dirtyMinX >= page->dirtyMaxX)
+    {
+        page->dirtyMinX = x;
+        page->dirtyMinY = y;
+        page->dirtyMaxX = x + width;
+        page->dirtyMaxY = y + height;
+        return;
+    }
+
+    page->dirtyMinX = x < page->dirtyMinX ? x : page->dirtyMinX;
+    page->dirtyMinY = y < page->dirtyMinY ? y : page->dirtyMinY;
+    page->dirtyMaxX =
+        x + width > page->dirtyMaxX ? x + width : page->dirtyMaxX;
+    page->dirtyMaxY =
+        y + height > page->dirtyMaxY ? y + height : page->dirtyMaxY;
+}
+
+// Empties the page, the whole layer is uploaded again on the next
+// flush so no stale glyph survives in it
+static void slb_GlyphPage_Reset(slb_GlyphPage* page)
+{
+    memset(page->pixels, 0, SLB_GLYPH_PAGE_SIZE * SLB_GLYPH_PAGE_SIZE);
+    page->penX = 0;
+    page->penY = 0;
+    page->rowHeight = 0;
+    page->dirtyMinX = 0;
+    page->dirtyMaxX = 0;
+    slb_GlyphPage_MarkDirty(page, 0, 0, SLB_GLYPH_PAGE_SIZE,
+                            SLB_GLYPH_PAGE_SIZE);
+}
+
+// Shelf packing, glyphs go left to right in rows as tall as the
+// tallest glyph in them
+static bool slb_GlyphPage_Pack(slb_GlyphPage* page, int width,
+                               int height, int* x, int* y)
+{
+    if (page->penX + width > SLB_GLYPH_PAGE_SIZE)
+    {
+        page->penX = 0;
+        page->penY += page->rowHeight + SLB_GLYPH_PADDING;
+        page->rowHeight = 0;
+    }
+
+    if (page->penY + height > SLB_GLYPH_PAGE_SIZE)
+    {
+        return false;
+    }
+
+    *x = page->penX;
+    *y = page->penY;
+
+    page->penX += width + SLB_GLYPH_PADDING;
+    page->rowHeight =
+        height > page->rowHeight ? height : page->rowHeight;
+
+    return true;
+}
+
+// Clears the least recently drawn page and forgets its glyphs. Pages
+// used this frame are never picked. Returns the page, or -1.
+static int slb_GlyphCache_EvictPage(slb_GlyphCache* cache)
+{
+    int victim = -1;
+
+    for (int i = 0; i < SLB_GLYPH_PAGE_COUNT; i++)
+    {
+        if (cache->pages[i].lastUsed == cache->frame)
+        {
+            continue;
+        }
+
+        if (victim < 0 ||
+            cache->pages[i].lastUsed < cache->pages[victim].lastUsed)
+        {
+            victim = i;
+        }
+    }
+
+    if (victim < 0)
+    {
+        return -1;
+    }
+
+    size_t kept = 0;
+    for (size_t i = 0; i < cache->glyphs->size; i++)
+    {
+        slb_Glyph* glyph = slb_Vector_Get(cache->glyphs, i);
+
+        if (glyph->page != (uint32_t)victim)
+        {
+            if (kept != i)
+            {
+                memcpy(slb_Vector_Get(cache->glyphs, kept), glyph,
+                       sizeof(slb_Glyph));
+            }
+            kept++;
+        }
+    }
+    cache->glyphs->size = kept;
+
+    slb_GlyphPage_Reset(&cache->pages[victim]);
+    slb_GlyphCache_RebuildTable(cache, cache->tableCapacity);
+    cache->generation++;
+
+    return victim;
+}
+
+// Sets [full] when the glyph only failed to fit because every page
+// was drawn this frame, so it can be tried again later
+static bool slb_GlyphCache_Allocate(slb_GlyphCache* cache, int width,
+                                    int height, uint32_t* page, int* x,
+                                    int* y, bool* full)
+{
+    *full = false;
+
+    if (width + SLB_GLYPH_PADDING > SLB_GLYPH_PAGE_SIZE ||
+        height + SLB_GLYPH_PADDING > SLB_GLYPH_PAGE_SIZE)
+    {
+        slb_Error("Glyph is bigger than a font atlas page",
+                  slb_ErrorType_Warning);
+        return false;
+    }
+
+    for (int i = 0; i < SLB_GLYPH_PAGE_COUNT; i++)
+    {
+        if (slb_GlyphPage_Pack(&cache->pages[i], width, height, x, y))
+        {
+            *page = i;
+            return true;
+        }
+    }
+
+    int victim = slb_GlyphCache_EvictPage(cache);
+    if (victim < 0)
+    {
+        // Every glyph that doesn't fit this frame ends up here
+        if (cache->fullWarningFrame != cache->frame)
+        {
+            slb_Error("Every font atlas page is in use this frame",
+                      slb_ErrorType_Warning);
+            cache->fullWarningFrame = cache->frame;
+        }
+        *full = true;
+        return false;
+    }
+
+    *page = victim;
+    return slb_GlyphPage_Pack(&cache->pages[victim], width, height, x,
+                              y);
+}
+
+slb_GlyphCache slb_GlyphCache_Create(const char* fontPath,
+                                     int         pixelSize,
+                                     slb_PhysicalDevice physicalDevice,
+                                     slb_Device*        device,
+                                     slb_UploadContext* uploadContext)
+{
+    slb_GlyphCache cache = {0};
+    cache.pixelSize = pixelSize;
+    cache.device = device;
+    cache.uploadContext = uploadContext;
+    cache.frame = 1;
+
+    if (FT_Init_FreeType(&cache.library))
+    {
+        slb_Error("Could not init FreeType Library",
+                  slb_ErrorType_Error);
+        return cache;
+    }
+
+    if (FT_New_Face(cache.library, fontPath, 0, &cache.face))
+    {
+        slb_Error("Failed to load font", slb_ErrorType_Error);
+        cache.face = NULL;
+        return cache;
+    }
+
+    FT_Int spread = SLB_GLYPH_SDF_SPREAD;
+    FT_Property_Set(cache.library, "sdf", "spread", &spread);
+    FT_Property_Set(cache.library, "bsdf", "spread", &spread);
+
+    FT_Set_Pixel_Sizes(cache.face, 0, pixelSize);
+
+    if (FT_Load_Char(cache.face, 'A', FT_LOAD_DEFAULT) == 0)
+    {
+        cache.capHeight =
+            (float)(cache.face->glyph->metrics.height >> 6);
+    }
+
+    cache.atlas = slb_Image_CreateArray(
+        device, physicalDevice, SLB_GLYPH_PAGE_SIZE,
+        SLB_GLYPH_PAGE_SIZE, SLB_GLYPH_PAGE_COUNT, VK_FORMAT_R8_UNORM,
+        VK_IMAGE_TILING_OPTIMAL,
+        VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
+        VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+
+    cache.atlas.imageView = slb_ImageView_CreateArray(
+        device, cache.atlas.image, VK_FORMAT_R8_UNORM,
+        VK_IMAGE_ASPECT_COLOR_BIT, SLB_GLYPH_PAGE_COUNT);
+
+    cache.atlas.sampler = slb_Sampler_Create(
+        VK_FILTER_LINEAR, VK_FILTER_LINEAR, false, 1.0f, false, false,
+        VK_COMPARE_OP_ALWAYS, VK_SAMPLER_MIPMAP_MODE_LINEAR, device);
+
+    for (int i = 0; i < SLB_GLYPH_PAGE_COUNT; i++)
+    {
+        cache.pages[i].pixels =
+            malloc(SLB_GLYPH_PAGE_SIZE * SLB_GLYPH_PAGE_SIZE);
+        slb_GlyphPage_Reset(&cache.pages[i]);
+    }
+
+    cache.glyphs = slb_Vector_Create(sizeof(slb_Glyph), 256);
+    slb_GlyphCache_RebuildTable(&cache, 512);
+
+    return cache;
+}
+
+void slb_GlyphCache_Destroy(slb_GlyphCache* cache)
+{
+    if (cache->face == NULL)
+    {
+        if (cache->library != NULL)
+        {
+            FT_Done_FreeType(cache->library);
+        }
+        return;
+    }
+
+    for (int i = 0; i < SLB_GLYPH_PAGE_COUNT; i++)
+    {
+        free(cache->pages[i].pixels);
+    }
+
+    slb_Vector_Free(cache->glyphs);
+    free(cache->table);
+
+    vkDestroySampler(cache->device->device, cache->atlas.sampler, NULL);
+    slb_Image_Destroy(&cache->atlas, cache->device);
+
+    FT_Done_Face(cache->face);
+    FT_Done_FreeType(cache->library);
+}
+
+slb_Glyph slb_GlyphCache_Get(slb_GlyphCache* cache, uint32_t codepoint)
+{
+    int32_t index = slb_GlyphCache_Find(cache, codepoint);
+    if (index >= 0)
+    {
+        slb_Glyph* glyph = slb_Vector_Get(cache->glyphs, index);
+
+        // Keep the page alive for whatever is being laid out with it
+        if (glyph->page != SLB_GLYPH_NO_PAGE)
+        {
+            cache->pages[glyph->page].lastUsed = cache->frame;
+        }
+
+        return *glyph;
+    }
+
+    slb_Glyph glyph = {0};
+    glyph.codepoint = codepoint;
+    glyph.page = SLB_GLYPH_NO_PAGE;
+
+    if (cache->face == NULL)
+    {
+        return glyph;
+    }
+
+    // Codepoints the font lacks load glyph 0, its missing glyph box
+    if (FT_Load_Char(cache->face, codepoint, FT_LOAD_DEFAULT) == 0)
+    {
+        FT_GlyphSlot g = cache->face->glyph;
+        glyph.ax = (float)(g->advance.x >> 6);
+
+        // Bitmap only fonts have no outline to build a field from. The
+        // atlas is R8, so mono and colour bitmaps are left blank.
+        bool rendered = (FT_Render_Glyph(g, FT_RENDER_MODE_SDF) == 0 ||
+                         FT_Render_Glyph(g, FT_RENDER_MODE_NORMAL) == 0) &&
+                        g->bitmap.pixel_mode == FT_PIXEL_MODE_GRAY;
+
+        int  width = g->bitmap.width;
+        int  height = g->bitmap.rows;
+        int  x, y;
+        bool full = false;
+
+        if (rendered && width > 0 && height > 0 &&
+            slb_GlyphCache_Allocate(cache, width, height, &glyph.page,
+                                    &x, &y, &full))
+        {
+            slb_GlyphPage* page = &cache->pages[glyph.page];
+
+            int pitch = g->bitmap.pitch < 0 ? -g->bitmap.pitch
+                                            : g->bitmap.pitch;
+            for (int row = 0; row < height; row++)
+            {
+                memcpy(page->pixels +
+                           (y + row) * SLB_GLYPH_PAGE_SIZE + x,
+                       g->bitmap.buffer + row * pitch, width);
+            }
+
+            slb_GlyphPage_MarkDirty(page, x, y, width, height);
+            page->lastUsed = cache->frame;
+
+            glyph.bw = (float)width;
+            glyph.bh = (float)height;
+            glyph.bl = (float)g->bitmap_left;
+            glyph.bt = (float)g->bitmap_top;
+            glyph.u0 = (float)x / SLB_GLYPH_PAGE_SIZE;
+            glyph.v0 = (float)y / SLB_GLYPH_PAGE_SIZE;
+            glyph.u1 = (float)(x + width) / SLB_GLYPH_PAGE_SIZE;
+            glyph.v1 = (float)(y + height) / SLB_GLYPH_PAGE_SIZE;
+        }
+        else
+        {
+            glyph.page = SLB_GLYPH_NO_PAGE;
+        }
+
+        // Left out of the cache so it's rasterized again when the text
+        // is laid out next frame, instead of staying blank. Past
+        // SLB_GLYPH_RETRY_FRAMES it's cached blank after all, so a
+        // frame that needs more than the atlas holds can still go idle.
+        if (full && cache->retryFrames < SLB_GLYPH_RETRY_FRAMES)
+        {
+            cache->glyphsDeferred = true;
+            return glyph;
+        }
+    }
+
+    slb_Vector_PushBack(cache->glyphs, &glyph);
+
+    if (cache->glyphs->size * 2 > cache->tableCapacity)
+    {
+        slb_GlyphCache_RebuildTable(cache, cache->tableCapacity * 2);
+    }
+    else
+    {
+        slb_GlyphCache_InsertIndex(cache,
+                                   (int32_t)cache->glyphs->size - 1);
+    }
+
+    return glyph;
+}
+
+void slb_GlyphCache_BeginFrame(slb_GlyphCache* cache)
+{
+    cache->frame++;
+
+    // Pages drawn last frame can be evicted now, so have the text
+    // missing a glyph laid out again
+    if (!cache->glyphsDeferred)
+    {
+        cache->retryFrames = 0;
+    }
+    else if (cache->retryFrames < SLB_GLYPH_RETRY_FRAMES)
+    {
+        cache->retryFrames++;
+        cache->generation++;
+    }
+    cache->glyphsDeferred = false;
+}
+
+void slb_GlyphCache_TouchPages(slb_GlyphCache* cache, uint32_t pageMask)
+{
+    for (int i = 0; i < SLB_GLYPH_PAGE_COUNT; i++)
+    {
+        if (pageMask & (1u << i))
+        {
+            cache->pages[i].lastUsed = cache->frame;
+        }
+    }
+}
+
+void slb_GlyphCache_Flush(slb_GlyphCache* cache)
+{
+    if (cache->face == NULL)
+    {
+        return;
+    }
+
+    bool dirty = false;
+    for (int i = 0; i < SLB_GLYPH_PAGE_COUNT; i++)
+    {
+        dirty |= cache->pages[i].dirtyMinX < cache->pages[i].dirtyMaxX;
+    }
+
+    if (!dirty)
+    {
+        return;
+    }
+
+    // Before the first flush every page is dirty as a whole, so the
+    // old contents can be discarded
+    slb_UploadContext_TransitionImageLayers(
+        cache->uploadContext, cache->atlas.image, SLB_GLYPH_PAGE_COUNT,
+        cache->atlasInitialized
+            ? VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL
+            : VK_IMAGE_LAYOUT_UNDEFINED,
+        VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
+
+    for (int i = 0; i < SLB_GLYPH_PAGE_COUNT; i++)
+    {
+        slb_GlyphPage* page = &cache->pages[i];
+
+        if (page->dirtyMinX >= page->dirtyMaxX)
+        {
+            continue;
+        }
+
+        int width = page->dirtyMaxX - page->dirtyMinX;
+        int height = page->dirtyMaxY - page->dirtyMinY;
+
+        unsigned char* region = malloc(width * height);
+        for (int row = 0; row < height; row++)
+        {
+            memcpy(region + row * width,
+                   page->pixels +
+                       (page->dirtyMinY + row) * SLB_GLYPH_PAGE_SIZE +
+                       page->dirtyMinX,
+                   width);
+        }
+
+        slb_UploadContext_CopyToImageRegion(
+            cache->uploadContext, region, width * height,
+            cache->atlas.image, i,
+            (VkOffset2D) {page->dirtyMinX, page->dirtyMinY},
+            (VkExtent2D) {width, height});
+
+        free(region);
+
+        page->dirtyMinX = 0;
+        page->dirtyMaxX = 0;
+    }
+
+    slb_UploadContext_TransitionImageLayers(
+        cache->uploadContext, cache->atlas.image, SLB_GLYPH_PAGE_COUNT,
+        VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+        VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+
+    cache->atlasInitialized = true;
+}
+
+uint32_t slb_Utf8_Decode(const char** text)
+{
+    const unsigned char* bytes = (const unsigned char*)*text;
+
+    uint32_t codepoint;
+    int      length;
+
+    if (bytes[0] < 0x80)
+    {
+        codepoint = bytes[0];
+        length = 1;
+    }
+    else if ((bytes[0] & 0xe0) == 0xc0)
+    {
+        codepoint = bytes[0] & 0x1f;
+        length = 2;
+    }
+    else if ((bytes[0] & 0xf0) == 0xe0)
+    {
+        codepoint = bytes[0] & 0x0f;
+        length = 3;
+    }
+    else if ((bytes[0] & 0xf8) == 0xf0)
+    {
+        codepoint = bytes[0] & 0x07;
+        length = 4;
+    }
+    else
+    {
+        *text += 1;
+        return 0xfffd;
+    }
+
+    // Also stops at the terminator of a truncated sequence
+    for (int i = 1; i < length; i++)
+    {
+        if ((bytes[i] & 0xc0) != 0x80)
+        {
+            *text += 1;
+            return 0xfffd;
+        }
+
+        codepoint = (codepoint << 6) | (bytes[i] & 0x3f);
+    }
+
+    *text += length;
+    return codepoint;
+}
@@ -0,0 +1,102 @@
+#pragma once
+
+#include <strolb/vulkan.h>
+#include <ft2build.h>
+#include FT_FREETYPE_H
+
+// Each page is one layer of the atlas array image
+#define SLB_GLYPH_PAGE_SIZE  1024
+#define SLB_GLYPH_PAGE_COUNT 4
+
+// Distance in pixels the SDF ramps over on each side of an outline.
+// Glyph bitmaps are padded by this much.
+#define SLB_GLYPH_SDF_SPREAD 8
+
+// Marks a glyph with nothing to draw, like a space
+#define SLB_GLYPH_NO_PAGE UINT32_MAX
+
+// Metrics are in pixels at the cache's size, like FreeType's, with
+// the bitmap including its SDF padding
+typedef struct
+{
+    uint32_t codepoint;
+    float    ax; // advance.x
+    float    bw; // bitmap.width
+    float    bh; // bitmap.rows
+    float    bl; // bitmap_left
+    float    bt; // bitmap_top
+    float    u0; // Atlas rectangle, normalized
+    float    v0;
+    float    u1;
+    float    v1;
+    uint32_t page; // Atlas layer, or SLB_GLYPH_NO_PAGE
+} slb_Glyph;
+
+typedef struct
+{
+    unsigned char* pixels; // CPU copy of the layer
+    int            penX;
+    int            penY;
+    int            rowHeight;
+    uint64_t       lastUsed; // Frame the page was last drawn in
+    int            dirtyMinX;
+    int            dirtyMinY;
+    int            dirtyMaxX; // Empty when dirtyMinX >= dirtyMaxX
+    int            dirtyMaxY;
+} slb_GlyphPage;
+
+// Rasterizes glyphs as signed distance fields the first time their
+// codepoint is asked for, so one size stays sharp at every zoom
+// level. Glyphs are shelf packed into atlas pages, only the part of a
+// page written since the last flush is uploaded, and when every page
+// is full the least recently drawn one is cleared for reuse.
+typedef struct
+{
+    FT_Library         library;
+    FT_Face            face; // NULL if the font failed to load
+    int                pixelSize;
+    float              capHeight; // Height of 'A' without padding
+    slb_Image          atlas;     // R8 2D array, one layer per page
+    slb_GlyphPage      pages[SLB_GLYPH_PAGE_COUNT];
+    bool               atlasInitialized;
+    slb_Vector*        glyphs; // slb_Glyph
+    int32_t*           table;  // codepoint -> glyphs index, -1 if empty
+    uint32_t           tableCapacity;
+    uint64_t           frame;
+    uint32_t           generation; // Bumped whenever a page is evicted
+    bool               glyphsDeferred; // A glyph found no room this frame
+    uint32_t           retryFrames;      // In a row, retrying glyphs
+    uint64_t           fullWarningFrame; // Last one to warn it's full
+    slb_Device*        device;
+    slb_UploadContext* uploadContext;
+} slb_GlyphCache;
+
+slb_GlyphCache slb_GlyphCache_Create(const char* fontPath,
+                                     int         pixelSize,
+                                     slb_PhysicalDevice physicalDevice,
+                                     slb_Device*        device,
+                                     slb_UploadContext* uploadContext);
+
+void slb_GlyphCache_Destroy(slb_GlyphCache* cache);
+
+// Returns the glyph for [codepoint], rasterizing it if needed. Its
+// atlas rectangle stays valid until the generation changes. A glyph
+// that can't fit while every page is in use comes back without a page
+// and the generation changes next frame, so it gets asked for again.
+// After a few frames of that it is cached without a page instead.
+slb_Glyph slb_GlyphCache_Get(slb_GlyphCache* cache, uint32_t codepoint);
+
+// Starts a new frame for the least recently used bookkeeping
+void slb_GlyphCache_BeginFrame(slb_GlyphCache* cache);
+
+// Marks the pages in [pageMask] (bit n for page n) as drawn this
+// frame. Those pages are not evicted until a later frame.
+void slb_GlyphCache_TouchPages(slb_GlyphCache* cache, uint32_t pageMask);
+
+// Records the upload of every dirty page region into the upload
+// context
+void slb_GlyphCache_Flush(slb_GlyphCache* cache);
+
+// Decodes one UTF-8 sequence and advances [text] past it. Malformed
+// input decodes to U+FFFD one byte at a time.
+uint32_t slb_Utf8_Decode(const char** text);
@@ -359,6 +359,59 @@ bool slb_ImGui_InputTextMultiline(const char* name, char* buffer,
         ImGuiInputTextFlags_AllowTabInput);
 }
 
+struct slb_ImGuiResizeData
+{
+    char**  buffer;
+    size_t* capacity;
+};
+
+static int slb_ImGui_ResizeCallback(ImGuiInputTextCallbackData* data)
+{
+    if (data->EventFlag == ImGuiInputTextFlags_CallbackResize)
+    {
+        slb_ImGuiResizeData* resize =
+            (slb_ImGuiResizeData*)data->UserData;
+
+        size_t capacity = *resize->capacity > 0 ? *resize->capacity : 64;
+        while (capacity < (size_t)data->BufSize)
+        {
+            capacity *= 2;
+        }
+
+        *resize->buffer = (char*)realloc(*resize->buffer, capacity);
+        *resize->capacity = capacity;
+
+        data->Buf = *resize->buffer;
+        data->BufSize = (int)capacity;
+    }
+
+    return 0;
+}
+
+bool slb_ImGui_InputTextResize(const char* name, char** buffer,
+                               size_t* capacity, int flags)
+{
+    slb_ImGuiResizeData resize = {buffer, capacity};
+
+    return ImGui::InputText(
+        name, *buffer, *capacity,
+        flags | ImGuiInputTextFlags_CallbackResize,
+        slb_ImGui_ResizeCallback, &resize);
+}
+
+bool slb_ImGui_InputTextMultilineResize(const char* name, char** buffer,
+                                        size_t* capacity, int flags)
+{
+    slb_ImGuiResizeData resize = {buffer, capacity};
+
+    return ImGui::InputTextMultiline(
+        name, *buffer, *capacity,
+        ImVec2(-FLT_MIN, ImGui::GetTextLineHeight() * 16),
+        flags | ImGuiInputTextFlags_AllowTabInput |
+            ImGuiInputTextFlags_CallbackResize,
+        slb_ImGui_ResizeCallback, &resize);
+}
+
 bool slb_ImGui_ColorEdit4(const char* name, float* val)
 {
     return ImGui::ColorEdit4(name, val);
@@ -501,4 +554,10 @@ bool slb_ImGui_IsHovering()
     return io.WantCaptureMouse;
 }
 
+bool slb_ImGui_IsTyping()
+{
+    ImGuiIO& io = ImGui::GetIO();
+    return io.WantTextInput;
+}
+
 }
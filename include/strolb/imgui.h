@@ -55,6 +55,13 @@ bool slb_ImGui_InputText(const char* name, char* buffer, size_t size,
 bool slb_ImGui_InputTextMultiline(const char* name, char* buffer, size_t size,
                        int flags);
 
+// Like the above, but [buffer] is a malloc'd string that is grown with
+// realloc as the text gets longer, updating [capacity]
+bool slb_ImGui_InputTextResize(const char* name, char** buffer,
+                               size_t* capacity, int flags);
+bool slb_ImGui_InputTextMultilineResize(const char* name, char** buffer,
+                                        size_t* capacity, int flags);
+
 bool slb_ImGui_ColorEdit4(const char* name, float* val);
 
 bool slb_ImGui_IsWindowHovered();
@@ -92,6 +99,7 @@ void slb_ImGui_EndMenu();
 void slb_ImGui_EndMainMenuBar();
 
 bool slb_ImGui_IsHovering();
+bool slb_ImGui_IsTyping(); // A text field has keyboard focus
 
 #ifdef __cplusplus
 }
@@ -1,19 +1,367 @@
 #include <nlohmann/json.hpp>
 #include <strolb/json.h>
+#include <strolb/jsontape.h>
 #include <string>
+#include <cmath>
 #include <cstring>
+#include <cstdint>
 #include <fstream>
 
+// A root loaded by the tape backend keeps its tape. Views read the
+// tape, and [json] is only built from it when something else needs it.
 struct slb_Json_t
 {
     nlohmann::json json;
+    slb_JsonTape   tape;      // words is NULL unless loaded as a tape
+    bool           treeBuilt; // [json] holds what the tape does
 };
 
+// Where the last slb_JsonView_At on a tape landed, so walking an array
+// forwards doesn't start over from its first element every time
+struct slb_JsonTapeCursor
+{
+    const uint64_t* array;
+    size_t          index;
+    const uint64_t* element;
+};
+
+static slb_JsonBackend                  jsonBackend = slb_JsonBackend_Tape;
+static thread_local slb_JsonTapeCursor tapeCursor;
+
+// Builds the tree of the tape value at [word]. Repeated keys keep the
+// last value, the same as nlohmann's own parser.
+static nlohmann::json slb_Json_TreeFromTape(const uint64_t* word)
+{
+    switch (slb_JsonTape_Type(word))
+    {
+    case slb_JsonTapeType_Object:
+    {
+        nlohmann::json  object = nlohmann::json::object();
+        const uint64_t* end = slb_JsonTape_Skip(word);
+
+        for (const uint64_t* key = word + 1; key < end;
+             key = slb_JsonTape_Skip(key + 1))
+        {
+            size_t      length;
+            const char* name = slb_JsonTape_String(key, &length);
+            object[std::string(name, length)] =
+                slb_Json_TreeFromTape(key + 1);
+        }
+
+        return object;
+    }
+    case slb_JsonTapeType_Array:
+    {
+        nlohmann::json  array = nlohmann::json::array();
+        const uint64_t* end = slb_JsonTape_Skip(word);
+
+        array.get_ref<nlohmann::json::array_t&>().reserve(
+            slb_JsonTape_Count(word));
+
+        for (const uint64_t* element = word + 1; element < end;
+             element = slb_JsonTape_Skip(element))
+        {
+            array.push_back(slb_Json_TreeFromTape(element));
+        }
+
+        return array;
+    }
+    case slb_JsonTapeType_String:
+    {
+        size_t      length;
+        const char* string = slb_JsonTape_String(word, &length);
+        return std::string(string, length);
+    }
+    case slb_JsonTapeType_Int:
+        return slb_JsonTape_Int(word);
+    case slb_JsonTapeType_Unsigned:
+        return slb_JsonTape_Unsigned(word);
+    case slb_JsonTapeType_Double:
+        return slb_JsonTape_Double(word);
+    case slb_JsonTapeType_True:
+        return true;
+    case slb_JsonTapeType_False:
+        return false;
+    default:
+        return nullptr;
+    }
+}
+
+static void slb_Json_DropTape(slb_Json j)
+{
+    if (j->tape.words != nullptr)
+    {
+        slb_JsonTape_Destroy(&j->tape);
+        tapeCursor = {};
+    }
+}
+
+// The tree of [j] for reading, built from the tape the first time
+static nlohmann::json& slb_Json_Tree(slb_Json j)
+{
+    if (j->tape.words != nullptr && !j->treeBuilt)
+    {
+        j->json = slb_Json_TreeFromTape(j->tape.words);
+        j->treeBuilt = true;
+    }
+
+    return j->json;
+}
+
+// The tree of [j] for changing, after which the tape is out of date
+static nlohmann::json& slb_Json_EditTree(slb_Json j)
+{
+    slb_Json_Tree(j);
+    slb_Json_DropTape(j);
+
+    return j->json;
+}
+
 struct slb_JsonIterator_t
 {
     nlohmann::json::iterator it;
 };
 
+// Views of a tape point at one of its words with the low bit set,
+// which a pointer to a nlohmann::json never has
+static bool slb_JsonView_IsTape(slb_JsonView view)
+{
+    return (reinterpret_cast<uintptr_t>(view) & 1) != 0;
+}
+
+static const uint64_t* slb_JsonView_Word(slb_JsonView view)
+{
+    return reinterpret_cast<const uint64_t*>(
+        reinterpret_cast<uintptr_t>(view) & ~uintptr_t(1));
+}
+
+static slb_JsonView slb_JsonView_MakeTape(const uint64_t* word)
+{
+    return reinterpret_cast<slb_JsonView>(
+        reinterpret_cast<uintptr_t>(word) | 1);
+}
+
+static const nlohmann::json* slb_JsonView_Node(slb_JsonView view)
+{
+    return reinterpret_cast<const nlohmann::json*>(view);
+}
+
+static slb_JsonView slb_JsonView_Make(const nlohmann::json& node)
+{
+    return reinterpret_cast<slb_JsonView>(&node);
+}
+
+// Returns false if [view] isn't a number
+template <typename T>
+static bool slb_JsonView_Number(slb_JsonView view, T* val)
+{
+    if (view == nullptr)
+    {
+        return false;
+    }
+
+    if (slb_JsonView_IsTape(view))
+    {
+        const uint64_t* word = slb_JsonView_Word(view);
+
+        switch (slb_JsonTape_Type(word))
+        {
+        case slb_JsonTapeType_Int:
+            *val = static_cast<T>(slb_JsonTape_Int(word));
+            return true;
+        case slb_JsonTapeType_Unsigned:
+            *val = static_cast<T>(slb_JsonTape_Unsigned(word));
+            return true;
+        case slb_JsonTapeType_Double:
+            *val = static_cast<T>(slb_JsonTape_Double(word));
+            return true;
+        default:
+            return false;
+        }
+    }
+
+    const nlohmann::json* node = slb_JsonView_Node(view);
+    if (!node->is_number())
+    {
+        return false;
+    }
+
+    *val = node->get<T>();
+    return true;
+}
+
+template <typename T>
+static size_t slb_JsonView_ReadNumbers(slb_JsonView view, T* values,
+                                       size_t capacity)
+{
+    if (!slb_JsonView_IsArray(view))
+    {
+        return 0;
+    }
+
+    size_t count = slb_JsonView_Size(view);
+    size_t read = count < capacity ? count : capacity;
+
+    if (slb_JsonView_IsTape(view))
+    {
+        const uint64_t* element = slb_JsonView_Word(view) + 1;
+
+        for (size_t i = 0; i < read; i++)
+        {
+            if (!slb_JsonView_Number(slb_JsonView_MakeTape(element),
+                                     &values[i]))
+            {
+                values[i] = T(0);
+            }
+            element = slb_JsonTape_Skip(element);
+        }
+    }
+    else
+    {
+        const nlohmann::json* node = slb_JsonView_Node(view);
+
+        for (size_t i = 0; i < read; i++)
+        {
+            if (!slb_JsonView_Number(slb_JsonView_Make((*node)[i]),
+                                     &values[i]))
+            {
+                values[i] = T(0);
+            }
+        }
+    }
+
+    return count;
+}
+
+// Forwards nlohmann's SAX callbacks to a slb_JsonEventFunc
+struct slb_JsonEventHandler
+{
+    using number_integer_t = nlohmann::json::number_integer_t;
+    using number_unsigned_t = nlohmann::json::number_unsigned_t;
+    using number_float_t = nlohmann::json::number_float_t;
+    using string_t = nlohmann::json::string_t;
+    using binary_t = nlohmann::json::binary_t;
+
+    slb_JsonEventFunc func;
+    void*             userData;
+
+    bool Emit(slb_JsonEventType type)
+    {
+        slb_JsonEvent event = {};
+        event.type = type;
+        return func(&event, userData);
+    }
+
+    bool EmitString(slb_JsonEventType type, const string_t& val)
+    {
+        slb_JsonEvent event = {};
+        event.type = type;
+        event.string = val.c_str();
+        event.length = val.size();
+        return func(&event, userData);
+    }
+
+    bool EmitInteger(int64_t val)
+    {
+        slb_JsonEvent event = {};
+        event.type = slb_JsonEventType_Number;
+        event.number = (double)val;
+        event.integer = val;
+        event.isInteger = true;
+        return func(&event, userData);
+    }
+
+    bool null()
+    {
+        return Emit(slb_JsonEventType_Null);
+    }
+
+    bool boolean(bool val)
+    {
+        slb_JsonEvent event = {};
+        event.type = slb_JsonEventType_Bool;
+        event.boolean = val;
+        return func(&event, userData);
+    }
+
+    bool number_integer(number_integer_t val)
+    {
+        return EmitInteger(val);
+    }
+
+    bool number_unsigned(number_unsigned_t val)
+    {
+        if (val <= (number_unsigned_t)INT64_MAX)
+        {
+            return EmitInteger((int64_t)val);
+        }
+
+        slb_JsonEvent event = {};
+        event.type = slb_JsonEventType_Number;
+        event.number = (double)val;
+        return func(&event, userData);
+    }
+
+    bool number_float(number_float_t val, const string_t&)
+    {
+        slb_JsonEvent event = {};
+        event.type = slb_JsonEventType_Number;
+        event.number = val;
+
+        // Converting a double outside int64_t is undefined, and 2^63
+        // is the first one past INT64_MAX
+        if (val >= -9223372036854775808.0 &&
+            val < 9223372036854775808.0 && std::trunc(val) == val)
+        {
+            event.integer = (int64_t)val;
+            event.isInteger = true;
+        }
+
+        return func(&event, userData);
+    }
+
+    bool string(string_t& val)
+    {
+        return EmitString(slb_JsonEventType_String, val);
+    }
+
+    bool binary(binary_t&)
+    {
+        return false; // Not something JSON text can hold
+    }
+
+    bool start_object(std::size_t)
+    {
+        return Emit(slb_JsonEventType_BeginObject);
+    }
+
+    bool key(string_t& val)
+    {
+        return EmitString(slb_JsonEventType_Key, val);
+    }
+
+    bool end_object()
+    {
+        return Emit(slb_JsonEventType_EndObject);
+    }
+
+    bool start_array(std::size_t)
+    {
+        return Emit(slb_JsonEventType_BeginArray);
+    }
+
+    bool end_array()
+    {
+        return Emit(slb_JsonEventType_EndArray);
+    }
+
+    bool parse_error(std::size_t, const std::string&,
+                     const nlohmann::detail::exception&)
+    {
+        return false;
+    }
+};
+
 extern "C"
 {
 
@@ -25,6 +373,10 @@ slb_Json slb_Json_Create()
 
 void slb_Json_Destroy(slb_Json j)
 {
+    if (j)
+    {
+        slb_Json_DropTape(j);
+    }
     delete j;
 }
 
@@ -39,7 +391,7 @@ void slb_Json_SaveBool(slb_Json j, const char* name, const bool val)
 {
     if (j)
     {
-        j->json[name] = val;
+        slb_Json_EditTree(j)[name] = val;
     }
 }
 
@@ -47,7 +399,7 @@ void slb_Json_SaveString(slb_Json j, const char* name, const char* val)
 {
     if (j && val)
     {
-        j->json[name] = std::string(val);
+        slb_Json_EditTree(j)[name] = std::string(val);
     }
 }
 
@@ -55,7 +407,7 @@ void slb_Json_SaveInt(slb_Json j, const char* name, const int val)
 {
     if (j)
     {
-        j->json[name] = val;
+        slb_Json_EditTree(j)[name] = val;
     }
 }
 
@@ -63,7 +415,7 @@ void slb_Json_SaveFloat(slb_Json j, const char* name, const float val)
 {
     if (j)
     {
-        j->json[name] = val;
+        slb_Json_EditTree(j)[name] = val;
     }
 }
 
@@ -71,8 +423,8 @@ void slb_Json_SaveDouble(slb_Json j, const char* name, const double val)
 {
     if (j)
     {
-        j->json = val;
-        j->json[name] = val;
+        slb_Json_EditTree(j) = val;
+        slb_Json_EditTree(j)[name] = val;
     }
 }
 
@@ -80,7 +432,7 @@ void slb_Json_SaveFloat2(slb_Json j, const char* name, const vec2 val)
 {
     if (j)
     {
-        j->json[name] = {val[0], val[1]};
+        slb_Json_EditTree(j)[name] = {val[0], val[1]};
     }
 }
 
@@ -88,7 +440,7 @@ void slb_Json_SaveFloat3(slb_Json j, const char* name, const vec3 val)
 {
     if (j)
     {
-        j->json[name] = {val[0], val[1], val[2]};
+        slb_Json_EditTree(j)[name] = {val[0], val[1], val[2]};
     }
 }
 
@@ -96,7 +448,7 @@ void slb_Json_SaveFloat4(slb_Json j, const char* name, const vec4 val)
 {
     if (j)
     {
-        j->json[name] = {val[0], val[1], val[2], val[3]};
+        slb_Json_EditTree(j)[name] = {val[0], val[1], val[2], val[3]};
     }
 }
 
@@ -105,7 +457,7 @@ void slb_Json_SaveMat4(slb_Json j, const char* name, const mat4 val)
     if (j)
     {
         nlohmann::json matrix;
-        j->json[name] = {val[0],  val[1],  val[2],  val[3],
+        slb_Json_EditTree(j)[name] = {val[0],  val[1],  val[2],  val[3],
                          val[4],  val[5],  val[6],  val[7],
                          val[8],  val[9],  val[10], val[11],
                          val[12], val[13], val[14], val[15]};
@@ -116,13 +468,13 @@ void slb_Json_SaveFloatArray(slb_Json j, const char* name,
                            const float* val, size_t size)
 {
     std::vector<float> values(val, val + size);
-    j->json[name] = values;
+    slb_Json_EditTree(j)[name] = values;
 }
 
 size_t slb_Json_LoadFloatArray(slb_Json j, const char* name, float* val)
 {
     int index = 0;
-    for (const auto& point : j->json[name])
+    for (const auto& point : slb_Json_Tree(j)[name])
     {
         val[index] = point;
         index++;
@@ -133,95 +485,111 @@ size_t slb_Json_LoadFloatArray(slb_Json j, const char* name, float* val)
 
 void slb_Json_LoadBool(slb_Json j, const char* key, bool* val)
 {
-    if (j && key && val && j->json.contains(key))
+    if (j && key && val && slb_Json_Tree(j).contains(key))
     {
-        *val = j->json[key].get<bool>();
+        *val = slb_Json_Tree(j)[key].get<bool>();
     }
 }
 
 void slb_Json_LoadString(slb_Json j, const char* key, char* val)
 {
-    if (j && key && val && j->json.contains(key))
+    if (j && key && val)
+    {
+        auto it = slb_Json_Tree(j).find(key);
+        if (it != slb_Json_Tree(j).end() && it->is_string())
+        {
+            const std::string& str = it->get_ref<const std::string&>();
+            memcpy(val, str.c_str(), str.size() + 1);
+        }
+    }
+}
+
+// Length of the string at [key] without the terminator, so callers
+// can size the buffer they pass to slb_Json_LoadString
+size_t slb_Json_GetStringLength(slb_Json j, const char* key)
+{
+    if (j && key && slb_Json_Tree(j).contains(key) &&
+        slb_Json_Tree(j)[key].is_string())
     {
-        std::string str = j->json[key].get<std::string>();
-        strcpy(val, str.c_str());
+        return slb_Json_Tree(j)[key].get_ref<const std::string&>().size();
     }
+    return 0;
 }
 
 void slb_Json_LoadInt(slb_Json j, const char* key, int* val)
 {
-    if (j && key && val && j->json.contains(key))
+    if (j && key && val && slb_Json_Tree(j).contains(key))
     {
-        *val = j->json[key].get<int>();
+        *val = slb_Json_Tree(j)[key].get<int>();
     }
 }
 
 void slb_Json_LoadFloat(slb_Json j, const char* key, float* val)
 {
-    if (j && key && val && j->json.contains(key))
+    if (j && key && val && slb_Json_Tree(j).contains(key))
     {
-        *val = j->json[key].get<float>();
+        *val = slb_Json_Tree(j)[key].get<float>();
     }
 }
 
 void slb_Json_LoadDouble(slb_Json j, const char* key, double* val)
 {
-    if (j && key && val && j->json.contains(key))
+    if (j && key && val && slb_Json_Tree(j).contains(key))
     {
-        *val = j->json[key].get<double>();
+        *val = slb_Json_Tree(j)[key].get<double>();
     }
 }
 
 void slb_Json_LoadFloat2(slb_Json j, const char* key, vec2 val)
 {
-    if (j && key && val && j->json.contains(key))
+    if (j && key && val && slb_Json_Tree(j).contains(key))
     {
-        val[0] = j->json[key][0];
-        val[1] = j->json[key][1];
+        val[0] = slb_Json_Tree(j)[key][0];
+        val[1] = slb_Json_Tree(j)[key][1];
     }
 }
 
 void slb_Json_LoadFloat3(slb_Json j, const char* key, vec3 val)
 {
-    if (j && key && val && j->json.contains(key))
+    if (j && key && val && slb_Json_Tree(j).contains(key))
     {
-        val[0] = j->json[key][0];
-        val[1] = j->json[key][1];
-        val[2] = j->json[key][2];
+        val[0] = slb_Json_Tree(j)[key][0];
+        val[1] = slb_Json_Tree(j)[key][1];
+        val[2] = slb_Json_Tree(j)[key][2];
     }
 }
 
 void slb_Json_LoadFloat4(slb_Json j, const char* key, vec4 val)
 {
-    if (j && key && val && j->json.contains(key))
+    if (j && key && val && slb_Json_Tree(j).contains(key))
     {
-        val[0] = j->json[key][0];
-        val[1] = j->json[key][1];
-        val[2] = j->json[key][2];
-        val[3] = j->json[key][3];
+        val[0] = slb_Json_Tree(j)[key][0];
+        val[1] = slb_Json_Tree(j)[key][1];
+        val[2] = slb_Json_Tree(j)[key][2];
+        val[3] = slb_Json_Tree(j)[key][3];
     }
 }
 
 void slb_Json_LoadFloat16(slb_Json j, const char* key, mat4 val)
 {
-    if (j && key && val && j->json.contains(key))
+    if (j && key && val && slb_Json_Tree(j).contains(key))
     {
-        val[0][0] = j->json[key][0];
-        val[0][1] = j->json[key][1];
-        val[0][2] = j->json[key][2];
-        val[0][3] = j->json[key][3];
-        val[1][0] = j->json[key][5];
-        val[1][1] = j->json[key][4];
-        val[1][2] = j->json[key][5];
-        val[1][3] = j->json[key][6];
-        val[2][0] = j->json[key][7];
-        val[2][1] = j->json[key][8];
-        val[2][2] = j->json[key][9];
-        val[2][3] = j->json[key][10];
-        val[3][0] = j->json[key][11];
-        val[3][1] = j->json[key][12];
-        val[3][2] = j->json[key][13];
-        val[3][3] = j->json[key][14];
+        val[0][0] = slb_Json_Tree(j)[key][0];
+        val[0][1] = slb_Json_Tree(j)[key][1];
+        val[0][2] = slb_Json_Tree(j)[key][2];
+        val[0][3] = slb_Json_Tree(j)[key][3];
+        val[1][0] = slb_Json_Tree(j)[key][5];
+        val[1][1] = slb_Json_Tree(j)[key][4];
+        val[1][2] = slb_Json_Tree(j)[key][5];
+        val[1][3] = slb_Json_Tree(j)[key][6];
+        val[2][0] = slb_Json_Tree(j)[key][7];
+        val[2][1] = slb_Json_Tree(j)[key][8];
+        val[2][2] = slb_Json_Tree(j)[key][9];
+        val[2][3] = slb_Json_Tree(j)[key][10];
+        val[3][0] = slb_Json_Tree(j)[key][11];
+        val[3][1] = slb_Json_Tree(j)[key][12];
+        val[3][2] = slb_Json_Tree(j)[key][13];
+        val[3][3] = slb_Json_Tree(j)[key][14];
     }
 }
 
@@ -229,35 +597,38 @@ void slb_Json_PushBack(slb_Json j, const slb_Json val)
 {
     if (j)
     {
-        j->json.push_back(val->json);
+        slb_Json_EditTree(j).push_back(slb_Json_Tree(val));
     }
 }
 
 void slb_Json_Iterate(slb_Json j, slb_JsonIteratorFunc sys)
 {
-    for (nlohmann::json& childJ : j->json)
+    // Each child is swapped into a handle on the stack for the call
+    // and swapped back after, which moves it instead of copying it
+    slb_Json_t child = {};
+    for (nlohmann::json& childJ : slb_Json_EditTree(j))
     {
-        slb_Json childJJ = {};
-        childJJ->json = childJ;
-        sys(childJJ);
+        child.json.swap(childJ);
+        sys(&child);
+        child.json.swap(childJ);
     }
 }
 
 slb_Json slb_Json_GetArrayElement(slb_Json j, int index)
 {
     slb_Json json = slb_Json_Create();
-    json->json = j->json[index];
+    json->json = slb_Json_Tree(j)[index];
     return json;
 }
 
 int slb_Json_GetArraySize(slb_Json j)
 {
-    return j->json.size();
+    return slb_Json_Tree(j).size();
 }
 
 bool slb_Json_HasKey(slb_Json j, const char* key)
 {
-    return j->json.contains(key);
+    return slb_Json_Tree(j).contains(key);
 }
 
 bool slb_Json_SaveToFile(slb_Json j, const char* filename)
@@ -275,7 +646,7 @@ bool slb_Json_SaveToFile(slb_Json j, const char* filename)
             return false;
         }
 
-        file << j->json.dump(4); // dump with 4-space indentation
+        file << slb_Json_Tree(j).dump(4); // dump with 4-space indentation
         file.close();
         return true;
     }
@@ -292,6 +663,19 @@ slb_Json slb_Json_LoadFromFile(const char* filename)
         return nullptr;
     }
 
+    if (jsonBackend == slb_JsonBackend_Tape)
+    {
+        slb_JsonTape tape;
+        if (!slb_JsonTape_ParseFile(&tape, filename))
+        {
+            return nullptr;
+        }
+
+        slb_Json j = slb_Json_Create();
+        j->tape = tape;
+        return j;
+    }
+
     try
     {
         std::ifstream file(filename);
@@ -318,15 +702,391 @@ slb_Json slb_Json_LoadFromFile(const char* filename)
     }
 }
 
+bool slb_Json_ParseFile(const char* filename, slb_JsonEventFunc func,
+                        void* userData)
+{
+    if (filename == nullptr || func == nullptr)
+    {
+        return false;
+    }
+
+    try
+    {
+        std::ifstream file(filename, std::ios::binary);
+        if (!file.is_open())
+        {
+            return false;
+        }
+
+        slb_JsonEventHandler handler = {func, userData};
+        return nlohmann::json::sax_parse(file, &handler);
+    }
+    catch (...)
+    {
+        return false;
+    }
+}
+
+slb_JsonView slb_Json_GetView(slb_Json j)
+{
+    if (j == nullptr)
+    {
+        return nullptr;
+    }
+
+    if (j->tape.words != nullptr)
+    {
+        return slb_JsonView_MakeTape(j->tape.words);
+    }
+
+    return slb_JsonView_Make(j->json);
+}
+
+slb_JsonView slb_JsonView_Get(slb_JsonView view, const char* key)
+{
+    if (view == nullptr || key == nullptr)
+    {
+        return nullptr;
+    }
+
+    if (slb_JsonView_IsTape(view))
+    {
+        const uint64_t* word = slb_JsonView_Word(view);
+        if (slb_JsonTape_Type(word) != slb_JsonTapeType_Object)
+        {
+            return nullptr;
+        }
+
+        // The last of a repeated key wins, as in the tree
+        size_t          keyLength = strlen(key);
+        const uint64_t* found = nullptr;
+        const uint64_t* end = slb_JsonTape_Skip(word);
+
+        for (const uint64_t* member = word + 1; member < end;
+             member = slb_JsonTape_Skip(member + 1))
+        {
+            size_t      length;
+            const char* name = slb_JsonTape_String(member, &length);
+
+            if (length == keyLength && memcmp(name, key, length) == 0)
+            {
+                found = member + 1;
+            }
+        }
+
+        return found != nullptr ? slb_JsonView_MakeTape(found) : nullptr;
+    }
+
+    const nlohmann::json* node = slb_JsonView_Node(view);
+
+    auto it = node->find(key);
+    return it != node->end() ? slb_JsonView_Make(*it) : nullptr;
+}
+
+slb_JsonView slb_JsonView_At(slb_JsonView view, size_t index)
+{
+    if (!slb_JsonView_IsArray(view))
+    {
+        return nullptr;
+    }
+
+    if (slb_JsonView_IsTape(view))
+    {
+        const uint64_t* array = slb_JsonView_Word(view);
+        const uint64_t* end = slb_JsonTape_Skip(array);
+        const uint64_t* element = array + 1;
+        size_t          current = 0;
+
+        if (tapeCursor.array == array && tapeCursor.index <= index)
+        {
+            element = tapeCursor.element;
+            current = tapeCursor.index;
+        }
+
+        for (; current < index && element < end; current++)
+        {
+            element = slb_JsonTape_Skip(element);
+        }
+
+        if (element >= end)
+        {
+            return nullptr;
+        }
+
+        tapeCursor = {array, index, element};
+        return slb_JsonView_MakeTape(element);
+    }
+
+    const nlohmann::json* node = slb_JsonView_Node(view);
+    if (index >= node->size())
+    {
+        return nullptr;
+    }
+
+    return slb_JsonView_Make((*node)[index]);
+}
+
+size_t slb_JsonView_Size(slb_JsonView view)
+{
+    if (view == nullptr)
+    {
+        return 0;
+    }
+
+    if (slb_JsonView_IsTape(view))
+    {
+        return slb_JsonTape_Count(slb_JsonView_Word(view));
+    }
+
+    const nlohmann::json* node = slb_JsonView_Node(view);
+    if (!node->is_structured())
+    {
+        return 0;
+    }
+
+    return node->size();
+}
+
+bool slb_JsonView_IsArray(slb_JsonView view)
+{
+    if (view == nullptr)
+    {
+        return false;
+    }
+
+    if (slb_JsonView_IsTape(view))
+    {
+        return slb_JsonTape_Type(slb_JsonView_Word(view)) ==
+               slb_JsonTapeType_Array;
+    }
+
+    return slb_JsonView_Node(view)->is_array();
+}
+
+bool slb_JsonView_IsObject(slb_JsonView view)
+{
+    if (view == nullptr)
+    {
+        return false;
+    }
+
+    if (slb_JsonView_IsTape(view))
+    {
+        return slb_JsonTape_Type(slb_JsonView_Word(view)) ==
+               slb_JsonTapeType_Object;
+    }
+
+    return slb_JsonView_Node(view)->is_object();
+}
+
+const char* slb_JsonView_String(slb_JsonView view, size_t* length)
+{
+    if (length != nullptr)
+    {
+        *length = 0;
+    }
+
+    if (view == nullptr)
+    {
+        return nullptr;
+    }
+
+    if (slb_JsonView_IsTape(view))
+    {
+        const uint64_t* word = slb_JsonView_Word(view);
+        if (slb_JsonTape_Type(word) != slb_JsonTapeType_String)
+        {
+            return nullptr;
+        }
+
+        return slb_JsonTape_String(word, length);
+    }
+
+    const nlohmann::json* node = slb_JsonView_Node(view);
+    if (!node->is_string())
+    {
+        return nullptr;
+    }
+
+    const std::string& str = node->get_ref<const std::string&>();
+    if (length != nullptr)
+    {
+        *length = str.size();
+    }
+
+    return str.c_str();
+}
+
+size_t slb_JsonView_CopyString(slb_JsonView view, char* buffer,
+                               size_t size)
+{
+    size_t      length;
+    const char* str = slb_JsonView_String(view, &length);
+
+    if (buffer != nullptr && size > 0)
+    {
+        size_t copied = length < size - 1 ? length : size - 1;
+        if (str != nullptr)
+        {
+            memcpy(buffer, str, copied);
+        }
+        buffer[copied] = '\0';
+    }
+
+    return length;
+}
+
+bool slb_JsonView_Bool(slb_JsonView view, bool fallback)
+{
+    if (view == nullptr)
+    {
+        return fallback;
+    }
+
+    if (slb_JsonView_IsTape(view))
+    {
+        switch (slb_JsonTape_Type(slb_JsonView_Word(view)))
+        {
+        case slb_JsonTapeType_True:
+            return true;
+        case slb_JsonTapeType_False:
+            return false;
+        default:
+            return fallback;
+        }
+    }
+
+    const nlohmann::json* node = slb_JsonView_Node(view);
+    if (!node->is_boolean())
+    {
+        return fallback;
+    }
+
+    return node->get<bool>();
+}
+
+int64_t slb_JsonView_Int(slb_JsonView view, int64_t fallback)
+{
+    int64_t val;
+    return slb_JsonView_Number(view, &val) ? val : fallback;
+}
+
+float slb_JsonView_Float(slb_JsonView view, float fallback)
+{
+    float val;
+    return slb_JsonView_Number(view, &val) ? val : fallback;
+}
+
+double slb_JsonView_Double(slb_JsonView view, double fallback)
+{
+    double val;
+    return slb_JsonView_Number(view, &val) ? val : fallback;
+}
+
+size_t slb_JsonView_ReadInts(slb_JsonView view, int* values,
+                             size_t capacity)
+{
+    return slb_JsonView_ReadNumbers(view, values, capacity);
+}
+
+size_t slb_JsonView_ReadFloats(slb_JsonView view, float* values,
+                               size_t capacity)
+{
+    return slb_JsonView_ReadNumbers(view, values, capacity);
+}
+
+size_t slb_JsonView_ReadDoubles(slb_JsonView view, double* values,
+                                size_t capacity)
+{
+    return slb_JsonView_ReadNumbers(view, values, capacity);
+}
+
+void slb_JsonView_Iterate(slb_JsonView view, slb_JsonViewFunc func,
+                          void* userData)
+{
+    if (view == nullptr || func == nullptr)
+    {
+        return;
+    }
+
+    if (slb_JsonView_IsTape(view))
+    {
+        const uint64_t* word = slb_JsonView_Word(view);
+        slb_JsonTapeType type = slb_JsonTape_Type(word);
+
+        if (type != slb_JsonTapeType_Object &&
+            type != slb_JsonTapeType_Array)
+        {
+            return;
+        }
+
+        const uint64_t* end = slb_JsonTape_Skip(word);
+
+        for (const uint64_t* element = word + 1; element < end;
+             element = slb_JsonTape_Skip(element))
+        {
+            const char* key = nullptr;
+            if (type == slb_JsonTapeType_Object)
+            {
+                key = slb_JsonTape_String(element, nullptr);
+                element++;
+            }
+
+            if (!func(key, slb_JsonView_MakeTape(element), userData))
+            {
+                return;
+            }
+        }
+
+        return;
+    }
+
+    const nlohmann::json* node = slb_JsonView_Node(view);
+
+    if (node->is_object())
+    {
+        for (auto it = node->begin(); it != node->end(); ++it)
+        {
+            // key() is a reference to the stored key, not a copy
+            if (!func(it.key().c_str(), slb_JsonView_Make(*it),
+                      userData))
+            {
+                return;
+            }
+        }
+    }
+    else if (node->is_array())
+    {
+        for (const nlohmann::json& element : *node)
+        {
+            if (!func(nullptr, slb_JsonView_Make(element), userData))
+            {
+                return;
+            }
+        }
+    }
+}
+
+void slb_Json_SetBackend(slb_JsonBackend backend)
+{
+    jsonBackend = backend;
+}
+
+slb_JsonBackend slb_Json_GetBackend()
+{
+    return jsonBackend;
+}
+
 }
 
 nlohmann::json slb_Json_Getslb_Json(slb_Json j)
 {
-    return j->json;
+    return slb_Json_Tree(j);
 }
 
 void slb_Json_Setslb_Json(slb_Json j, const nlohmann::json& json)
 {
+    slb_Json_DropTape(j);
     j->json = json;
 }
 
@@ -335,19 +1095,19 @@ void slb_Json_SaveIntArray(slb_Json j, const char* name, const int* val, size_t
     if (j && name && val && size > 0)
     {
         std::vector<int> values(val, val + size);
-        j->json[name] = values;
+        slb_Json_EditTree(j)[name] = values;
     }
 }
 
 size_t slb_Json_LoadIntArray(slb_Json j, const char* name, int* val)
 {
-    if (!j || !name || !val || !j->json.contains(name))
+    if (!j || !name || !val || !slb_Json_Tree(j).contains(name))
     {
         return 0;
     }
 
     size_t index = 0;
-    for (const auto& element : j->json[name])
+    for (const auto& element : slb_Json_Tree(j)[name])
     {
         val[index] = element.get<int>();
         index++;
@@ -359,9 +1119,10 @@ size_t slb_Json_LoadIntArray(slb_Json j, const char* name, int* val)
 // Get the size of an integer array in the JSON object
 size_t slb_Json_GetIntArraySize(slb_Json j, const char* name)
 {
-    if (j && name && j->json.contains(name) && j->json[name].is_array())
+    if (j && name && slb_Json_Tree(j).contains(name) &&
+        slb_Json_Tree(j)[name].is_array())
     {
-        return j->json[name].size();
+        return slb_Json_Tree(j)[name].size();
     }
     return 0;
 }
@@ -372,15 +1133,15 @@ void slb_Json_PushBackInt(slb_Json j, const char* name, int val)
     if (j && name)
     {
         // If the key doesn't exist, create an empty array
-        if (!j->json.contains(name))
+        if (!slb_Json_EditTree(j).contains(name))
         {
-            j->json[name] = nlohmann::json::array();
+            slb_Json_EditTree(j)[name] = nlohmann::json::array();
         }
         
         // Ensure it's an array before pushing
-        if (j->json[name].is_array())
+        if (slb_Json_EditTree(j)[name].is_array())
         {
-            j->json[name].push_back(val);
+            slb_Json_EditTree(j)[name].push_back(val);
         }
     }
 }
@@ -390,6 +1151,6 @@ void slb_Json_CreateIntArray(slb_Json j, const char* name)
 {
     if (j && name)
     {
-        j->json[name] = nlohmann::json::array();
+        slb_Json_EditTree(j)[name] = nlohmann::json::array();
     }
 }
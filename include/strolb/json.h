@@ -7,6 +7,7 @@ extern "C"
 
 #include <stddef.h>
 #include <stdbool.h>
+#include <stdint.h>
 #include <cglm/cglm.h>
 
 typedef struct slb_Json_t*        slb_Json;
@@ -34,6 +35,7 @@ void slb_Json_SaveFloatArray(slb_Json j, const char* name,
 size_t slb_Json_LoadFloatArray(slb_Json j, const char* name, float* val);
 void   slb_Json_LoadBool(slb_Json j, const char* key, bool* val);
 void   slb_Json_LoadString(slb_Json j, const char* key, char* val);
+size_t slb_Json_GetStringLength(slb_Json j, const char* key);
 void   slb_Json_LoadInt(slb_Json j, const char* key, int* val);
 void   slb_Json_LoadFloat(slb_Json j, const char* key, float* val);
 void   slb_Json_LoadDouble(slb_Json j, const char* key, double* val);
@@ -48,8 +50,11 @@ void slb_Json_PushBack(slb_Json j, const slb_Json val);
 
 typedef void (*slb_JsonIteratorFunc)(slb_Json j);
 
+// [j] passed to [sys] is only valid during the call
+
 void slb_Json_Iterate(slb_Json j, slb_JsonIteratorFunc sys);
 
+// Returns a deep copy that must be destroyed, see slb_JsonView_At
 slb_Json slb_Json_GetArrayElement(slb_Json j, int index);
 int    slb_Json_GetArraySize(slb_Json j);
 bool   slb_Json_HasKey(slb_Json j, const char* key);
@@ -57,6 +62,117 @@ bool   slb_Json_HasKey(slb_Json j, const char* key);
 bool   slb_Json_SaveToFile(slb_Json j, const char* filename);
 slb_Json slb_Json_LoadFromFile(const char* filename);
 
+typedef enum
+{
+    // strolb's own parser (strolb/jsontape.h), the default. The root
+    // holds a flat tape that views read in place, and the nlohmann
+    // tree is only built from it the first time another slb_Json
+    // function is called on the root.
+    slb_JsonBackend_Tape,
+    slb_JsonBackend_Nlohmann,
+} slb_JsonBackend;
+
+// Picks the parser slb_Json_LoadFromFile uses from now on
+void            slb_Json_SetBackend(slb_JsonBackend backend);
+slb_JsonBackend slb_Json_GetBackend();
+
+typedef enum
+{
+    slb_JsonEventType_BeginObject,
+    slb_JsonEventType_EndObject,
+    slb_JsonEventType_BeginArray,
+    slb_JsonEventType_EndArray,
+    slb_JsonEventType_Key,
+    slb_JsonEventType_String,
+    slb_JsonEventType_Number,
+    slb_JsonEventType_Bool,
+    slb_JsonEventType_Null,
+} slb_JsonEventType;
+
+// One token of a streaming parse
+typedef struct
+{
+    slb_JsonEventType type;
+    const char*       string; // Key, String, only valid in the callback
+    size_t            length;
+    double            number;    // Number
+    int64_t           integer;   // Number, when [isInteger]
+    bool              isInteger; // A whole number that fits int64_t
+    bool              boolean;   // Bool
+} slb_JsonEvent;
+
+// Return false to stop the parse
+typedef bool (*slb_JsonEventFunc)(const slb_JsonEvent* event,
+                                  void*                userData);
+
+// Reads [filename] token by token into [func] without building a
+// tree, so memory stays flat however big the file is. Returns false
+// if the file couldn't be read, isn't valid JSON, or [func] stopped
+// the parse.
+bool slb_Json_ParseFile(const char* filename, slb_JsonEventFunc func,
+                        void* userData);
+
+// A borrowed, read only view of one value inside a tree. It points
+// into its root and owns nothing, so getting one costs no allocation
+// or copy. Views stay valid until the root is destroyed or changed.
+// NULL stands for a missing value, and every slb_JsonView function
+// accepts it.
+typedef const struct slb_JsonNode_t* slb_JsonView;
+
+slb_JsonView slb_Json_GetView(slb_Json j);
+
+// NULL if [view] isn't an object or has no [key]. A tape has no index
+// of its keys, so this looks through every member.
+slb_JsonView slb_JsonView_Get(slb_JsonView view, const char* key);
+// NULL if [view] isn't an array or [index] is past its end. On a tape
+// this walks from the last element asked for, or from the start when
+// going backwards, so reading an array in order stays linear.
+slb_JsonView slb_JsonView_At(slb_JsonView view, size_t index);
+
+// Elements of an array or members of an object, 0 for anything else.
+// A tape counts a repeated key every time it appears.
+size_t slb_JsonView_Size(slb_JsonView view);
+bool   slb_JsonView_IsArray(slb_JsonView view);
+bool   slb_JsonView_IsObject(slb_JsonView view);
+
+// Points at the string inside the tree, NUL terminated. Returns NULL
+// if [view] isn't a string. [length] may be NULL.
+const char* slb_JsonView_String(slb_JsonView view, size_t* length);
+
+// Copies the string into [buffer] of [size] bytes, truncating and
+// always terminating like snprintf. Returns the full length without
+// the terminator, or 0 if [view] isn't a string.
+size_t slb_JsonView_CopyString(slb_JsonView view, char* buffer,
+                               size_t size);
+
+// Each returns [fallback] if [view] isn't of that type. Numbers
+// convert between integer and floating point.
+bool    slb_JsonView_Bool(slb_JsonView view, bool fallback);
+int64_t slb_JsonView_Int(slb_JsonView view, int64_t fallback);
+float   slb_JsonView_Float(slb_JsonView view, float fallback);
+double  slb_JsonView_Double(slb_JsonView view, double fallback);
+
+// Reads up to [capacity] elements of a number array into [values] in
+// one call. Elements that aren't numbers read as 0. Returns the
+// array's size, which may be more than [capacity], or 0 if [view]
+// isn't an array.
+size_t slb_JsonView_ReadInts(slb_JsonView view, int* values,
+                             size_t capacity);
+size_t slb_JsonView_ReadFloats(slb_JsonView view, float* values,
+                               size_t capacity);
+size_t slb_JsonView_ReadDoubles(slb_JsonView view, double* values,
+                                size_t capacity);
+
+// [key] is NULL for array elements. Return false to stop.
+typedef bool (*slb_JsonViewFunc)(const char* key, slb_JsonView value,
+                                 void* userData);
+
+// Calls [func] on every element of an array or member of an object.
+// Members come in key order from the nlohmann backend and in the
+// order they were written from the tape.
+void slb_JsonView_Iterate(slb_JsonView view, slb_JsonViewFunc func,
+                          void* userData);
+
 void slb_Json_SaveIntArray(slb_Json j, const char* name, 
         const int* val, size_t size);
 size_t slb_Json_LoadIntArray(slb_Json j, const char* name, int* val);
@@ -0,0 +1,1393 @@
+#include <strolb/jsontape.h>
+#include <errno.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || \
+    defined(__i386__)
+#    define SLB_JSON_TAPE_X86
+#    include <immintrin.h>
+#    ifdef _MSC_VER
+#        include <intrin.h>
+#    endif
+#endif
+
+// MSVC allows any intrinsic anywhere, GCC and Clang only in functions
+// built for the instruction set
+#if defined(SLB_JSON_TAPE_X86) && defined(__GNUC__)
+#    define SLB_TARGET_SSE2 __attribute__((target("sse2")))
+#    define SLB_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#    define SLB_TARGET_SSE2
+#    define SLB_TARGET_AVX2
+#endif
+
+#define SLB_JSON_TAPE_WORD(type, payload) \
+    (((uint64_t)(type) << 56) | (uint64_t)(payload))
+
+#define SLB_JSON_TAPE_PAYLOAD_MASK 0x00FFFFFFFFFFFFFFull
+#define SLB_JSON_TAPE_COUNT_LIMIT  0xFFFFFF
+
+enum
+{
+    slb_JsonTapeClass_Backslash = 1,
+    slb_JsonTapeClass_Quote = 2,
+    slb_JsonTapeClass_Whitespace = 4,
+    slb_JsonTapeClass_Operator = 8,
+};
+
+static const uint8_t characterClasses[256] = {
+    ['\\'] = slb_JsonTapeClass_Backslash,
+    ['"'] = slb_JsonTapeClass_Quote,
+    [' '] = slb_JsonTapeClass_Whitespace,
+    ['\t'] = slb_JsonTapeClass_Whitespace,
+    ['\n'] = slb_JsonTapeClass_Whitespace,
+    ['\r'] = slb_JsonTapeClass_Whitespace,
+    ['{'] = slb_JsonTapeClass_Operator,
+    ['}'] = slb_JsonTapeClass_Operator,
+    ['['] = slb_JsonTapeClass_Operator,
+    [']'] = slb_JsonTapeClass_Operator,
+    [':'] = slb_JsonTapeClass_Operator,
+    [','] = slb_JsonTapeClass_Operator,
+};
+
+// Powers of ten a double holds exactly
+static const double exactPowersOf10[] = {
+    1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,
+    1e8,  1e9,  1e10, 1e11, 1e12, 1e13, 1e14, 1e15,
+    1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22,
+};
+
+static int tapeKernel = -1; // Not picked yet
+
+// Bit i of each mask is set when byte i of a 64 byte block is one
+typedef struct
+{
+    uint64_t backslash;
+    uint64_t quote;
+    uint64_t whitespace;
+    uint64_t op; // One of {}[]:,
+} slb_JsonTapeBlock;
+
+typedef void (*slb_JsonTapeClassifyFunc)(const uint8_t*     in,
+                                         slb_JsonTapeBlock* block);
+
+// An object or array still being parsed
+typedef struct
+{
+    uint32_t word; // Where its word goes once it is closed
+    uint32_t count;
+    bool     isObject;
+} slb_JsonTapeFrame;
+
+typedef enum
+{
+    slb_JsonTapeState_Value,
+    slb_JsonTapeState_Key,
+    slb_JsonTapeState_After, // A value just ended
+    slb_JsonTapeState_Close,
+} slb_JsonTapeState;
+
+typedef struct
+{
+    const uint8_t* json;
+    size_t         length;
+    bool           simd; // Scan strings 16 bytes at a time
+    uint64_t*      words;
+    size_t         wordCount;
+    size_t         wordCapacity;
+    uint8_t*       strings;
+    size_t         stringSize;
+    size_t         stringCapacity;
+} slb_JsonTapeBuilder;
+
+static int slb_JsonTape_Ctz(uint64_t bits)
+{
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_ARM64))
+    unsigned long index;
+    _BitScanForward64(&index, bits);
+    return (int)index;
+#elif defined(_MSC_VER)
+    unsigned long index;
+    if (_BitScanForward(&index, (unsigned long)bits))
+    {
+        return (int)index;
+    }
+    _BitScanForward(&index, (unsigned long)(bits >> 32));
+    return (int)index + 32;
+#else
+    return __builtin_ctzll(bits);
+#endif
+}
+
+static void slb_JsonTape_ClassifyScalar(const uint8_t*     in,
+                                        slb_JsonTapeBlock* block)
+{
+    *block = (slb_JsonTapeBlock) {0};
+
+    for (int i = 0; i < 64; i++)
+    {
+        uint64_t c = characterClasses[in[i]];
+
+        block->backslash |= (c & 1) << i;
+        block->quote |= ((c >> 1) & 1) << i;
+        block->whitespace |= ((c >> 2) & 1) << i;
+        block->op |= ((c >> 3) & 1) << i;
+    }
+}
+
+#ifdef SLB_JSON_TAPE_X86
+
+SLB_TARGET_SSE2
+static void slb_JsonTape_ClassifySse2(const uint8_t*     in,
+                                      slb_JsonTapeBlock* block)
+{
+    const __m128i backslash = _mm_set1_epi8('\\');
+    const __m128i quote = _mm_set1_epi8('"');
+    const __m128i space = _mm_set1_epi8(' ');
+    const __m128i tab = _mm_set1_epi8('\t');
+    const __m128i newline = _mm_set1_epi8('\n');
+    const __m128i carriageReturn = _mm_set1_epi8('\r');
+    const __m128i caseBit = _mm_set1_epi8(0x20);
+    const __m128i openBrace = _mm_set1_epi8('{');
+    const __m128i closeBrace = _mm_set1_epi8('}');
+    const __m128i colon = _mm_set1_epi8(':');
+    const __m128i comma = _mm_set1_epi8(',');
+
+    *block = (slb_JsonTapeBlock) {0};
+
+    for (int i = 0; i < 4; i++)
+    {
+        __m128i chunk = _mm_loadu_si128((const __m128i*)(in + i * 16));
+
+        // [ and ] are { and } without the 0x20 bit
+        __m128i folded = _mm_or_si128(chunk, caseBit);
+
+        __m128i whitespace = _mm_or_si128(
+            _mm_or_si128(_mm_cmpeq_epi8(chunk, space),
+                         _mm_cmpeq_epi8(chunk, tab)),
+            _mm_or_si128(_mm_cmpeq_epi8(chunk, newline),
+                         _mm_cmpeq_epi8(chunk, carriageReturn)));
+        __m128i op = _mm_or_si128(
+            _mm_or_si128(_mm_cmpeq_epi8(folded, openBrace),
+                         _mm_cmpeq_epi8(folded, closeBrace)),
+            _mm_or_si128(_mm_cmpeq_epi8(chunk, colon),
+                         _mm_cmpeq_epi8(chunk, comma)));
+
+        int shift = i * 16;
+        block->backslash |=
+            (uint64_t)(uint16_t)_mm_movemask_epi8(
+                _mm_cmpeq_epi8(chunk, backslash))
+            << shift;
+        block->quote |= (uint64_t)(uint16_t)_mm_movemask_epi8(
+                            _mm_cmpeq_epi8(chunk, quote))
+                        << shift;
+        block->whitespace |=
+            (uint64_t)(uint16_t)_mm_movemask_epi8(whitespace) << shift;
+        block->op |= (uint64_t)(uint16_t)_mm_movemask_epi8(op) << shift;
+    }
+}
+
+SLB_TARGET_AVX2
+static void slb_JsonTape_ClassifyAvx2(const uint8_t*     in,
+                                      slb_JsonTapeBlock* block)
+{
+    const __m256i backslash = _mm256_set1_epi8('\\');
+    const __m256i quote = _mm256_set1_epi8('"');
+    const __m256i space = _mm256_set1_epi8(' ');
+    const __m256i tab = _mm256_set1_epi8('\t');
+    const __m256i newline = _mm256_set1_epi8('\n');
+    const __m256i carriageReturn = _mm256_set1_epi8('\r');
+    const __m256i caseBit = _mm256_set1_epi8(0x20);
+    const __m256i openBrace = _mm256_set1_epi8('{');
+    const __m256i closeBrace = _mm256_set1_epi8('}');
+    const __m256i colon = _mm256_set1_epi8(':');
+    const __m256i comma = _mm256_set1_epi8(',');
+
+    *block = (slb_JsonTapeBlock) {0};
+
+    for (int i = 0; i < 2; i++)
+    {
+        __m256i chunk =
+            _mm256_loadu_si256((const __m256i*)(in + i * 32));
+        __m256i folded = _mm256_or_si256(chunk, caseBit);
+
+        __m256i whitespace = _mm256_or_si256(
+            _mm256_or_si256(_mm256_cmpeq_epi8(chunk, space),
+                            _mm256_cmpeq_epi8(chunk, tab)),
+            _mm256_or_si256(_mm256_cmpeq_epi8(chunk, newline),
+                            _mm256_cmpeq_epi8(chunk, carriageReturn)));
+        __m256i op = _mm256_or_si256(
+            _mm256_or_si256(_mm256_cmpeq_epi8(folded, openBrace),
+                            _mm256_cmpeq_epi8(folded, closeBrace)),
+            _mm256_or_si256(_mm256_cmpeq_epi8(chunk, colon),
+                            _mm256_cmpeq_epi8(chunk, comma)));
+
+        int shift = i * 32;
+        block->backslash |=
+            (uint64_t)(uint32_t)_mm256_movemask_epi8(
+                _mm256_cmpeq_epi8(chunk, backslash))
+            << shift;
+        block->quote |= (uint64_t)(uint32_t)_mm256_movemask_epi8(
+                            _mm256_cmpeq_epi8(chunk, quote))
+                        << shift;
+        block->whitespace |=
+            (uint64_t)(uint32_t)_mm256_movemask_epi8(whitespace)
+            << shift;
+        block->op |= (uint64_t)(uint32_t)_mm256_movemask_epi8(op)
+                     << shift;
+    }
+}
+
+// Copies 16 bytes at a time from [src] to [dst], up to the first byte
+// that needs a closer look: a quote, a backslash, a control character
+// or part of a multibyte sequence. Returns how many bytes come before
+// it. Can write up to 15 bytes past that point.
+SLB_TARGET_SSE2
+static size_t slb_JsonTape_CopyPlainSse2(const uint8_t* src,
+                                         uint8_t*       dst)
+{
+    const __m128i quote = _mm_set1_epi8('"');
+    const __m128i backslash = _mm_set1_epi8('\\');
+    const __m128i control = _mm_set1_epi8(0x1F);
+
+    size_t copied = 0;
+
+    for (;;)
+    {
+        __m128i chunk =
+            _mm_loadu_si128((const __m128i*)(src + copied));
+        _mm_storeu_si128((__m128i*)(dst + copied), chunk);
+
+        // Control characters are the bytes max leaves at 0x1F
+        __m128i special = _mm_or_si128(
+            _mm_or_si128(_mm_cmpeq_epi8(chunk, quote),
+                         _mm_cmpeq_epi8(chunk, backslash)),
+            _mm_cmpeq_epi8(_mm_max_epu8(chunk, control), control));
+
+        // The chunk's own sign bits flag bytes from 0x80 up
+        uint32_t mask = (uint32_t)_mm_movemask_epi8(
+            _mm_or_si128(special, chunk));
+        if (mask != 0)
+        {
+            return copied + slb_JsonTape_Ctz(mask);
+        }
+
+        copied += 16;
+    }
+}
+
+#endif
+
+// Marks the bytes escaped by a backslash. A run of backslashes escapes
+// the byte after it when its length is odd, so this finds where odd
+// runs end by adding each run's start to it and seeing whether the
+// carry lands on an odd or even bit. [prevEscaped] is 1 when the last
+// block ended in an odd run.
+static uint64_t slb_JsonTape_FindEscaped(uint64_t  backslash,
+                                         uint64_t* prevEscaped)
+{
+    const uint64_t evenBits = 0x5555555555555555ull;
+    const uint64_t oddBits = ~evenBits;
+
+    uint64_t starts = backslash & ~(backslash << 1);
+
+    // A run carried over from the last block counts as starting on
+    // the other parity
+    uint64_t evenStartMask = evenBits ^ *prevEscaped;
+    uint64_t evenStarts = starts & evenStartMask;
+    uint64_t oddStarts = starts & ~evenStartMask;
+
+    uint64_t evenCarries = backslash + evenStarts;
+    uint64_t oddCarries = backslash + oddStarts;
+    bool     endsOdd = oddCarries < backslash;
+
+    oddCarries |= *prevEscaped;
+    *prevEscaped = endsOdd;
+
+    uint64_t evenCarryEnds = evenCarries & ~backslash;
+    uint64_t oddCarryEnds = oddCarries & ~backslash;
+
+    return (evenCarryEnds & oddBits) | (oddCarryEnds & evenBits);
+}
+
+// Each bit becomes the XOR of itself and every bit below it, which
+// turns the quote bits into the ranges between them
+static uint64_t slb_JsonTape_PrefixXor(uint64_t bits)
+{
+    bits ^= bits << 1;
+    bits ^= bits << 2;
+    bits ^= bits << 4;
+    bits ^= bits << 8;
+    bits ^= bits << 16;
+    bits ^= bits << 32;
+
+    return bits;
+}
+
+// Finds where every token of [json] starts, 64 bytes at a time: the
+// braces, brackets, colons and commas outside strings, the opening
+// quote of each string and the first byte of every other value.
+// Returns false if a string is never closed.
+static bool slb_JsonTape_Index(const uint8_t* json, size_t length,
+                               slb_JsonTapeClassifyFunc classify,
+                               uint32_t** indices, size_t* indexCount)
+{
+    size_t    capacity = length / 8 + 64;
+    uint32_t* out = malloc(capacity * sizeof(uint32_t));
+    size_t    count = 0;
+
+    uint64_t prevEscaped = 0;
+    uint64_t prevInString = 0; // All ones when a string carries over
+    uint64_t prevScalar = 0;   // So does a number or literal
+
+    uint8_t tail[64];
+
+    for (size_t offset = 0; offset < length; offset += 64)
+    {
+        const uint8_t* in = json + offset;
+
+        // The last block is filled out with whitespace
+        if (length - offset < 64)
+        {
+            memset(tail, ' ', sizeof(tail));
+            memcpy(tail, in, length - offset);
+            in = tail;
+        }
+
+        slb_JsonTapeBlock block;
+        classify(in, &block);
+
+        uint64_t escaped =
+            slb_JsonTape_FindEscaped(block.backslash, &prevEscaped);
+        uint64_t quote = block.quote & ~escaped;
+
+        // Set from each opening quote up to its closing one
+        uint64_t inString = slb_JsonTape_PrefixXor(quote) ^ prevInString;
+        prevInString = 0 - (inString >> 63);
+
+        uint64_t scalar = ~(block.op | block.whitespace | quote);
+        uint64_t scalarStarts = scalar & ~((scalar << 1) | prevScalar);
+        prevScalar = scalar >> 63;
+
+        uint64_t structural =
+            ((block.op | scalarStarts) & ~inString) | (quote & inString);
+
+        if (count + 64 > capacity)
+        {
+            capacity *= 2;
+            out = realloc(out, capacity * sizeof(uint32_t));
+        }
+
+        while (structural != 0)
+        {
+            out[count++] =
+                (uint32_t)(offset + slb_JsonTape_Ctz(structural));
+            structural &= structural - 1;
+        }
+    }
+
+    if (prevInString != 0)
+    {
+        free(out);
+        return false;
+    }
+
+    *indices = out;
+    *indexCount = count;
+
+    return true;
+}
+
+static void slb_JsonTape_PushWord(slb_JsonTapeBuilder* builder,
+                                  uint64_t             word)
+{
+    if (builder->wordCount == builder->wordCapacity)
+    {
+        builder->wordCapacity *= 2;
+        builder->words = realloc(builder->words, builder->wordCapacity *
+                                                     sizeof(uint64_t));
+    }
+
+    builder->words[builder->wordCount++] = word;
+}
+
+static void slb_JsonTape_PushInt(slb_JsonTapeBuilder* builder,
+                                 int64_t              val)
+{
+    uint64_t bits;
+    memcpy(&bits, &val, sizeof(bits));
+
+    slb_JsonTape_PushWord(builder,
+                          SLB_JSON_TAPE_WORD(slb_JsonTapeType_Int, 0));
+    slb_JsonTape_PushWord(builder, bits);
+}
+
+static void slb_JsonTape_PushUnsigned(slb_JsonTapeBuilder* builder,
+                                      uint64_t             val)
+{
+    slb_JsonTape_PushWord(
+        builder, SLB_JSON_TAPE_WORD(slb_JsonTapeType_Unsigned, 0));
+    slb_JsonTape_PushWord(builder, val);
+}
+
+static void slb_JsonTape_PushDouble(slb_JsonTapeBuilder* builder,
+                                    double               val)
+{
+    uint64_t bits;
+    memcpy(&bits, &val, sizeof(bits));
+
+    slb_JsonTape_PushWord(
+        builder, SLB_JSON_TAPE_WORD(slb_JsonTapeType_Double, 0));
+    slb_JsonTape_PushWord(builder, bits);
+}
+
+// Whether a number or literal may end before [c]
+static bool slb_JsonTape_IsTerminator(uint8_t c)
+{
+    return (characterClasses[c] &
+            (slb_JsonTapeClass_Whitespace | slb_JsonTapeClass_Operator |
+             slb_JsonTapeClass_Quote)) != 0;
+}
+
+static bool slb_JsonTape_IsDigit(uint8_t c)
+{
+    return c >= '0' && c <= '9';
+}
+
+static int32_t slb_JsonTape_ReadHex4(const uint8_t* in)
+{
+    int32_t value = 0;
+
+    for (int i = 0; i < 4; i++)
+    {
+        uint8_t lower = in[i] | 0x20;
+        int32_t digit;
+
+        if (slb_JsonTape_IsDigit(in[i]))
+        {
+            digit = in[i] - '0';
+        }
+        else if (lower >= 'a' && lower <= 'f')
+        {
+            digit = lower - 'a' + 10;
+        }
+        else
+        {
+            return -1;
+        }
+
+        value = value * 16 + digit;
+    }
+
+    return value;
+}
+
+static uint8_t* slb_JsonTape_EncodeUtf8(uint8_t* out, uint32_t code)
+{
+    if (code < 0x80)
+    {
+        *out++ = (uint8_t)code;
+    }
+    else if (code < 0x800)
+    {
+        *out++ = (uint8_t)(0xC0 | (code >> 6));
+        *out++ = (uint8_t)(0x80 | (code & 0x3F));
+    }
+    else if (code < 0x10000)
+    {
+        *out++ = (uint8_t)(0xE0 | (code >> 12));
+        *out++ = (uint8_t)(0x80 | ((code >> 6) & 0x3F));
+        *out++ = (uint8_t)(0x80 | (code & 0x3F));
+    }
+    else
+    {
+        *out++ = (uint8_t)(0xF0 | (code >> 18));
+        *out++ = (uint8_t)(0x80 | ((code >> 12) & 0x3F));
+        *out++ = (uint8_t)(0x80 | ((code >> 6) & 0x3F));
+        *out++ = (uint8_t)(0x80 | (code & 0x3F));
+    }
+
+    return out;
+}
+
+// Length of the UTF-8 sequence at [in], or 0 if it isn't a valid one.
+// Overlong forms, surrogates and anything past U+10FFFF are refused.
+static size_t slb_JsonTape_Utf8Length(const uint8_t* in)
+{
+    uint8_t lead = in[0];
+    uint8_t low = 0x80; // Range of the second byte
+    uint8_t high = 0xBF;
+    size_t  length;
+
+    if (lead >= 0xC2 && lead <= 0xDF)
+    {
+        length = 2;
+    }
+    else if (lead >= 0xE0 && lead <= 0xEF)
+    {
+        length = 3;
+        low = lead == 0xE0 ? 0xA0 : low;
+        high = lead == 0xED ? 0x9F : high;
+    }
+    else if (lead >= 0xF0 && lead <= 0xF4)
+    {
+        length = 4;
+        low = lead == 0xF0 ? 0x90 : low;
+        high = lead == 0xF4 ? 0x8F : high;
+    }
+    else
+    {
+        return 0;
+    }
+
+    if (in[1] < low || in[1] > high)
+    {
+        return 0;
+    }
+
+    for (size_t i = 2; i < length; i++)
+    {
+        if ((in[i] & 0xC0) != 0x80)
+        {
+            return 0;
+        }
+    }
+
+    return length;
+}
+
+// Decodes the escape sequence at [*src] into [*dst] and moves both
+// past it
+static bool slb_JsonTape_Unescape(const uint8_t** src, uint8_t** dst)
+{
+    const uint8_t* in = *src;
+    uint8_t*       out = *dst;
+
+    switch (in[1])
+    {
+    case '"':
+    case '\\':
+    case '/':
+        *out++ = in[1];
+        break;
+    case 'b':
+        *out++ = '\b';
+        break;
+    case 'f':
+        *out++ = '\f';
+        break;
+    case 'n':
+        *out++ = '\n';
+        break;
+    case 'r':
+        *out++ = '\r';
+        break;
+    case 't':
+        *out++ = '\t';
+        break;
+    case 'u':
+    {
+        int32_t code = slb_JsonTape_ReadHex4(in + 2);
+        if (code < 0 || (code >= 0xDC00 && code <= 0xDFFF))
+        {
+            return false;
+        }
+
+        // Above U+FFFF comes as a pair of surrogates
+        if (code >= 0xD800 && code <= 0xDBFF)
+        {
+            if (in[6] != '\\' || in[7] != 'u')
+            {
+                return false;
+            }
+
+            int32_t low = slb_JsonTape_ReadHex4(in + 8);
+            if (low < 0xDC00 || low > 0xDFFF)
+            {
+                return false;
+            }
+
+            code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+            in += 6;
+        }
+
+        out = slb_JsonTape_EncodeUtf8(out, (uint32_t)code);
+        in += 4;
+        break;
+    }
+    default:
+        return false;
+    }
+
+    *src = in + 2;
+    *dst = out;
+
+    return true;
+}
+
+// Parses the string opening at [pos], which spans at most [span]
+// bytes of the input
+static bool slb_JsonTape_ParseString(slb_JsonTapeBuilder* builder,
+                                     size_t pos, size_t span)
+{
+    // Decoding never makes a string longer. Leave room for the length,
+    // the terminator and the last 16 byte copy running over.
+    size_t needed = builder->stringSize + sizeof(uint32_t) + span + 17;
+    if (needed > builder->stringCapacity)
+    {
+        while (needed > builder->stringCapacity)
+        {
+            builder->stringCapacity *= 2;
+        }
+        builder->strings =
+            realloc(builder->strings, builder->stringCapacity);
+    }
+
+    uint8_t*       start = builder->strings + builder->stringSize;
+    uint8_t*       dst = start + sizeof(uint32_t);
+    const uint8_t* src = builder->json + pos + 1;
+
+    for (;;)
+    {
+#ifdef SLB_JSON_TAPE_X86
+        if (builder->simd)
+        {
+            size_t plain = slb_JsonTape_CopyPlainSse2(src, dst);
+            src += plain;
+            dst += plain;
+        }
+#endif
+
+        uint8_t c = *src;
+
+        if (c == '"')
+        {
+            break;
+        }
+        else if (c == '\\')
+        {
+            if (!slb_JsonTape_Unescape(&src, &dst))
+            {
+                return false;
+            }
+        }
+        else if (c < 0x20)
+        {
+            return false;
+        }
+        else if (c < 0x80)
+        {
+            *dst++ = *src++;
+        }
+        else
+        {
+            size_t length = slb_JsonTape_Utf8Length(src);
+            if (length == 0)
+            {
+                return false;
+            }
+
+            memcpy(dst, src, length);
+            dst += length;
+            src += length;
+        }
+    }
+
+    uint32_t length = (uint32_t)(dst - start - sizeof(uint32_t));
+    memcpy(start, &length, sizeof(length));
+    *dst = '\0';
+
+    // Made relative to the word once the tape is finished
+    slb_JsonTape_PushWord(
+        builder, SLB_JSON_TAPE_WORD(slb_JsonTapeType_String,
+                                    builder->stringSize));
+    builder->stringSize += sizeof(uint32_t) + length + 1;
+
+    return true;
+}
+
+// Parses a number the fast paths can't do exactly. [text] is [length]
+// bytes long and not terminated. Returns false if it is too big for a
+// double, which nlohmann refuses as well.
+static bool slb_JsonTape_ParseLongNumber(slb_JsonTapeBuilder* builder,
+                                         const uint8_t* text,
+                                         size_t length, bool isInteger,
+                                         bool negative)
+{
+    char  local[64];
+    char* number = length < sizeof(local) ? local : malloc(length + 1);
+
+    memcpy(number, text, length);
+    number[length] = '\0';
+
+    bool parsed = false;
+
+    // Integers too big for 64 bits become doubles, like nlohmann does
+    if (isInteger)
+    {
+        errno = 0;
+        if (negative)
+        {
+            long long val = strtoll(number, NULL, 10);
+            if (errno == 0)
+            {
+                slb_JsonTape_PushInt(builder, val);
+                parsed = true;
+            }
+        }
+        else
+        {
+            unsigned long long val = strtoull(number, NULL, 10);
+            if (errno == 0 && val > INT64_MAX)
+            {
+                slb_JsonTape_PushUnsigned(builder, val);
+                parsed = true;
+            }
+            else if (errno == 0)
+            {
+                slb_JsonTape_PushInt(builder, (int64_t)val);
+                parsed = true;
+            }
+        }
+    }
+
+    if (!parsed)
+    {
+        double val = strtod(number, NULL);
+        parsed = isfinite(val);
+
+        if (parsed)
+        {
+            slb_JsonTape_PushDouble(builder, val);
+        }
+    }
+
+    if (number != local)
+    {
+        free(number);
+    }
+
+    return parsed;
+}
+
+static bool slb_JsonTape_ParseNumber(slb_JsonTapeBuilder* builder,
+                                     size_t               pos)
+{
+    const uint8_t* start = builder->json + pos;
+    const uint8_t* end = builder->json + builder->length;
+    const uint8_t* p = start;
+
+    bool negative = *p == '-';
+    if (negative)
+    {
+        p++;
+    }
+
+    if (p == end || !slb_JsonTape_IsDigit(*p))
+    {
+        return false;
+    }
+
+    // Up to 19 significant digits fit in [mantissa]
+    uint64_t mantissa = 0;
+    int      digits = 0;
+    int      exponent = 0;
+    bool     isInteger = true;
+
+    if (*p == '0')
+    {
+        p++;
+        if (p < end && slb_JsonTape_IsDigit(*p))
+        {
+            return false; // No leading zeros
+        }
+    }
+
+    // Leading zeros aren't significant. The count can't look at
+    // [mantissa] for that, since it wraps to 0 past 2^64.
+    while (p < end && slb_JsonTape_IsDigit(*p))
+    {
+        int digit = *p++ - '0';
+        mantissa = mantissa * 10 + digit;
+        digits += digits > 0 || digit != 0;
+    }
+
+    if (p < end && *p == '.')
+    {
+        isInteger = false;
+        p++;
+
+        if (p == end || !slb_JsonTape_IsDigit(*p))
+        {
+            return false;
+        }
+
+        while (p < end && slb_JsonTape_IsDigit(*p))
+        {
+            int digit = *p++ - '0';
+            mantissa = mantissa * 10 + digit;
+            digits += digits > 0 || digit != 0;
+            exponent--;
+        }
+    }
+
+    if (p < end && (*p | 0x20) == 'e')
+    {
+        isInteger = false;
+        p++;
+
+        bool negativeExponent = false;
+        if (p < end && (*p == '+' || *p == '-'))
+        {
+            negativeExponent = *p++ == '-';
+        }
+
+        if (p == end || !slb_JsonTape_IsDigit(*p))
+        {
+            return false;
+        }
+
+        int written = 0;
+        while (p < end && slb_JsonTape_IsDigit(*p))
+        {
+            // Anything this big is already infinity or zero
+            if (written < 100000)
+            {
+                written = written * 10 + (*p - '0');
+            }
+            p++;
+        }
+
+        exponent += negativeExponent ? -written : written;
+    }
+
+    if (p < end && !slb_JsonTape_IsTerminator(*p))
+    {
+        return false;
+    }
+
+    if (digits > 19)
+    {
+        return slb_JsonTape_ParseLongNumber(builder, start, p - start,
+                                            isInteger, negative);
+    }
+    else if (isInteger && !negative)
+    {
+        if (mantissa <= INT64_MAX)
+        {
+            slb_JsonTape_PushInt(builder, (int64_t)mantissa);
+        }
+        else
+        {
+            slb_JsonTape_PushUnsigned(builder, mantissa);
+        }
+    }
+    else if (isInteger)
+    {
+        if (mantissa <= (uint64_t)INT64_MAX)
+        {
+            slb_JsonTape_PushInt(builder, -(int64_t)mantissa);
+        }
+        else if (mantissa == (uint64_t)INT64_MAX + 1)
+        {
+            slb_JsonTape_PushInt(builder, INT64_MIN);
+        }
+        else
+        {
+            slb_JsonTape_PushDouble(builder, -(double)mantissa);
+        }
+    }
+    else if (mantissa <= (1ull << 53) && exponent >= -22 &&
+             exponent <= 22)
+    {
+        // Both exact, so one rounding gives the right double
+        double val = (double)mantissa;
+        if (exponent < 0)
+        {
+            val /= exactPowersOf10[-exponent];
+        }
+        else
+        {
+            val *= exactPowersOf10[exponent];
+        }
+
+        slb_JsonTape_PushDouble(builder, negative ? -val : val);
+    }
+    else
+    {
+        return slb_JsonTape_ParseLongNumber(builder, start, p - start,
+                                            false, negative);
+    }
+
+    return true;
+}
+
+static bool slb_JsonTape_ParseLiteral(slb_JsonTapeBuilder* builder,
+                                      size_t pos, const char* literal,
+                                      slb_JsonTapeType type)
+{
+    size_t length = strlen(literal);
+
+    if (builder->length - pos < length ||
+        memcmp(builder->json + pos, literal, length) != 0)
+    {
+        return false;
+    }
+
+    if (pos + length < builder->length &&
+        !slb_JsonTape_IsTerminator(builder->json[pos + length]))
+    {
+        return false;
+    }
+
+    slb_JsonTape_PushWord(builder, SLB_JSON_TAPE_WORD(type, 0));
+
+    return true;
+}
+
+// Walks the tokens found by slb_JsonTape_Index, checking the grammar
+// and writing each value to the tape
+static bool slb_JsonTape_Build(slb_JsonTapeBuilder* builder,
+                               const uint32_t*      indices,
+                               size_t               indexCount)
+{
+    const uint8_t* json = builder->json;
+
+    slb_JsonTapeFrame frames[SLB_JSON_TAPE_MAX_DEPTH];
+    int               depth = 0;
+    size_t            next = 0;
+    slb_JsonTapeState state = slb_JsonTapeState_Value;
+
+    for (;;)
+    {
+        switch (state)
+        {
+        case slb_JsonTapeState_Value:
+        {
+            if (next == indexCount)
+            {
+                return false;
+            }
+
+            size_t pos = indices[next++];
+            size_t span = (next < indexCount ? indices[next]
+                                             : builder->length) -
+                          pos;
+            bool   parsed;
+
+            switch (json[pos])
+            {
+            case '{':
+            case '[':
+            {
+                if (depth == SLB_JSON_TAPE_MAX_DEPTH)
+                {
+                    return false;
+                }
+
+                bool isObject = json[pos] == '{';
+                frames[depth++] = (slb_JsonTapeFrame) {
+                    (uint32_t)builder->wordCount, 0, isObject};
+
+                // Filled in once the container is closed
+                slb_JsonTape_PushWord(builder, 0);
+
+                if (next < indexCount &&
+                    json[indices[next]] == (isObject ? '}' : ']'))
+                {
+                    next++;
+                    state = slb_JsonTapeState_Close;
+                }
+                else
+                {
+                    state = isObject ? slb_JsonTapeState_Key
+                                     : slb_JsonTapeState_Value;
+                }
+                continue;
+            }
+            case '"':
+                parsed = slb_JsonTape_ParseString(builder, pos, span);
+                break;
+            case 't':
+                parsed = slb_JsonTape_ParseLiteral(
+                    builder, pos, "true", slb_JsonTapeType_True);
+                break;
+            case 'f':
+                parsed = slb_JsonTape_ParseLiteral(
+                    builder, pos, "false", slb_JsonTapeType_False);
+                break;
+            case 'n':
+                parsed = slb_JsonTape_ParseLiteral(
+                    builder, pos, "null", slb_JsonTapeType_Null);
+                break;
+            default:
+                parsed = slb_JsonTape_ParseNumber(builder, pos);
+                break;
+            }
+
+            if (!parsed)
+            {
+                return false;
+            }
+
+            state = slb_JsonTapeState_After;
+            break;
+        }
+        case slb_JsonTapeState_Key:
+        {
+            if (next == indexCount || json[indices[next]] != '"')
+            {
+                return false;
+            }
+
+            size_t pos = indices[next++];
+            size_t span = (next < indexCount ? indices[next]
+                                             : builder->length) -
+                          pos;
+
+            if (!slb_JsonTape_ParseString(builder, pos, span) ||
+                next == indexCount || json[indices[next]] != ':')
+            {
+                return false;
+            }
+
+            next++;
+            state = slb_JsonTapeState_Value;
+            break;
+        }
+        case slb_JsonTapeState_After:
+        {
+            if (depth == 0)
+            {
+                return next == indexCount; // Nothing after the document
+            }
+
+            slb_JsonTapeFrame* frame = &frames[depth - 1];
+            frame->count++;
+
+            if (next == indexCount)
+            {
+                return false;
+            }
+
+            uint8_t c = json[indices[next++]];
+
+            if (c == ',')
+            {
+                state = frame->isObject ? slb_JsonTapeState_Key
+                                        : slb_JsonTapeState_Value;
+            }
+            else if (c == (frame->isObject ? '}' : ']'))
+            {
+                state = slb_JsonTapeState_Close;
+            }
+            else
+            {
+                return false;
+            }
+            break;
+        }
+        case slb_JsonTapeState_Close:
+        {
+            slb_JsonTapeFrame frame = frames[--depth];
+
+            uint64_t count = frame.count < SLB_JSON_TAPE_COUNT_LIMIT
+                                 ? frame.count
+                                 : SLB_JSON_TAPE_COUNT_LIMIT;
+            uint64_t length = builder->wordCount - frame.word;
+
+            builder->words[frame.word] = SLB_JSON_TAPE_WORD(
+                frame.isObject ? slb_JsonTapeType_Object
+                               : slb_JsonTapeType_Array,
+                (count << 32) | length);
+
+            state = slb_JsonTapeState_After;
+            break;
+        }
+        }
+    }
+}
+
+// Moves the strings in behind the words, in one allocation, and points
+// each string word at its string
+static void slb_JsonTape_Finish(slb_JsonTapeBuilder* builder,
+                                slb_JsonTape*        tape)
+{
+    size_t   wordCount = builder->wordCount;
+    uint64_t stringsStart = wordCount * sizeof(uint64_t);
+
+    for (size_t i = 0; i < wordCount;)
+    {
+        slb_JsonTapeType type = (slb_JsonTapeType)(builder->words[i] >> 56);
+
+        if (type == slb_JsonTapeType_String)
+        {
+            builder->words[i] += stringsStart - i * sizeof(uint64_t);
+        }
+
+        i += type == slb_JsonTapeType_Int ||
+                     type == slb_JsonTapeType_Unsigned ||
+                     type == slb_JsonTapeType_Double
+                 ? 2
+                 : 1;
+    }
+
+    tape->size = stringsStart + builder->stringSize;
+    tape->words = realloc(builder->words, tape->size);
+    tape->wordCount = wordCount;
+
+    memcpy((uint8_t*)tape->words + stringsStart, builder->strings,
+           builder->stringSize);
+    free(builder->strings);
+}
+
+bool slb_JsonTape_Parse(slb_JsonTape* tape, const char* json,
+                        size_t length)
+{
+    *tape = (slb_JsonTape) {0};
+
+    const uint8_t* bytes = (const uint8_t*)json;
+
+    // nlohmann skips a byte order mark too
+    if (length >= 3 && memcmp(bytes, "\xEF\xBB\xBF", 3) == 0)
+    {
+        bytes += 3;
+        length -= 3;
+    }
+
+    if (length > UINT32_MAX - SLB_JSON_TAPE_PADDING)
+    {
+        return false;
+    }
+
+    slb_JsonTapeKernel       kernel = slb_JsonTape_GetKernel();
+    slb_JsonTapeClassifyFunc classify = slb_JsonTape_ClassifyScalar;
+
+#ifdef SLB_JSON_TAPE_X86
+    if (kernel == slb_JsonTapeKernel_Avx2)
+    {
+        classify = slb_JsonTape_ClassifyAvx2;
+    }
+    else if (kernel == slb_JsonTapeKernel_Sse2)
+    {
+        classify = slb_JsonTape_ClassifySse2;
+    }
+#endif
+
+    uint32_t* indices;
+    size_t    indexCount;
+
+    if (!slb_JsonTape_Index(bytes, length, classify, &indices,
+                            &indexCount))
+    {
+        return false;
+    }
+
+    slb_JsonTapeBuilder builder = {0};
+    builder.json = bytes;
+    builder.length = length;
+    builder.simd = kernel != slb_JsonTapeKernel_Scalar;
+    builder.wordCapacity = indexCount / 2 + 16;
+    builder.words = malloc(builder.wordCapacity * sizeof(uint64_t));
+    builder.stringCapacity = length / 2 + 64;
+    builder.strings = malloc(builder.stringCapacity);
+
+    bool built = slb_JsonTape_Build(&builder, indices, indexCount);
+    free(indices);
+
+    if (!built)
+    {
+        free(builder.words);
+        free(builder.strings);
+        return false;
+    }
+
+    slb_JsonTape_Finish(&builder, tape);
+
+    return true;
+}
+
+bool slb_JsonTape_ParseFile(slb_JsonTape* tape, const char* filename)
+{
+    *tape = (slb_JsonTape) {0};
+
+    FILE* file = fopen(filename, "rb");
+    if (file == NULL)
+    {
+        return false;
+    }
+
+    fseek(file, 0, SEEK_END);
+    long size = ftell(file);
+    fseek(file, 0, SEEK_SET);
+
+    if (size < 0)
+    {
+        fclose(file);
+        return false;
+    }
+
+    char*  json = malloc((size_t)size + SLB_JSON_TAPE_PADDING);
+    size_t read = fread(json, 1, (size_t)size, file);
+    fclose(file);
+
+    memset(json + read, 0, SLB_JSON_TAPE_PADDING);
+
+    bool parsed =
+        read == (size_t)size && slb_JsonTape_Parse(tape, json, read);
+    free(json);
+
+    return parsed;
+}
+
+void slb_JsonTape_Destroy(slb_JsonTape* tape)
+{
+    free(tape->words);
+    *tape = (slb_JsonTape) {0};
+}
+
+slb_JsonTapeKernel slb_JsonTape_GetBestKernel()
+{
+#if defined(SLB_JSON_TAPE_X86) && defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 0);
+    int maxLeaf = info[0];
+
+    __cpuid(info, 1);
+    bool sse2 = (info[3] & (1 << 26)) != 0;
+    bool osSavesAvx = (info[2] & (1 << 27)) != 0 &&
+                      (info[2] & (1 << 28)) != 0 &&
+                      (_xgetbv(0) & 6) == 6;
+
+    bool avx2 = false;
+    if (maxLeaf >= 7 && osSavesAvx)
+    {
+        __cpuidex(info, 7, 0);
+        avx2 = (info[1] & (1 << 5)) != 0;
+    }
+#elif defined(SLB_JSON_TAPE_X86)
+    __builtin_cpu_init();
+    bool sse2 = __builtin_cpu_supports("sse2");
+    bool avx2 = __builtin_cpu_supports("avx2");
+#else
+    bool sse2 = false;
+    bool avx2 = false;
+#endif
+
+    if (avx2)
+    {
+        return slb_JsonTapeKernel_Avx2;
+    }
+    if (sse2)
+    {
+        return slb_JsonTapeKernel_Sse2;
+    }
+
+    return slb_JsonTapeKernel_Scalar;
+}
+
+void slb_JsonTape_SetKernel(slb_JsonTapeKernel kernel)
+{
+    // Each kernel needs the instructions of the ones before it
+    slb_JsonTapeKernel best = slb_JsonTape_GetBestKernel();
+    tapeKernel = kernel < best ? kernel : best;
+}
+
+slb_JsonTapeKernel slb_JsonTape_GetKernel()
+{
+    if (tapeKernel < 0)
+    {
+        tapeKernel = slb_JsonTape_GetBestKernel();
+    }
+
+    return (slb_JsonTapeKernel)tapeKernel;
+}
+
+slb_JsonTapeType slb_JsonTape_Type(const uint64_t* word)
+{
+    return (slb_JsonTapeType)(*word >> 56);
+}
+
+const uint64_t* slb_JsonTape_Skip(const uint64_t* word)
+{
+    switch (slb_JsonTape_Type(word))
+    {
+    case slb_JsonTapeType_Object:
+    case slb_JsonTapeType_Array:
+        return word + (uint32_t)*word;
+    case slb_JsonTapeType_Int:
+    case slb_JsonTapeType_Unsigned:
+    case slb_JsonTapeType_Double:
+        return word + 2;
+    default:
+        return word + 1;
+    }
+}
+
+size_t slb_JsonTape_Count(const uint64_t* word)
+{
+    slb_JsonTapeType type = slb_JsonTape_Type(word);
+    if (type != slb_JsonTapeType_Object && type != slb_JsonTapeType_Array)
+    {
+        return 0;
+    }
+
+    size_t count = (size_t)((*word >> 32) & SLB_JSON_TAPE_COUNT_LIMIT);
+    if (count < SLB_JSON_TAPE_COUNT_LIMIT)
+    {
+        return count;
+    }
+
+    // Too many to have been stored
+    const uint64_t* end = slb_JsonTape_Skip(word);
+
+    count = 0;
+    for (const uint64_t* element = word + 1; element < end; count++)
+    {
+        if (type == slb_JsonTapeType_Object)
+        {
+            element++; // Keys are always one word
+        }
+        element = slb_JsonTape_Skip(element);
+    }
+
+    return count;
+}
+
+const char* slb_JsonTape_String(const uint64_t* word, size_t* length)
+{
+    const uint8_t* string =
+        (const uint8_t*)word + (*word & SLB_JSON_TAPE_PAYLOAD_MASK);
+
+    uint32_t stored;
+    memcpy(&stored, string, sizeof(stored));
+
+    if (length != NULL)
+    {
+        *length = stored;
+    }
+
+    return (const char*)string + sizeof(stored);
+}
+
+int64_t slb_JsonTape_Int(const uint64_t* word)
+{
+    int64_t val;
+    memcpy(&val, word + 1, sizeof(val));
+    return val;
+}
+
+uint64_t slb_JsonTape_Unsigned(const uint64_t* word)
+{
+    return word[1];
+}
+
+double slb_JsonTape_Double(const uint64_t* word)
+{
+    double val;
+    memcpy(&val, word + 1, sizeof(val));
+    return val;
+}
@@ -0,0 +1,96 @@
+#pragma once
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Readable bytes slb_JsonTape_Parse needs past the end of its input.
+// What they hold doesn't matter.
+#define SLB_JSON_TAPE_PADDING 64
+
+// Deepest nesting of objects and arrays a document may have
+#define SLB_JSON_TAPE_MAX_DEPTH 1024
+
+// How the structural pass and string scanning read the input
+typedef enum
+{
+    slb_JsonTapeKernel_Scalar,
+    slb_JsonTapeKernel_Sse2,
+    slb_JsonTapeKernel_Avx2,
+} slb_JsonTapeKernel;
+
+// Stored in the top byte of each tape word
+typedef enum
+{
+    slb_JsonTapeType_Object = '{',
+    slb_JsonTapeType_Array = '[',
+    slb_JsonTapeType_String = '"',
+    slb_JsonTapeType_Int = 'l',      // Value in the next word
+    slb_JsonTapeType_Unsigned = 'u', // Past INT64_MAX, in the next word
+    slb_JsonTapeType_Double = 'd',   // Value in the next word
+    slb_JsonTapeType_True = 't',
+    slb_JsonTapeType_False = 'f',
+    slb_JsonTapeType_Null = 'n',
+} slb_JsonTapeType;
+
+// A parsed document as one flat run of 64 bit words, with its strings
+// stored right after them in the same allocation. Every value is one
+// word, or two for numbers, in document order, and the document is
+// the value at [words]. Below the type byte:
+//   Object, Array  bits 0-31 are the words to step over the container
+//                  and all of its contents, bits 32-55 the number of
+//                  members or elements, stuck at 0xFFFFFF past that
+//   String         bytes from the word to the string, stored as its
+//                  uint32_t length, the bytes and a terminator
+// An object's members are each a key string word and then the value.
+// Nothing points outside the words, so the tape can be read from any
+// word without the slb_JsonTape it came from.
+typedef struct
+{
+    uint64_t* words;
+    size_t    wordCount;
+    size_t    size; // Bytes in total, strings included
+} slb_JsonTape;
+
+// Parses [length] bytes of UTF-8 [json], followed by at least
+// SLB_JSON_TAPE_PADDING more readable bytes. Returns false if it isn't
+// a valid JSON document or nests too deeply.
+bool slb_JsonTape_Parse(slb_JsonTape* tape, const char* json,
+                        size_t length);
+
+// Returns false if [filename] couldn't be read or doesn't hold valid
+// JSON
+bool slb_JsonTape_ParseFile(slb_JsonTape* tape, const char* filename);
+
+void slb_JsonTape_Destroy(slb_JsonTape* tape);
+
+// The fastest kernel this CPU supports
+slb_JsonTapeKernel slb_JsonTape_GetBestKernel();
+
+// Parses with [kernel] from now on, or the best one supported if the
+// CPU lacks it. Only worth changing to compare them.
+void               slb_JsonTape_SetKernel(slb_JsonTapeKernel kernel);
+slb_JsonTapeKernel slb_JsonTape_GetKernel();
+
+slb_JsonTapeType slb_JsonTape_Type(const uint64_t* word);
+
+// The word after the value at [word] and everything inside it
+const uint64_t* slb_JsonTape_Skip(const uint64_t* word);
+
+// Members of an object or elements of an array
+size_t slb_JsonTape_Count(const uint64_t* word);
+
+const char* slb_JsonTape_String(const uint64_t* word, size_t* length);
+
+int64_t  slb_JsonTape_Int(const uint64_t* word);
+uint64_t slb_JsonTape_Unsigned(const uint64_t* word);
+double   slb_JsonTape_Double(const uint64_t* word);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,331 @@
+#include <strolb/jsonwriter.h>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+static void slb_JsonWriter_Flush(slb_JsonWriter* writer)
+{
+    if (writer->size > 0 &&
+        fwrite(writer->buffer, 1, writer->size, writer->file) !=
+            writer->size)
+    {
+        writer->failed = true;
+    }
+
+    writer->size = 0;
+}
+
+static void slb_JsonWriter_Write(slb_JsonWriter* writer,
+                                 const char* data, size_t length)
+{
+    if (writer->size + length > SLB_JSON_WRITER_BUFFER_SIZE)
+    {
+        slb_JsonWriter_Flush(writer);
+
+        // Too big to be worth buffering
+        if (length > SLB_JSON_WRITER_BUFFER_SIZE)
+        {
+            if (fwrite(data, 1, length, writer->file) != length)
+            {
+                writer->failed = true;
+            }
+            return;
+        }
+    }
+
+    memcpy(writer->buffer + writer->size, data, length);
+    writer->size += length;
+}
+
+static void slb_JsonWriter_Put(slb_JsonWriter* writer, char c)
+{
+    if (writer->size == SLB_JSON_WRITER_BUFFER_SIZE)
+    {
+        slb_JsonWriter_Flush(writer);
+    }
+
+    writer->buffer[writer->size++] = c;
+}
+
+static void slb_JsonWriter_NewLine(slb_JsonWriter* writer)
+{
+    if (!writer->pretty)
+    {
+        return;
+    }
+
+    slb_JsonWriter_Put(writer, '\n');
+    for (int i = 0; i < writer->depth * 4; i++)
+    {
+        slb_JsonWriter_Put(writer, ' ');
+    }
+}
+
+// Separates a value from the one before it, unless it follows a key
+static void slb_JsonWriter_BeginValue(slb_JsonWriter* writer)
+{
+    if (writer->afterKey)
+    {
+        writer->afterKey = false;
+        return;
+    }
+
+    if (writer->depth > 0)
+    {
+        if (!writer->first)
+        {
+            slb_JsonWriter_Put(writer, ',');
+        }
+        slb_JsonWriter_NewLine(writer);
+    }
+
+    writer->first = false;
+}
+
+static void slb_JsonWriter_Begin(slb_JsonWriter* writer, char open)
+{
+    slb_JsonWriter_BeginValue(writer);
+    slb_JsonWriter_Put(writer, open);
+
+    writer->depth++;
+    writer->first = true;
+}
+
+static void slb_JsonWriter_End(slb_JsonWriter* writer, char close)
+{
+    writer->depth--;
+
+    // Empty containers stay on one line
+    if (!writer->first)
+    {
+        slb_JsonWriter_NewLine(writer);
+    }
+    slb_JsonWriter_Put(writer, close);
+
+    writer->first = false;
+}
+
+// Writes [text] quoted, escaping what JSON doesn't allow raw. UTF-8
+// passes through as is.
+static void slb_JsonWriter_Quote(slb_JsonWriter* writer,
+                                 const char*     text)
+{
+    slb_JsonWriter_Put(writer, '"');
+
+    const char* run = text;
+    for (const char* c = text; *c != '\0'; c++)
+    {
+        unsigned char byte = (unsigned char)*c;
+        if (byte >= 0x20 && byte != '"' && byte != '\\')
+        {
+            continue;
+        }
+
+        slb_JsonWriter_Write(writer, run, c - run);
+        run = c + 1;
+
+        char escape[8];
+        switch (byte)
+        {
+        case '"':
+            slb_JsonWriter_Write(writer, "\\\"", 2);
+            break;
+        case '\\':
+            slb_JsonWriter_Write(writer, "\\\\", 2);
+            break;
+        case '\n':
+            slb_JsonWriter_Write(writer, "\\n", 2);
+            break;
+        case '\r':
+            slb_JsonWriter_Write(writer, "\\r", 2);
+            break;
+        case '\t':
+            slb_JsonWriter_Write(writer, "\\t", 2);
+            break;
+        case '\b':
+            slb_JsonWriter_Write(writer, "\\b", 2);
+            break;
+        case '\f':
+            slb_JsonWriter_Write(writer, "\\f", 2);
+            break;
+        default:
+            snprintf(escape, sizeof(escape), "\\u%04x", byte);
+            slb_JsonWriter_Write(writer, escape, 6);
+            break;
+        }
+    }
+
+    slb_JsonWriter_Write(writer, run, strlen(run));
+    slb_JsonWriter_Put(writer, '"');
+}
+
+// Writes [val] with [digits] significant digits, enough to read back
+// the same value, and keeps a decimal point so it reads back as a
+// float. JSON has no NaN or infinity, so those are written as null.
+static void slb_JsonWriter_Number(slb_JsonWriter* writer, double val,
+                                  int digits)
+{
+    slb_JsonWriter_BeginValue(writer);
+
+    if (!isfinite(val))
+    {
+        slb_JsonWriter_Write(writer, "null", 4);
+        return;
+    }
+
+    char number[32];
+    int  length = snprintf(number, sizeof(number), "%.*g", digits, val);
+
+    if (strpbrk(number, ".e") == NULL)
+    {
+        number[length++] = '.';
+        number[length++] = '0';
+    }
+
+    slb_JsonWriter_Write(writer, number, length);
+}
+
+bool slb_JsonWriter_Open(slb_JsonWriter* writer, const char* filename,
+                         bool pretty)
+{
+    *writer = (slb_JsonWriter) {0};
+
+    writer->file = fopen(filename, "wb");
+    if (writer->file == NULL)
+    {
+        return false;
+    }
+
+    writer->buffer = malloc(SLB_JSON_WRITER_BUFFER_SIZE);
+    writer->pretty = pretty;
+
+    return true;
+}
+
+bool slb_JsonWriter_Close(slb_JsonWriter* writer)
+{
+    if (writer->file == NULL)
+    {
+        return false;
+    }
+
+    slb_JsonWriter_Flush(writer);
+
+    if (fclose(writer->file) != 0)
+    {
+        writer->failed = true;
+    }
+
+    free(writer->buffer);
+
+    bool succeeded = !writer->failed;
+    *writer = (slb_JsonWriter) {0};
+
+    return succeeded;
+}
+
+void slb_JsonWriter_BeginObject(slb_JsonWriter* writer)
+{
+    slb_JsonWriter_Begin(writer, '{');
+}
+
+void slb_JsonWriter_EndObject(slb_JsonWriter* writer)
+{
+    slb_JsonWriter_End(writer, '}');
+}
+
+void slb_JsonWriter_BeginArray(slb_JsonWriter* writer)
+{
+    slb_JsonWriter_Begin(writer, '[');
+}
+
+void slb_JsonWriter_EndArray(slb_JsonWriter* writer)
+{
+    slb_JsonWriter_End(writer, ']');
+}
+
+void slb_JsonWriter_Key(slb_JsonWriter* writer, const char* key)
+{
+    slb_JsonWriter_BeginValue(writer);
+    slb_JsonWriter_Quote(writer, key);
+
+    if (writer->pretty)
+    {
+        slb_JsonWriter_Write(writer, ": ", 2);
+    }
+    else
+    {
+        slb_JsonWriter_Put(writer, ':');
+    }
+
+    writer->afterKey = true;
+}
+
+void slb_JsonWriter_String(slb_JsonWriter* writer, const char* val)
+{
+    slb_JsonWriter_BeginValue(writer);
+    slb_JsonWriter_Quote(writer, val != NULL ? val : "");
+}
+
+void slb_JsonWriter_Int(slb_JsonWriter* writer, int val)
+{
+    slb_JsonWriter_BeginValue(writer);
+
+    // Connections are most of a save's numbers, and this is a lot
+    // cheaper than snprintf
+    char         number[12];
+    char*        digit = number + sizeof(number);
+    unsigned int magnitude = val < 0 ? 0u - (unsigned int)val
+                                    : (unsigned int)val;
+
+    do
+    {
+        *--digit = (char)('0' + magnitude % 10);
+        magnitude /= 10;
+    } while (magnitude != 0);
+
+    if (val < 0)
+    {
+        *--digit = '-';
+    }
+
+    slb_JsonWriter_Write(writer, digit, number + sizeof(number) - digit);
+}
+
+void slb_JsonWriter_Float(slb_JsonWriter* writer, float val)
+{
+    slb_JsonWriter_Number(writer, val, 9);
+}
+
+void slb_JsonWriter_Double(slb_JsonWriter* writer, double val)
+{
+    slb_JsonWriter_Number(writer, val, 17);
+}
+
+void slb_JsonWriter_Bool(slb_JsonWriter* writer, bool val)
+{
+    slb_JsonWriter_BeginValue(writer);
+
+    if (val)
+    {
+        slb_JsonWriter_Write(writer, "true", 4);
+    }
+    else
+    {
+        slb_JsonWriter_Write(writer, "false", 5);
+    }
+}
+
+void slb_JsonWriter_Null(slb_JsonWriter* writer)
+{
+    slb_JsonWriter_BeginValue(writer);
+    slb_JsonWriter_Write(writer, "null", 4);
+}
+
+void slb_JsonWriter_Float2(slb_JsonWriter* writer, const vec2 val)
+{
+    slb_JsonWriter_BeginArray(writer);
+    slb_JsonWriter_Float(writer, val[0]);
+    slb_JsonWriter_Float(writer, val[1]);
+    slb_JsonWriter_EndArray(writer);
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <cglm/cglm.h>
+
+#define SLB_JSON_WRITER_BUFFER_SIZE (64 * 1024)
+
+// Writes JSON straight to a file as it is produced, through one fixed
+// buffer, so nothing the size of the document is ever held in memory.
+// Values inside an object must each follow a slb_JsonWriter_Key.
+// Pretty output is laid out like slb_Json_SaveToFile's, with four
+// spaces per level; compact output has no whitespace at all.
+typedef struct
+{
+    FILE*  file;
+    char*  buffer;
+    size_t size; // Bytes waiting in [buffer]
+    bool   pretty;
+    int    depth;    // Of the container being written
+    bool   first;    // Nothing written in the container yet
+    bool   afterKey; // The next value belongs to the last key
+    bool   failed;   // A write to the file didn't go through
+} slb_JsonWriter;
+
+// Returns false if [filename] couldn't be opened for writing
+bool slb_JsonWriter_Open(slb_JsonWriter* writer, const char* filename,
+                         bool pretty);
+
+// Flushes and closes the file. Returns false if any of it failed to
+// be written.
+bool slb_JsonWriter_Close(slb_JsonWriter* writer);
+
+void slb_JsonWriter_BeginObject(slb_JsonWriter* writer);
+void slb_JsonWriter_EndObject(slb_JsonWriter* writer);
+void slb_JsonWriter_BeginArray(slb_JsonWriter* writer);
+void slb_JsonWriter_EndArray(slb_JsonWriter* writer);
+
+void slb_JsonWriter_Key(slb_JsonWriter* writer, const char* key);
+
+void slb_JsonWriter_String(slb_JsonWriter* writer, const char* val);
+void slb_JsonWriter_Int(slb_JsonWriter* writer, int val);
+void slb_JsonWriter_Float(slb_JsonWriter* writer, float val);
+void slb_JsonWriter_Double(slb_JsonWriter* writer, double val);
+void slb_JsonWriter_Bool(slb_JsonWriter* writer, bool val);
+void slb_JsonWriter_Null(slb_JsonWriter* writer);
+
+// Writes [val] as a two element array, like slb_Json_SaveFloat2
+void slb_JsonWriter_Float2(slb_JsonWriter* writer, const vec2 val);
@@ -0,0 +1,134 @@
+#include <strolb/mappedfile.h>
+
+#ifdef _WIN32
+#    define WIN32_LEAN_AND_MEAN
+#    include <windows.h>
+#else
+#    include <fcntl.h>
+#    include <sys/mman.h>
+#    include <sys/stat.h>
+#    include <unistd.h>
+#endif
+
+#ifdef _WIN32
+
+bool slb_MappedFile_Open(slb_MappedFile* file, const char* filename)
+{
+    *file = (slb_MappedFile) {0};
+
+    HANDLE handle =
+        CreateFileA(filename, GENERIC_READ, FILE_SHARE_READ, NULL,
+                    OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (handle == INVALID_HANDLE_VALUE)
+    {
+        return false;
+    }
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(handle, &size))
+    {
+        CloseHandle(handle);
+        return false;
+    }
+
+    file->file = handle;
+    file->size = (size_t)size.QuadPart;
+
+    // Windows can't map an empty file
+    if (file->size == 0)
+    {
+        return true;
+    }
+
+    file->mapping =
+        CreateFileMappingA(handle, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (file->mapping != NULL)
+    {
+        file->data =
+            MapViewOfFile(file->mapping, FILE_MAP_READ, 0, 0, 0);
+    }
+
+    if (file->data == NULL)
+    {
+        slb_MappedFile_Close(file);
+        return false;
+    }
+
+    return true;
+}
+
+void slb_MappedFile_Close(slb_MappedFile* file)
+{
+    if (file->data != NULL)
+    {
+        UnmapViewOfFile(file->data);
+    }
+    if (file->mapping != NULL)
+    {
+        CloseHandle(file->mapping);
+    }
+    if (file->file != NULL)
+    {
+        CloseHandle(file->file);
+    }
+
+    *file = (slb_MappedFile) {0};
+}
+
+#else
+
+bool slb_MappedFile_Open(slb_MappedFile* file, const char* filename)
+{
+    *file = (slb_MappedFile) {0};
+    file->fd = -1;
+
+    int fd = open(filename, O_RDONLY);
+    if (fd < 0)
+    {
+        return false;
+    }
+
+    struct stat info;
+    if (fstat(fd, &info) != 0)
+    {
+        close(fd);
+        return false;
+    }
+
+    file->fd = fd;
+    file->size = (size_t)info.st_size;
+
+    // mmap refuses a length of 0
+    if (file->size == 0)
+    {
+        return true;
+    }
+
+    void* data = mmap(NULL, file->size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (data == MAP_FAILED)
+    {
+        slb_MappedFile_Close(file);
+        return false;
+    }
+
+    file->data = data;
+
+    return true;
+}
+
+void slb_MappedFile_Close(slb_MappedFile* file)
+{
+    if (file->data != NULL)
+    {
+        munmap((void*)file->data, file->size);
+    }
+    if (file->fd >= 0)
+    {
+        close(file->fd);
+    }
+
+    *file = (slb_MappedFile) {0};
+    file->fd = -1;
+}
+
+#endif
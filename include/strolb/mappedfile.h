@@ -0,0 +1,24 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+
+// A whole file mapped read only into memory, so reading it is just
+// pointer access and pages are only loaded as they are touched
+typedef struct
+{
+    const void* data; // NULL for an empty file
+    size_t      size;
+#ifdef _WIN32
+    void* file;    // HANDLE
+    void* mapping; // HANDLE
+#else
+    int fd;
+#endif
+} slb_MappedFile;
+
+// Returns false if [filename] couldn't be opened or mapped
+bool slb_MappedFile_Open(slb_MappedFile* file, const char* filename);
+
+// Unmaps the file, every pointer into it becomes invalid
+void slb_MappedFile_Close(slb_MappedFile* file);
@@ -0,0 +1,220 @@
+#include <strolb/slotmap.h>
+
+#define SLB_NO_FREE_SLOT UINT32_MAX
+
+slb_SlotMap* slb_SlotMap_Create(size_t elemSize, size_t initialCapacity)
+{
+    if (initialCapacity == 0)
+    {
+        initialCapacity = 1;
+    }
+
+    slb_SlotMap* map = malloc(sizeof(slb_SlotMap));
+    map->dense = slb_Vector_Create(elemSize, initialCapacity);
+    map->denseToSlot =
+        slb_Vector_Create(sizeof(uint32_t), initialCapacity);
+    map->slots = slb_Vector_Create(sizeof(slb_Slot), initialCapacity);
+    map->freeSlot = SLB_NO_FREE_SLOT;
+    map->size = 0;
+
+    return map;
+}
+
+void slb_SlotMap_Free(slb_SlotMap* map)
+{
+    slb_Vector_Free(map->dense);
+    slb_Vector_Free(map->denseToSlot);
+    slb_Vector_Free(map->slots);
+    free(map);
+}
+
+void slb_SlotMap_Reserve(slb_SlotMap* map, size_t capacity)
+{
+    slb_Vector_Reserve(map->dense, capacity);
+    slb_Vector_Reserve(map->denseToSlot, capacity);
+    slb_Vector_Reserve(map->slots, capacity);
+}
+
+slb_Handle slb_SlotMap_Insert(slb_SlotMap* map, const void* element)
+{
+    uint32_t slotIndex;
+    slb_Slot* slot;
+
+    if (map->freeSlot != SLB_NO_FREE_SLOT)
+    {
+        slotIndex = map->freeSlot;
+        slot = slb_Vector_Get(map->slots, slotIndex);
+        map->freeSlot = slot->denseIndex;
+    }
+    else
+    {
+        slotIndex = (uint32_t)map->slots->size;
+
+        slb_Slot newSlot = {0, 1};
+        slb_Vector_PushBack(map->slots, &newSlot);
+        slot = slb_Vector_Get(map->slots, slotIndex);
+    }
+
+    slot->denseIndex = (uint32_t)map->dense->size;
+
+    slb_Vector_PushBack(map->dense, element);
+    slb_Vector_PushBack(map->denseToSlot, &slotIndex);
+    map->size = map->dense->size;
+
+    return (slb_Handle) {slotIndex, slot->generation};
+}
+
+bool slb_SlotMap_InsertAt(slb_SlotMap* map, slb_Handle handle,
+                          const void* element)
+{
+    if (handle.generation == 0 || handle.index >= map->slots->size)
+    {
+        return false;
+    }
+
+    // Undo puts elements back in the reverse order they were removed,
+    // so the slot is nearly always at the head of the free list
+    uint32_t* link = &map->freeSlot;
+    while (*link != SLB_NO_FREE_SLOT && *link != handle.index)
+    {
+        slb_Slot* slot = slb_Vector_Get(map->slots, *link);
+        link = &slot->denseIndex;
+    }
+
+    if (*link == SLB_NO_FREE_SLOT)
+    {
+        return false;
+    }
+
+    slb_Slot* slot = slb_Vector_Get(map->slots, handle.index);
+    *link = slot->denseIndex;
+
+    slot->generation = handle.generation;
+    slot->denseIndex = (uint32_t)map->dense->size;
+
+    slb_Vector_PushBack(map->dense, element);
+    slb_Vector_PushBack(map->denseToSlot, &handle.index);
+    map->size = map->dense->size;
+
+    return true;
+}
+
+static slb_Slot* slb_SlotMap_Lookup(slb_SlotMap* map, slb_Handle handle)
+{
+    if (handle.generation == 0 || handle.index >= map->slots->size)
+    {
+        return NULL;
+    }
+
+    slb_Slot* slot = slb_Vector_Get(map->slots, handle.index);
+    if (slot->generation != handle.generation)
+    {
+        return NULL;
+    }
+
+    // InsertAt can wind a generation back, so a free slot may match a
+    // stale handle. Only slots the dense array points back to are live.
+    if (slot->denseIndex >= map->dense->size ||
+        SLB_VECTOR_AT(map->denseToSlot, uint32_t, slot->denseIndex) !=
+            handle.index)
+    {
+        return NULL;
+    }
+
+    return slot;
+}
+
+bool slb_SlotMap_Remove(slb_SlotMap* map, slb_Handle handle)
+{
+    slb_Slot* slot = slb_SlotMap_Lookup(map, handle);
+    if (slot == NULL)
+    {
+        return false;
+    }
+
+    uint32_t hole = slot->denseIndex;
+
+    slb_Vector_SwapRemove(map->dense, hole);
+    slb_Vector_SwapRemove(map->denseToSlot, hole);
+    map->size = map->dense->size;
+
+    // Repoint the slot of the element that moved into the hole
+    if (hole < map->size)
+    {
+        uint32_t movedSlot =
+            SLB_VECTOR_AT(map->denseToSlot, uint32_t, hole);
+        SLB_VECTOR_AT(map->slots, slb_Slot, movedSlot).denseIndex = hole;
+    }
+
+    // Skip 0 on wrap around so a handle can never look null
+    slot->generation++;
+    if (slot->generation == 0)
+    {
+        slot->generation = 1;
+    }
+
+    slot->denseIndex = map->freeSlot;
+    map->freeSlot = handle.index;
+
+    return true;
+}
+
+void* slb_SlotMap_Get(slb_SlotMap* map, slb_Handle handle)
+{
+    slb_Slot* slot = slb_SlotMap_Lookup(map, handle);
+    if (slot == NULL)
+    {
+        return NULL;
+    }
+
+    return slb_Vector_Get(map->dense, slot->denseIndex);
+}
+
+bool slb_SlotMap_Contains(slb_SlotMap* map, slb_Handle handle)
+{
+    return slb_SlotMap_Lookup(map, handle) != NULL;
+}
+
+int64_t slb_SlotMap_IndexOf(slb_SlotMap* map, slb_Handle handle)
+{
+    slb_Slot* slot = slb_SlotMap_Lookup(map, handle);
+    if (slot == NULL)
+    {
+        return -1;
+    }
+
+    return slot->denseIndex;
+}
+
+void* slb_SlotMap_At(slb_SlotMap* map, size_t index)
+{
+    return slb_Vector_Get(map->dense, index);
+}
+
+slb_Handle slb_SlotMap_HandleAt(slb_SlotMap* map, size_t index)
+{
+    uint32_t slotIndex =
+        *(uint32_t*)slb_Vector_Get(map->denseToSlot, index);
+    slb_Slot* slot = slb_Vector_Get(map->slots, slotIndex);
+
+    return (slb_Handle) {slotIndex, slot->generation};
+}
+
+void slb_SlotMap_Clear(slb_SlotMap* map)
+{
+    // Free the slots in reverse so the next inserts reuse them in order
+    for (size_t i = map->dense->size; i-- > 0;)
+    {
+        slb_SlotMap_Remove(map, slb_SlotMap_HandleAt(map, i));
+    }
+}
+
+bool slb_Handle_Equals(slb_Handle a, slb_Handle b)
+{
+    return a.index == b.index && a.generation == b.generation;
+}
+
+bool slb_Handle_IsNull(slb_Handle handle)
+{
+    return handle.generation == 0;
+}
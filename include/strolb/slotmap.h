@@ -0,0 +1,76 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <strolb/vector.h>
+
+// Refers to one element of a slot map. The generation goes up every
+// time a slot is reused, so a handle to a removed element stays
+// invalid even after its slot holds something else.
+typedef struct
+{
+    uint32_t index;      // Slot, not the position in the dense array
+    uint32_t generation; // 0 is never handed out
+} slb_Handle;
+
+#define SLB_NULL_HANDLE ((slb_Handle) {0, 0})
+
+typedef struct
+{
+    uint32_t denseIndex; // Or the next free slot while unused
+    uint32_t generation;
+} slb_Slot;
+
+// Stores elements contiguously while handing out handles that survive
+// other elements being removed. Insert, remove and lookup are O(1):
+// removal moves the last element into the hole and repoints its slot,
+// so the dense array can be iterated like a vector but its order is
+// not stable.
+typedef struct
+{
+    slb_Vector* dense;       // Elements, packed
+    slb_Vector* denseToSlot; // uint32_t, slot of each dense element
+    slb_Vector* slots;       // slb_Slot
+    uint32_t    freeSlot;    // Head of the free list, or UINT32_MAX
+    size_t      size;        // Same as dense->size
+} slb_SlotMap;
+
+slb_SlotMap* slb_SlotMap_Create(size_t elemSize, size_t initialCapacity);
+
+void slb_SlotMap_Free(slb_SlotMap* map);
+
+// Makes room for [capacity] elements in total, so inserting that many
+// doesn't reallocate
+void slb_SlotMap_Reserve(slb_SlotMap* map, size_t capacity);
+
+// Copies [element] in and returns its handle
+slb_Handle slb_SlotMap_Insert(slb_SlotMap* map, const void* element);
+
+// Puts [element] back under [handle] after it was removed, so handles
+// kept elsewhere (like an undo log) work again. Returns false if the
+// slot has been reused since.
+bool slb_SlotMap_InsertAt(slb_SlotMap* map, slb_Handle handle,
+                          const void* element);
+
+// Returns false if [handle] was already stale. Otherwise the element
+// that was last in the dense array now sits where the removed one was.
+bool slb_SlotMap_Remove(slb_SlotMap* map, slb_Handle handle);
+
+// Returns NULL if [handle] is stale. The pointer is invalidated by the
+// next insert or remove.
+void* slb_SlotMap_Get(slb_SlotMap* map, slb_Handle handle);
+
+bool slb_SlotMap_Contains(slb_SlotMap* map, slb_Handle handle);
+
+// Position of [handle]'s element in the dense array, or -1
+int64_t slb_SlotMap_IndexOf(slb_SlotMap* map, slb_Handle handle);
+
+// Dense array access for iteration, [index] < map->size
+void*      slb_SlotMap_At(slb_SlotMap* map, size_t index);
+slb_Handle slb_SlotMap_HandleAt(slb_SlotMap* map, size_t index);
+
+// Removes every element and invalidates every handle
+void slb_SlotMap_Clear(slb_SlotMap* map);
+
+bool slb_Handle_Equals(slb_Handle a, slb_Handle b);
+bool slb_Handle_IsNull(slb_Handle handle);
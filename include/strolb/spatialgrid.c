@@ -0,0 +1,342 @@
+#include <strolb/spatialgrid.h>
+
+// Coordinates past this many cells out share the last one, so an
+// unbounded rectangle like ComputeVisibleRect's +-FLT_MAX converts to
+// int32_t without overflow, and so does the product of its spans
+#define SLB_SPATIAL_GRID_CELL_LIMIT 1073741824.0f
+
+static uint32_t slb_SpatialGrid_Hash(int32_t x, int32_t y)
+{
+    return ((uint32_t)x * 73856093u) ^ ((uint32_t)y * 19349663u);
+}
+
+static int32_t slb_SpatialGrid_CellCoord(slb_SpatialGrid* grid,
+                                         float            value)
+{
+    float cell = floorf(value / grid->cellSize);
+
+    // Written so NaN lands on the low end
+    if (!(cell > -SLB_SPATIAL_GRID_CELL_LIMIT))
+    {
+        return -(int32_t)SLB_SPATIAL_GRID_CELL_LIMIT;
+    }
+    if (cell > SLB_SPATIAL_GRID_CELL_LIMIT)
+    {
+        return (int32_t)SLB_SPATIAL_GRID_CELL_LIMIT;
+    }
+
+    return (int32_t)cell;
+}
+
+// Returns the bucket of cell [x], [y]. If it doesn't exist yet it is
+// added when [create] is set, otherwise NULL is returned.
+static slb_GridCell* slb_SpatialGrid_FindCell(slb_SpatialGrid* grid,
+                                              int32_t x, int32_t y,
+                                              bool create)
+{
+    uint32_t mask = grid->cellCapacity - 1;
+    uint32_t slot = slb_SpatialGrid_Hash(x, y) & mask;
+
+    while (grid->cells[slot].entries != NULL)
+    {
+        slb_GridCell* cell = &grid->cells[slot];
+        if (cell->x == x && cell->y == y)
+        {
+            return cell;
+        }
+
+        slot = (slot + 1) & mask;
+    }
+
+    if (!create)
+    {
+        return NULL;
+    }
+
+    slb_GridCell* cell = &grid->cells[slot];
+    cell->x = x;
+    cell->y = y;
+    cell->entries = slb_Vector_Create(sizeof(uint32_t), 4);
+    grid->cellCount++;
+
+    return cell;
+}
+
+// Moves every bucket into a table of [capacity] buckets
+static void slb_SpatialGrid_Rehash(slb_SpatialGrid* grid,
+                                   uint32_t         capacity)
+{
+    slb_GridCell* oldCells = grid->cells;
+    uint32_t      oldCapacity = grid->cellCapacity;
+
+    grid->cells = calloc(capacity, sizeof(slb_GridCell));
+    grid->cellCapacity = capacity;
+
+    uint32_t mask = capacity - 1;
+
+    for (uint32_t i = 0; i < oldCapacity; i++)
+    {
+        if (oldCells[i].entries == NULL)
+        {
+            continue;
+        }
+
+        uint32_t slot =
+            slb_SpatialGrid_Hash(oldCells[i].x, oldCells[i].y) & mask;
+        while (grid->cells[slot].entries != NULL)
+        {
+            slot = (slot + 1) & mask;
+        }
+
+        grid->cells[slot] = oldCells[i];
+    }
+
+    free(oldCells);
+}
+
+static void slb_SpatialGrid_File(slb_SpatialGrid* grid, uint32_t index)
+{
+    slb_GridEntry* entry = slb_Vector_Get(grid->entries, index);
+
+    for (int32_t y = entry->cellMin[1]; y <= entry->cellMax[1]; y++)
+    {
+        for (int32_t x = entry->cellMin[0]; x <= entry->cellMax[0];
+             x++)
+        {
+            // Keep the table at most half full
+            if ((grid->cellCount + 1) * 2 > grid->cellCapacity)
+            {
+                slb_SpatialGrid_Rehash(grid, grid->cellCapacity * 2);
+            }
+
+            slb_GridCell* cell =
+                slb_SpatialGrid_FindCell(grid, x, y, true);
+            slb_Vector_PushBack(cell->entries, &index);
+        }
+    }
+}
+
+static void slb_SpatialGrid_Unfile(slb_SpatialGrid* grid,
+                                   uint32_t         index)
+{
+    slb_GridEntry* entry = slb_Vector_Get(grid->entries, index);
+
+    for (int32_t y = entry->cellMin[1]; y <= entry->cellMax[1]; y++)
+    {
+        for (int32_t x = entry->cellMin[0]; x <= entry->cellMax[0];
+             x++)
+        {
+            slb_GridCell* cell =
+                slb_SpatialGrid_FindCell(grid, x, y, false);
+            uint32_t*     indices =
+                SLB_VECTOR_DATA(cell->entries, uint32_t);
+
+            for (size_t i = 0; i < cell->entries->size; i++)
+            {
+                if (indices[i] == index)
+                {
+                    slb_Vector_SwapRemove(cell->entries, i);
+                    break;
+                }
+            }
+        }
+    }
+}
+
+slb_SpatialGrid slb_SpatialGrid_Create(float cellSize)
+{
+    slb_SpatialGrid grid = {0};
+    grid.cellSize = cellSize;
+    grid.entries = slb_Vector_Create(sizeof(slb_GridEntry), 64);
+    grid.cellCapacity = 64;
+    grid.cells = calloc(grid.cellCapacity, sizeof(slb_GridCell));
+
+    return grid;
+}
+
+void slb_SpatialGrid_Destroy(slb_SpatialGrid* grid)
+{
+    for (uint32_t i = 0; i < grid->cellCapacity; i++)
+    {
+        if (grid->cells[i].entries != NULL)
+        {
+            slb_Vector_Free(grid->cells[i].entries);
+        }
+    }
+
+    free(grid->cells);
+    slb_Vector_Free(grid->entries);
+
+    *grid = (slb_SpatialGrid) {0};
+}
+
+void slb_SpatialGrid_Clear(slb_SpatialGrid* grid)
+{
+    for (uint32_t i = 0; i < grid->cellCapacity; i++)
+    {
+        if (grid->cells[i].entries != NULL)
+        {
+            slb_Vector_Clear(grid->cells[i].entries);
+        }
+    }
+
+    slb_Vector_Clear(grid->entries);
+}
+
+void slb_SpatialGrid_Update(slb_SpatialGrid* grid, slb_Handle handle,
+                            vec2 min, vec2 max)
+{
+    if (handle.index >= grid->entries->size)
+    {
+        size_t oldSize = grid->entries->size;
+        slb_Vector_Resize(grid->entries, handle.index + 1);
+        memset(slb_Vector_Get(grid->entries, oldSize), 0,
+               (handle.index + 1 - oldSize) * sizeof(slb_GridEntry));
+    }
+
+    slb_GridEntry* entry = slb_Vector_Get(grid->entries, handle.index);
+
+    int32_t cellMin[2] = {slb_SpatialGrid_CellCoord(grid, min[0]),
+                          slb_SpatialGrid_CellCoord(grid, min[1])};
+    int32_t cellMax[2] = {slb_SpatialGrid_CellCoord(grid, max[0]),
+                          slb_SpatialGrid_CellCoord(grid, max[1])};
+
+    bool filed = !slb_Handle_IsNull(entry->handle);
+    bool sameCells =
+        filed && slb_Handle_Equals(entry->handle, handle) &&
+        memcmp(entry->cellMin, cellMin, sizeof(cellMin)) == 0 &&
+        memcmp(entry->cellMax, cellMax, sizeof(cellMax)) == 0;
+
+    glm_vec2_copy(min, entry->min);
+    glm_vec2_copy(max, entry->max);
+
+    if (sameCells)
+    {
+        return;
+    }
+
+    if (filed)
+    {
+        slb_SpatialGrid_Unfile(grid, handle.index);
+        entry = slb_Vector_Get(grid->entries, handle.index);
+    }
+
+    entry->handle = handle;
+    memcpy(entry->cellMin, cellMin, sizeof(cellMin));
+    memcpy(entry->cellMax, cellMax, sizeof(cellMax));
+
+    slb_SpatialGrid_File(grid, handle.index);
+}
+
+void slb_SpatialGrid_Remove(slb_SpatialGrid* grid, slb_Handle handle)
+{
+    if (handle.index >= grid->entries->size)
+    {
+        return;
+    }
+
+    slb_GridEntry* entry = slb_Vector_Get(grid->entries, handle.index);
+    if (!slb_Handle_Equals(entry->handle, handle))
+    {
+        return;
+    }
+
+    slb_SpatialGrid_Unfile(grid, handle.index);
+    entry->handle = SLB_NULL_HANDLE;
+}
+
+// Reports [index] unless this query has already seen it
+static void slb_SpatialGrid_Report(slb_SpatialGrid* grid,
+                                   uint32_t index, vec2 min, vec2 max,
+                                   slb_Vector* results)
+{
+    slb_GridEntry* entry =
+        &SLB_VECTOR_AT(grid->entries, slb_GridEntry, index);
+
+    if (entry->queryStamp == grid->queryStamp ||
+        slb_Handle_IsNull(entry->handle))
+    {
+        return;
+    }
+
+    entry->queryStamp = grid->queryStamp;
+
+    if (entry->min[0] <= max[0] && entry->max[0] >= min[0] &&
+        entry->min[1] <= max[1] && entry->max[1] >= min[1])
+    {
+        slb_Vector_PushBack(results, &entry->handle);
+    }
+}
+
+void slb_SpatialGrid_QueryPoint(slb_SpatialGrid* grid, vec2 point,
+                                slb_Vector* results)
+{
+    slb_SpatialGrid_QueryRect(grid, point, point, results);
+}
+
+void slb_SpatialGrid_QueryRect(slb_SpatialGrid* grid, vec2 min,
+                               vec2 max, slb_Vector* results)
+{
+    // Stamp 0 means never reported, so start over when it wraps
+    if (++grid->queryStamp == 0)
+    {
+        for (size_t i = 0; i < grid->entries->size; i++)
+        {
+            slb_GridEntry* entry =
+                &SLB_VECTOR_AT(grid->entries, slb_GridEntry, i);
+            entry->queryStamp = 0;
+        }
+        grid->queryStamp = 1;
+    }
+
+    int32_t cellMin[2] = {slb_SpatialGrid_CellCoord(grid, min[0]),
+                          slb_SpatialGrid_CellCoord(grid, min[1])};
+    int32_t cellMax[2] = {slb_SpatialGrid_CellCoord(grid, max[0]),
+                          slb_SpatialGrid_CellCoord(grid, max[1])};
+
+    int64_t spanned = ((int64_t)cellMax[0] - cellMin[0] + 1) *
+                      ((int64_t)cellMax[1] - cellMin[1] + 1);
+
+    // A rectangle over more cells than are in use, like the view when
+    // zoomed far out, is cheaper to answer from the buckets
+    if (spanned > grid->cellCount)
+    {
+        for (uint32_t i = 0; i < grid->cellCapacity; i++)
+        {
+            slb_GridCell* cell = &grid->cells[i];
+            if (cell->entries == NULL)
+            {
+                continue;
+            }
+
+            for (size_t j = 0; j < cell->entries->size; j++)
+            {
+                slb_SpatialGrid_Report(
+                    grid, SLB_VECTOR_AT(cell->entries, uint32_t, j), min,
+                    max, results);
+            }
+        }
+
+        return;
+    }
+
+    for (int32_t y = cellMin[1]; y <= cellMax[1]; y++)
+    {
+        for (int32_t x = cellMin[0]; x <= cellMax[0]; x++)
+        {
+            slb_GridCell* cell =
+                slb_SpatialGrid_FindCell(grid, x, y, false);
+            if (cell == NULL)
+            {
+                continue;
+            }
+
+            for (size_t j = 0; j < cell->entries->size; j++)
+            {
+                slb_SpatialGrid_Report(
+                    grid, SLB_VECTOR_AT(cell->entries, uint32_t, j), min,
+                    max, results);
+            }
+        }
+    }
+}
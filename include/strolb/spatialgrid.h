@@ -0,0 +1,64 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <cglm/cglm.h>
+#include <strolb/slotmap.h>
+#include <strolb/vector.h>
+
+// Where one handle's bounds are filed
+typedef struct
+{
+    slb_Handle handle; // Null while the entry is unused
+    vec2       min;
+    vec2       max;
+    int32_t    cellMin[2]; // Cells the bounds were filed under
+    int32_t    cellMax[2];
+    uint32_t   queryStamp; // Last query that reported this entry
+} slb_GridEntry;
+
+typedef struct
+{
+    int32_t     x;
+    int32_t     y;
+    slb_Vector* entries; // uint32_t entry index, NULL for an empty bucket
+} slb_GridCell;
+
+// Files axis aligned bounds of slot map handles under the square cells
+// they overlap, so point and rectangle queries only look at the cells
+// they touch instead of every element. Cells live in a hash table,
+// so the grid has no fixed extent. Moving an element only refiles it
+// when it crosses into other cells.
+typedef struct
+{
+    float         cellSize;
+    slb_Vector*   entries; // slb_GridEntry, indexed by handle.index
+    slb_GridCell* cells;   // Open addressing
+    uint32_t      cellCapacity;
+    uint32_t      cellCount; // Buckets in use
+    uint32_t      queryStamp;
+} slb_SpatialGrid;
+
+slb_SpatialGrid slb_SpatialGrid_Create(float cellSize);
+
+void slb_SpatialGrid_Destroy(slb_SpatialGrid* grid);
+
+// Removes every handle, keeping the cells' memory
+void slb_SpatialGrid_Clear(slb_SpatialGrid* grid);
+
+// Files [handle] under [min]/[max], or moves it there if it is already
+// in the grid
+void slb_SpatialGrid_Update(slb_SpatialGrid* grid, slb_Handle handle,
+                            vec2 min, vec2 max);
+
+void slb_SpatialGrid_Remove(slb_SpatialGrid* grid, slb_Handle handle);
+
+// Appends the slb_Handle of everything whose bounds contain [point]
+// to [results]
+void slb_SpatialGrid_QueryPoint(slb_SpatialGrid* grid, vec2 point,
+                                slb_Vector* results);
+
+// Appends the slb_Handle of everything whose bounds overlap
+// [min]/[max] to [results], each once
+void slb_SpatialGrid_QueryRect(slb_SpatialGrid* grid, vec2 min,
+                               vec2 max, slb_Vector* results);
@@ -0,0 +1,260 @@
+#include <strolb/stringarena.h>
+
+// Marks an entry whose id is on the free list
+#define SLB_STRING_FREE UINT32_MAX
+
+// The buffer is only compacted once this much of it is dead, and at
+// least half of it
+#define SLB_STRING_COMPACT_BYTES 4096
+
+static uint32_t slb_StringArena_Hash(const char* string, uint32_t length)
+{
+    // FNV-1a
+    uint32_t hash = 2166136261u;
+    for (uint32_t i = 0; i < length; i++)
+    {
+        hash ^= (unsigned char)string[i];
+        hash *= 16777619u;
+    }
+
+    return hash;
+}
+
+static slb_StringEntry* slb_StringArena_Entry(slb_StringArena* arena,
+                                              slb_StringId     id)
+{
+    return slb_Vector_Get(arena->entries, id);
+}
+
+static void slb_StringArena_InsertIndex(slb_StringArena* arena,
+                                        slb_StringId     id)
+{
+    uint32_t mask = arena->tableCapacity - 1;
+    uint32_t slot = slb_StringArena_Entry(arena, id)->hash & mask;
+
+    while (arena->table[slot] != 0)
+    {
+        slot = (slot + 1) & mask;
+    }
+
+    arena->table[slot] = id;
+}
+
+static void slb_StringArena_RebuildTable(slb_StringArena* arena,
+                                         uint32_t         capacity)
+{
+    free(arena->table);
+    arena->table = calloc(capacity, sizeof(slb_StringId));
+    arena->tableCapacity = capacity;
+
+    // The empty string is never looked up through the table
+    for (slb_StringId id = 1; id < arena->entries->size; id++)
+    {
+        if (slb_StringArena_Entry(arena, id)->offset != SLB_STRING_FREE)
+        {
+            slb_StringArena_InsertIndex(arena, id);
+        }
+    }
+}
+
+// Moves every live string to the front of a new buffer and frees the
+// ids of the dead ones
+static void slb_StringArena_Compact(slb_StringArena* arena)
+{
+    char*    bytes = malloc(arena->byteCapacity);
+    uint32_t byteCount = 1;
+    bytes[0] = '\0';
+
+    for (slb_StringId id = 1; id < arena->entries->size; id++)
+    {
+        slb_StringEntry* entry = slb_StringArena_Entry(arena, id);
+
+        if (entry->offset == SLB_STRING_FREE)
+        {
+            continue;
+        }
+
+        if (entry->refCount == 0)
+        {
+            entry->offset = SLB_STRING_FREE;
+            slb_Vector_PushBack(arena->freeIds, &id);
+            continue;
+        }
+
+        memcpy(bytes + byteCount, arena->bytes + entry->offset,
+               entry->length + 1);
+        entry->offset = byteCount;
+        byteCount += entry->length + 1;
+    }
+
+    free(arena->bytes);
+    arena->bytes = bytes;
+    arena->byteCount = byteCount;
+    arena->deadBytes = 0;
+
+    slb_StringArena_RebuildTable(arena, arena->tableCapacity);
+}
+
+slb_StringArena slb_StringArena_Create(uint32_t initialCapacity)
+{
+    slb_StringArena arena = {0};
+    arena.byteCapacity = initialCapacity > 1 ? initialCapacity : 64;
+    arena.bytes = malloc(arena.byteCapacity);
+    arena.bytes[0] = '\0';
+    arena.byteCount = 1;
+
+    arena.entries = slb_Vector_Create(sizeof(slb_StringEntry), 64);
+    arena.freeIds = slb_Vector_Create(sizeof(slb_StringId), 16);
+
+    slb_StringEntry empty = {0, 0, slb_StringArena_Hash("", 0), 1};
+    slb_Vector_PushBack(arena.entries, &empty);
+
+    slb_StringArena_RebuildTable(&arena, 64);
+
+    return arena;
+}
+
+void slb_StringArena_Destroy(slb_StringArena* arena)
+{
+    free(arena->bytes);
+    free(arena->table);
+    slb_Vector_Free(arena->entries);
+    slb_Vector_Free(arena->freeIds);
+
+    *arena = (slb_StringArena) {0};
+}
+
+slb_StringId slb_StringArena_InternRange(slb_StringArena* arena,
+                                         const char*      string,
+                                         uint32_t         length)
+{
+    if (length == 0)
+    {
+        return SLB_EMPTY_STRING;
+    }
+
+    uint32_t hash = slb_StringArena_Hash(string, length);
+    uint32_t mask = arena->tableCapacity - 1;
+
+    for (uint32_t slot = hash & mask; arena->table[slot] != 0;
+         slot = (slot + 1) & mask)
+    {
+        slb_StringId     id = arena->table[slot];
+        slb_StringEntry* entry = slb_StringArena_Entry(arena, id);
+
+        if (entry->hash == hash && entry->length == length &&
+            memcmp(arena->bytes + entry->offset, string, length) == 0)
+        {
+            // Dead strings stay findable until the next compaction
+            if (entry->refCount == 0)
+            {
+                arena->deadBytes -= length + 1;
+            }
+
+            entry->refCount++;
+            arena->liveCount += entry->refCount == 1;
+            return id;
+        }
+    }
+
+    if (arena->byteCount + length + 1 > arena->byteCapacity)
+    {
+        while (arena->byteCount + length + 1 > arena->byteCapacity)
+        {
+            arena->byteCapacity *= 2;
+        }
+
+        arena->bytes = realloc(arena->bytes, arena->byteCapacity);
+    }
+
+    slb_StringEntry entry = {arena->byteCount, length, hash, 1};
+    memcpy(arena->bytes + arena->byteCount, string, length);
+    arena->bytes[arena->byteCount + length] = '\0';
+    arena->byteCount += length + 1;
+
+    slb_StringId id;
+    if (arena->freeIds->size > 0)
+    {
+        id = *(slb_StringId*)slb_Vector_Get(arena->freeIds,
+                                            arena->freeIds->size - 1);
+        arena->freeIds->size--;
+        *slb_StringArena_Entry(arena, id) = entry;
+    }
+    else
+    {
+        id = (slb_StringId)arena->entries->size;
+        slb_Vector_PushBack(arena->entries, &entry);
+    }
+
+    arena->liveCount++;
+
+    // Keep the table at most half full
+    if (arena->entries->size * 2 > arena->tableCapacity)
+    {
+        slb_StringArena_RebuildTable(arena, arena->tableCapacity * 2);
+    }
+    else
+    {
+        slb_StringArena_InsertIndex(arena, id);
+    }
+
+    return id;
+}
+
+slb_StringId slb_StringArena_Intern(slb_StringArena* arena,
+                                    const char*      string)
+{
+    return slb_StringArena_InternRange(arena, string,
+                                       (uint32_t)strlen(string));
+}
+
+slb_StringId slb_StringArena_Retain(slb_StringArena* arena,
+                                    slb_StringId     id)
+{
+    if (id != SLB_EMPTY_STRING)
+    {
+        slb_StringArena_Entry(arena, id)->refCount++;
+    }
+
+    return id;
+}
+
+void slb_StringArena_Release(slb_StringArena* arena, slb_StringId id)
+{
+    if (id == SLB_EMPTY_STRING)
+    {
+        return;
+    }
+
+    slb_StringEntry* entry = slb_StringArena_Entry(arena, id);
+    if (entry->refCount == 0)
+    {
+        return;
+    }
+
+    entry->refCount--;
+    if (entry->refCount > 0)
+    {
+        return;
+    }
+
+    arena->liveCount--;
+    arena->deadBytes += entry->length + 1;
+
+    if (arena->deadBytes >= SLB_STRING_COMPACT_BYTES &&
+        arena->deadBytes * 2 >= arena->byteCount)
+    {
+        slb_StringArena_Compact(arena);
+    }
+}
+
+const char* slb_StringArena_Get(slb_StringArena* arena, slb_StringId id)
+{
+    return arena->bytes + slb_StringArena_Entry(arena, id)->offset;
+}
+
+uint32_t slb_StringArena_GetLength(slb_StringArena* arena,
+                                   slb_StringId     id)
+{
+    return slb_StringArena_Entry(arena, id)->length;
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <strolb/vector.h>
+
+// Index of an interned string. 0 is always the empty string.
+typedef uint32_t slb_StringId;
+
+#define SLB_EMPTY_STRING 0
+
+typedef struct
+{
+    uint32_t offset; // Into the arena's bytes
+    uint32_t length; // Without the terminator
+    uint32_t hash;
+    uint32_t refCount; // 0 while the entry is dead or free
+} slb_StringEntry;
+
+// Stores every distinct string once, back to back in one growable
+// buffer, and hands out small ids for them. Interning a string that
+// is already stored returns the same id and bumps its reference count.
+// Strings nobody references any more are dropped when enough of the
+// buffer is dead, which moves the bytes but keeps every id.
+typedef struct
+{
+    char*         bytes;
+    uint32_t      byteCount;
+    uint32_t      byteCapacity;
+    uint32_t      deadBytes;
+    slb_Vector*   entries; // slb_StringEntry, indexed by slb_StringId
+    slb_Vector*   freeIds; // slb_StringId whose entries can be reused
+    slb_StringId* table;   // Open addressing, 0 for an empty bucket
+    uint32_t      tableCapacity;
+    uint32_t      liveCount; // Entries with a reference
+} slb_StringArena;
+
+slb_StringArena slb_StringArena_Create(uint32_t initialCapacity);
+
+void slb_StringArena_Destroy(slb_StringArena* arena);
+
+// Returns the id of [string], adding it if it isn't stored yet. Every
+// call must be paired with a slb_StringArena_Release.
+slb_StringId slb_StringArena_Intern(slb_StringArena* arena,
+                                    const char*      string);
+
+// Same as slb_StringArena_Intern for the first [length] bytes of
+// [string], which doesn't have to be terminated
+slb_StringId slb_StringArena_InternRange(slb_StringArena* arena,
+                                         const char*      string,
+                                         uint32_t         length);
+
+// Takes another reference to an already interned string
+slb_StringId slb_StringArena_Retain(slb_StringArena* arena,
+                                    slb_StringId     id);
+
+void slb_StringArena_Release(slb_StringArena* arena, slb_StringId id);
+
+// The pointer is invalidated by the next intern or release
+const char* slb_StringArena_Get(slb_StringArena* arena, slb_StringId id);
+
+uint32_t slb_StringArena_GetLength(slb_StringArena* arena,
+                                   slb_StringId     id);
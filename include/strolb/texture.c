@@ -0,0 +1,170 @@
+#include <strolb/texture.h>
+#include <stb/stb_image.h>
+
+slb_TextureCache slb_TextureCache_Create(
+    slb_PhysicalDevice physicalDevice, slb_Device* device,
+    slb_UploadContext* uploadContext)
+{
+    slb_TextureCache cache = {0};
+    cache.textures = slb_Vector_Create(sizeof(slb_TextureEntry), 4);
+    cache.samplers = slb_Vector_Create(sizeof(slb_SamplerEntry), 2);
+    cache.physicalDevice = physicalDevice;
+    cache.device = device;
+    cache.uploadContext = uploadContext;
+
+    return cache;
+}
+
+static void slb_TextureCache_DestroyImage(slb_TextureCache* cache,
+                                          slb_Image*        image)
+{
+    // The sampler belongs to the cache
+    slb_Image_Destroy(image, cache->device);
+}
+
+void slb_TextureCache_Destroy(slb_TextureCache* cache)
+{
+    for (size_t i = 0; i < cache->textures->size; i++)
+    {
+        slb_TextureEntry* entry = slb_Vector_Get(cache->textures, i);
+        slb_TextureCache_DestroyImage(cache, &entry->image);
+    }
+
+    for (size_t i = 0; i < cache->samplers->size; i++)
+    {
+        slb_SamplerEntry* entry = slb_Vector_Get(cache->samplers, i);
+        vkDestroySampler(cache->device->device, entry->sampler, NULL);
+    }
+
+    slb_Vector_Free(cache->textures);
+    slb_Vector_Free(cache->samplers);
+}
+
+VkSampler slb_TextureCache_GetSampler(slb_TextureCache*   cache,
+                                      VkFilter            magFilter,
+                                      VkFilter            minFilter,
+                                      VkSamplerMipmapMode mipmapMode)
+{
+    for (size_t i = 0; i < cache->samplers->size; i++)
+    {
+        slb_SamplerEntry* entry = slb_Vector_Get(cache->samplers, i);
+
+        if (entry->magFilter == magFilter &&
+            entry->minFilter == minFilter &&
+            entry->mipmapMode == mipmapMode)
+        {
+            return entry->sampler;
+        }
+    }
+
+    slb_SamplerEntry entry = {0};
+    entry.magFilter = magFilter;
+    entry.minFilter = minFilter;
+    entry.mipmapMode = mipmapMode;
+    entry.sampler = slb_Sampler_Create(
+        magFilter, minFilter, false, 1.0f, false, false,
+        VK_COMPARE_OP_ALWAYS, mipmapMode, cache->device);
+
+    slb_Vector_PushBack(cache->samplers, &entry);
+
+    return entry.sampler;
+}
+
+static slb_Image slb_TextureCache_Load(slb_TextureCache* cache,
+                                       const char*       path)
+{
+    slb_Image texture = {0};
+
+    int      texWidth, texHeight, texChannels;
+    stbi_uc* pixels = stbi_load(path, &texWidth, &texHeight,
+                                &texChannels, STBI_rgb_alpha);
+
+    if (pixels == NULL)
+    {
+        slb_Error("Failed to load texture", slb_ErrorType_Error);
+        return texture;
+    }
+
+    VkDeviceSize imageSize = texWidth * texHeight * 4; // RGBA
+
+    texture = slb_Image_Create(
+        cache->device, cache->physicalDevice, texWidth, texHeight,
+        VK_FORMAT_R8G8B8A8_SRGB, VK_IMAGE_TILING_OPTIMAL,
+        VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
+        VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+
+    slb_UploadContext_UploadImage(cache->uploadContext, pixels,
+                                  imageSize, texture.image, texWidth,
+                                  texHeight);
+
+    stbi_image_free(pixels);
+
+    texture.imageView = slb_ImageView_Create(
+        cache->device, texture.image, VK_FORMAT_R8G8B8A8_SRGB,
+        VK_IMAGE_ASPECT_COLOR_BIT);
+
+    return texture;
+}
+
+slb_Image slb_TextureCache_Acquire(slb_TextureCache* cache,
+                                   const char* path, VkFilter filter)
+{
+    VkSamplerMipmapMode mipmapMode =
+        filter == VK_FILTER_LINEAR ? VK_SAMPLER_MIPMAP_MODE_LINEAR
+                                   : VK_SAMPLER_MIPMAP_MODE_NEAREST;
+    VkSampler sampler =
+        slb_TextureCache_GetSampler(cache, filter, filter, mipmapMode);
+
+    // A handful of paths at most, a linear search is fine
+    for (size_t i = 0; i < cache->textures->size; i++)
+    {
+        slb_TextureEntry* entry = slb_Vector_Get(cache->textures, i);
+
+        if (strcmp(entry->path, path) == 0)
+        {
+            entry->refCount++;
+
+            slb_Image image = entry->image;
+            image.sampler = sampler;
+            return image;
+        }
+    }
+
+    slb_TextureEntry entry = {0};
+    strncpy(entry.path, path, sizeof(entry.path) - 1);
+    entry.image = slb_TextureCache_Load(cache, path);
+    entry.refCount = 1;
+
+    slb_Vector_PushBack(cache->textures, &entry);
+
+    slb_Image image = entry.image;
+    image.sampler = sampler;
+    return image;
+}
+
+void slb_TextureCache_Release(slb_TextureCache* cache,
+                              slb_Image         image)
+{
+    for (size_t i = 0; i < cache->textures->size; i++)
+    {
+        slb_TextureEntry* entry = slb_Vector_Get(cache->textures, i);
+
+        if (entry->image.image != image.image)
+        {
+            continue;
+        }
+
+        entry->refCount--;
+
+        if (entry->refCount <= 0)
+        {
+            slb_TextureCache_DestroyImage(cache, &entry->image);
+            slb_Vector_Remove(cache->textures, i);
+        }
+
+        return;
+    }
+
+    slb_Error("Released a texture the cache does not own",
+              slb_ErrorType_Warning);
+}
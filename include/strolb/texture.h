@@ -0,0 +1,55 @@
+#pragma once
+
+#include <strolb/vulkan.h>
+
+typedef struct
+{
+    char      path[256];
+    slb_Image image;
+    int       refCount;
+} slb_TextureEntry;
+
+typedef struct
+{
+    VkFilter            magFilter;
+    VkFilter            minFilter;
+    VkSamplerMipmapMode mipmapMode;
+    VkSampler           sampler;
+} slb_SamplerEntry;
+
+// Decodes and uploads every image once, no matter how many objects
+// use it. Textures are reference counted, samplers are shared between
+// all textures with the same filtering and live as long as the cache.
+typedef struct
+{
+    slb_Vector*        textures; // slb_TextureEntry
+    slb_Vector*        samplers; // slb_SamplerEntry
+    slb_PhysicalDevice physicalDevice;
+    slb_Device*        device;
+    slb_UploadContext* uploadContext;
+} slb_TextureCache;
+
+// Uploads are recorded into [uploadContext], a texture can be sampled
+// by anything submitted after the context's next flush
+slb_TextureCache slb_TextureCache_Create(
+    slb_PhysicalDevice physicalDevice, slb_Device* device,
+    slb_UploadContext* uploadContext);
+
+// Destroys every texture and sampler, whatever their reference count
+void slb_TextureCache_Destroy(slb_TextureCache* cache);
+
+// Returns the texture at [path], loading it on first use, and takes a
+// reference to it
+slb_Image slb_TextureCache_Acquire(slb_TextureCache* cache,
+                                   const char* path, VkFilter filter);
+
+// Drops a reference taken with slb_TextureCache_Acquire, the image is
+// destroyed once nothing references it
+void slb_TextureCache_Release(slb_TextureCache* cache,
+                              slb_Image         image);
+
+// Returns a shared sampler with the given filtering, owned by the cache
+VkSampler slb_TextureCache_GetSampler(slb_TextureCache*   cache,
+                                      VkFilter            magFilter,
+                                      VkFilter            minFilter,
+                                      VkSamplerMipmapMode mipmapMode);
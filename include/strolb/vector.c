@@ -29,25 +29,48 @@ slb_Vector* slb_Vector_Create(size_t elemSize,
     return vector;
 }
 
+// Reallocates to exactly [new_capacity] elements
+static int slb_Vector_Reallocate(slb_Vector* vector, size_t new_capacity)
+{
+    void* new_data =
+        realloc(vector->data, new_capacity * vector->elemSize);
+    if (new_data == NULL && new_capacity > 0)
+    {
+        fprintf(stderr, "Failed to reallocate memory for vector data.\n");
+        assert(1);
+        return -1;
+    }
+
+    vector->data = new_data;
+    vector->capacity = new_capacity;
+    return 0;
+}
+
+// Makes room for [min_capacity] elements, at least doubling so that
+// pushing one at a time stays amortized O(1)
+static int slb_Vector_Grow(slb_Vector* vector, size_t min_capacity)
+{
+    if (min_capacity <= vector->capacity)
+    {
+        return 0;
+    }
+
+    size_t new_capacity = vector->capacity * 2;
+    if (new_capacity < min_capacity)
+    {
+        new_capacity = min_capacity;
+    }
+
+    return slb_Vector_Reallocate(vector, new_capacity);
+}
+
 // Add an element to the vector (copies the element)
 int slb_Vector_PushBack(slb_Vector* vector, const void* element)
 {
     // Resize if needed
-    if (vector->size >= vector->capacity)
+    if (slb_Vector_Grow(vector, vector->size + 1) != 0)
     {
-        size_t new_capacity = vector->capacity * 2;
-        void*  new_data =
-            realloc(vector->data, new_capacity * vector->elemSize);
-        if (new_data == NULL)
-        {
-            fprintf(stderr,
-                    "Failed to reallocate memory for vector data.\n");
-            assert(1);
-            return -1;
-        }
-
-        vector->data = new_data;
-        vector->capacity = new_capacity;
+        return -1;
     }
 
     // Calculate position to insert and copy the element
@@ -81,28 +104,9 @@ int slb_Vector_Resize(slb_Vector* vector, size_t new_size)
     }
 
     // If we need more capacity, reallocate
-    if (new_size > vector->capacity)
-    {
-        size_t new_capacity = new_size;
-        // Optionally use growth factor for future allocations
-        if (new_capacity < vector->capacity * 2)
-        {
-            new_capacity = vector->capacity * 2;
-        }
-
-        void* new_data =
-            realloc(vector->data, new_capacity * vector->elemSize);
-        if (new_data == NULL)
-        {
-            fprintf(
-                stderr,
-                "Failed to reallocate memory for vector resize.\n");
-            assert(1);
-            return -1;
-        }
-
-        vector->data = new_data;
-        vector->capacity = new_capacity;
+    if (slb_Vector_Grow(vector, new_size) != 0)
+    {
+        return -1;
     }
 
     // Update the size
@@ -158,13 +162,7 @@ void slb_Vector_Erase(slb_Vector* vector, int index)
     if (index < 0 || index >= vector->size)
         return;
 
-    // Shift elements down
-    for (int i = index; i < vector->size - 1; i++)
-    {
-        memcpy(slb_Vector_Get(vector, i),
-               slb_Vector_Get(vector, i + 1), vector->elemSize);
-    }
-    vector->size--;
+    slb_Vector_EraseRange(vector, index, 1);
 }
 
 int slb_Vector_Insert(slb_Vector* vector, size_t index,
@@ -177,6 +175,22 @@ int slb_Vector_Insert(slb_Vector* vector, size_t index,
         return -1;
     }
 
+    return slb_Vector_InsertRange(vector, index, element, 1);
+}
+
+int slb_Vector_Reserve(slb_Vector* vector, size_t capacity)
+{
+    if (capacity <= vector->capacity)
+    {
+        return 0;
+    }
+
+    return slb_Vector_Reallocate(vector, capacity);
+}
+
+int slb_Vector_InsertRange(slb_Vector* vector, size_t index,
+                           const void* elements, size_t count)
+{
     if (index > vector->size)
     {
         fprintf(stderr, "Index out of bounds for insertion.\n");
@@ -184,41 +198,81 @@ int slb_Vector_Insert(slb_Vector* vector, size_t index,
         return -1;
     }
 
-    // Resize if needed
-    if (vector->size >= vector->capacity)
+    if (slb_Vector_Grow(vector, vector->size + count) != 0)
     {
-        size_t new_capacity = vector->capacity * 2;
-        void*  new_data =
-            realloc(vector->data, new_capacity * vector->elemSize);
-        if (new_data == NULL)
-        {
-            fprintf(stderr, "Failed to reallocate memory for vector "
-                            "insertion.\n");
-            assert(1);
-            return -1;
-        }
+        return -1;
+    }
 
-        vector->data = new_data;
-        vector->capacity = new_capacity;
+    char*  pos_to_insert = (char*)vector->data + index * vector->elemSize;
+    size_t bytes_to_move = (vector->size - index) * vector->elemSize;
+
+    // Shift elements to the right once for the whole range
+    if (bytes_to_move > 0)
+    {
+        memmove(pos_to_insert + count * vector->elemSize, pos_to_insert,
+                bytes_to_move);
     }
 
-    // Calculate position to insert
-    char* pos_to_insert =
-        (char*)vector->data + (index * vector->elemSize);
+    memcpy(pos_to_insert, elements, count * vector->elemSize);
 
-    // Calculate number of bytes to move (shift elements after index)
-    size_t bytes_to_move = (vector->size - index) * vector->elemSize;
+    vector->size += count;
+    return 0;
+}
+
+int slb_Vector_EraseRange(slb_Vector* vector, size_t index,
+                          size_t count)
+{
+    if (index > vector->size || count > vector->size - index)
+    {
+        fprintf(stderr, "Range out of bounds.\n");
+        assert(1);
+        return -1;
+    }
+
+    char*  pos_to_erase = (char*)vector->data + index * vector->elemSize;
+    size_t bytes_to_move =
+        (vector->size - index - count) * vector->elemSize;
 
-    // Shift elements to the right if needed
     if (bytes_to_move > 0)
     {
-        char* move_dest = pos_to_insert + vector->elemSize;
-        memmove(move_dest, pos_to_insert, bytes_to_move);
+        memmove(pos_to_erase, pos_to_erase + count * vector->elemSize,
+                bytes_to_move);
     }
 
-    // Copy the new element into the position
-    memcpy(pos_to_insert, element, vector->elemSize);
+    vector->size -= count;
+    return 0;
+}
 
-    vector->size++;
+int slb_Vector_SwapRemove(slb_Vector* vector, size_t index)
+{
+    if (index >= vector->size)
+    {
+        fprintf(stderr, "Index out of bounds.\n");
+        assert(1);
+        return -1;
+    }
+
+    size_t last = vector->size - 1;
+    if (index != last)
+    {
+        memcpy((char*)vector->data + index * vector->elemSize,
+               (char*)vector->data + last * vector->elemSize,
+               vector->elemSize);
+    }
+
+    vector->size--;
     return 0;
 }
+
+int slb_Vector_ShrinkToFit(slb_Vector* vector)
+{
+    // Keep room for one so a later push has something to double
+    size_t capacity = vector->size > 0 ? vector->size : 1;
+
+    if (capacity >= vector->capacity)
+    {
+        return 0;
+    }
+
+    return slb_Vector_Reallocate(vector, capacity);
+}
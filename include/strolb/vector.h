@@ -37,3 +37,31 @@ void slb_Vector_Erase(slb_Vector* vector, int index);
 
 int slb_Vector_Insert(slb_Vector* vector, size_t index,
                       const void* element);
+
+// Makes room for at least [capacity] elements without changing the
+// size, so that many pushes in a row don't reallocate
+int slb_Vector_Reserve(slb_Vector* vector, size_t capacity);
+
+// Inserts [count] elements from [elements] before [index], shifting
+// the rest up once
+int slb_Vector_InsertRange(slb_Vector* vector, size_t index,
+                           const void* elements, size_t count);
+
+// Removes [count] elements starting at [index], shifting the rest
+// down once
+int slb_Vector_EraseRange(slb_Vector* vector, size_t index,
+                          size_t count);
+
+// Removes an element in O(1) by moving the last one into its place,
+// so the order isn't kept
+int slb_Vector_SwapRemove(slb_Vector* vector, size_t index);
+
+// Gives back the memory beyond the current size
+int slb_Vector_ShrinkToFit(slb_Vector* vector);
+
+// Typed access for hot loops, without the bounds check and the
+// multiply by elemSize of slb_Vector_Get. [type] has to match the
+// elemSize the vector was created with.
+#define SLB_VECTOR_DATA(vector, type) ((type*)(vector)->data)
+#define SLB_VECTOR_AT(vector, type, index) \
+    (SLB_VECTOR_DATA(vector, type)[index])
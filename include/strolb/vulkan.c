@@ -5,7 +5,7 @@ slb_Buffer slb_Buffer_Create(uint32_t size, VkBufferUsageFlags usage,
                              slb_PhysicalDevice    physicalDevice,
                              slb_Device*           device)
 {
-    slb_Buffer buffer;
+    slb_Buffer buffer = {0};
 
     VkBufferCreateInfo bufferInfo = {0};
     bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
@@ -23,25 +23,30 @@ slb_Buffer slb_Buffer_Create(uint32_t size, VkBufferUsageFlags usage,
     vkGetBufferMemoryRequirements(device->device, buffer.buffer,
                                   &memRequirements);
 
-    VkMemoryAllocateInfo allocInfo = {0};
-    allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-    allocInfo.allocationSize = memRequirements.size;
-    allocInfo.memoryTypeIndex = slb_FindMemoryType(
-        physicalDevice, memRequirements.memoryTypeBits, properties);
+    buffer.allocation = slb_Allocator_Allocate(
+        device->allocator, memRequirements, properties, true);
 
-    if (vkAllocateMemory(device->device, &allocInfo, NULL,
-                         &buffer.memory) != VK_SUCCESS)
+    if (buffer.allocation.memory == VK_NULL_HANDLE)
     {
         slb_Error("Failed to allocate buffer memory",
                   slb_ErrorType_Error);
+        return buffer;
     }
 
-    vkBindBufferMemory(device->device, buffer.buffer, buffer.memory,
-                       0);
+    vkBindBufferMemory(device->device, buffer.buffer,
+                       buffer.allocation.memory,
+                       buffer.allocation.offset);
 
     return buffer;
 }
 
+void slb_Buffer_Destroy(slb_Buffer* buffer, slb_Device* device)
+{
+    vkDestroyBuffer(device->device, buffer->buffer, NULL);
+    slb_Allocator_Free(device->allocator, &buffer->allocation);
+    buffer->buffer = VK_NULL_HANDLE;
+}
+
 void slb_CopyBuffer(VkBuffer srcBuffer, VkBuffer dstBuffer,
                     VkDeviceSize size, slb_Device* device,
                     slb_CommandPool* commandPool)
@@ -513,6 +518,9 @@ slb_Device slb_Device_Create(slb_Instance       instance,
     vkGetDeviceQueue(device.device, indices.presentFamily, 0,
                      &device.presentQueue);
 
+    device.allocator =
+        slb_Allocator_Create(device.device, physicalDevice);
+
     slb_Vector_Free(queueCreateInfos);
 
     return device;
@@ -581,7 +589,8 @@ slb_ChooseSwapSurfaceFormat(slb_Vector* availableFormats)
 }
 
 VkPresentModeKHR
-slb_ChooseSwapPresentMode(slb_Vector* availablePresentModes)
+slb_ChooseSwapPresentMode(slb_Vector*      availablePresentModes,
+                          VkPresentModeKHR preferredMode)
 {
     for (int i = 0; i < availablePresentModes->size; i++)
     {
@@ -590,12 +599,13 @@ slb_ChooseSwapPresentMode(slb_Vector* availablePresentModes)
                                               i);
         VkPresentModeKHR availableMode = *formatPtr;
 
-        if (availableMode == VK_PRESENT_MODE_IMMEDIATE_KHR)
+        if (availableMode == preferredMode)
         {
             return availableMode;
         }
     }
 
+    // The only mode every surface has to support
     return VK_PRESENT_MODE_FIFO_KHR;
 }
 
@@ -643,7 +653,8 @@ slb_Swapchain slb_Swapchain_Create(slb_Window*        window,
                                    slb_PhysicalDevice physicalDevice,
                                    slb_Surface        surface,
                                    slb_Device*        device,
-                                   slb_Image*         depthImage)
+                                   slb_Image*         depthImage,
+                                   VkPresentModeKHR   presentMode)
 {
     slb_Swapchain swapchain;
 
@@ -652,7 +663,7 @@ slb_Swapchain slb_Swapchain_Create(slb_Window*        window,
     VkSurfaceFormatKHR format =
         slb_ChooseSwapSurfaceFormat(details.formats);
     VkPresentModeKHR mode =
-        slb_ChooseSwapPresentMode(details.presentModes);
+        slb_ChooseSwapPresentMode(details.presentModes, presentMode);
     VkExtent2D extent =
         slb_ChooseSwapExtent(&details.capabilities, window);
 
@@ -952,11 +963,14 @@ VkShaderModule slb_CreateShaderModule(slb_Device* device,
 slb_Pipeline slb_Pipeline_Create(
     slb_Device* device, slb_Swapchain* swapchain,
     slb_RenderPass renderPass, const char* vsPath, const char* fsPath,
-    VkVertexInputBindingDescription*   bindingDescription,
+    VkVertexInputBindingDescription*   bindingDescriptions,
+    uint32_t                           bindingDescriptionCount,
     VkVertexInputAttributeDescription* attributeDescriptions,
     uint32_t                           attributeDescriptionCount,
     slb_DescriptorSetLayout* layouts, uint32_t layoutCount,
-    VkPrimitiveTopology topology)
+    VkPushConstantRange* pushConstantRanges,
+    uint32_t             pushConstantRangeCount,
+    VkPrimitiveTopology  topology)
 {
     slb_Pipeline pipeline;
 
@@ -990,12 +1004,13 @@ slb_Pipeline slb_Pipeline_Create(
     VkPipelineVertexInputStateCreateInfo vertexInputInfo = {0};
     vertexInputInfo.sType =
         VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
-    vertexInputInfo.vertexBindingDescriptionCount = 1;
+    vertexInputInfo.vertexBindingDescriptionCount =
+        bindingDescriptionCount;
     vertexInputInfo.vertexAttributeDescriptionCount =
         attributeDescriptionCount;
     vertexInputInfo.pVertexAttributeDescriptions =
         attributeDescriptions;
-    vertexInputInfo.pVertexBindingDescriptions = bindingDescription;
+    vertexInputInfo.pVertexBindingDescriptions = bindingDescriptions;
 
     VkDynamicState dynamicStates[3] = {VK_DYNAMIC_STATE_VIEWPORT,
                                        VK_DYNAMIC_STATE_SCISSOR,
@@ -1086,8 +1101,9 @@ slb_Pipeline slb_Pipeline_Create(
         VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
     pipelineLayoutInfo.setLayoutCount = layoutCount;
     pipelineLayoutInfo.pSetLayouts = layouts;
-    pipelineLayoutInfo.pushConstantRangeCount = 0;
-    pipelineLayoutInfo.pPushConstantRanges = NULL;
+    pipelineLayoutInfo.pushConstantRangeCount =
+        pushConstantRangeCount;
+    pipelineLayoutInfo.pPushConstantRanges = pushConstantRanges;
 
     if (vkCreatePipelineLayout(device->device, &pipelineLayoutInfo,
                                NULL, &pipeline.layout) != VK_SUCCESS)
@@ -1173,7 +1189,19 @@ slb_Image slb_Image_Create(slb_Device*        device,
                            VkImageUsageFlags     usage,
                            VkMemoryPropertyFlags properties)
 {
-    slb_Image image;
+    return slb_Image_CreateArray(device, physicalDevice, width, height,
+                                 1, format, tiling, usage, properties);
+}
+
+slb_Image slb_Image_CreateArray(slb_Device*        device,
+                                slb_PhysicalDevice physicalDevice,
+                                uint32_t width, uint32_t height,
+                                uint32_t layerCount, VkFormat format,
+                                VkImageTiling         tiling,
+                                VkImageUsageFlags     usage,
+                                VkMemoryPropertyFlags properties)
+{
+    slb_Image image = {0};
 
     VkImageCreateInfo imageInfo = {0};
     imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
@@ -1182,7 +1210,7 @@ slb_Image slb_Image_Create(slb_Device*        device,
     imageInfo.extent.height = height;
     imageInfo.extent.depth = 1;
     imageInfo.mipLevels = 1;
-    imageInfo.arrayLayers = 1;
+    imageInfo.arrayLayers = layerCount;
     imageInfo.format = format;
     imageInfo.tiling = tiling;
     imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
@@ -1200,24 +1228,37 @@ slb_Image slb_Image_Create(slb_Device*        device,
     vkGetImageMemoryRequirements(device->device, image.image,
                                  &memRequirements);
 
-    VkMemoryAllocateInfo allocInfo = {0};
-    allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-    allocInfo.allocationSize = memRequirements.size;
-    allocInfo.memoryTypeIndex = slb_FindMemoryType(
-        physicalDevice, memRequirements.memoryTypeBits, properties);
+    image.allocation = slb_Allocator_Allocate(
+        device->allocator, memRequirements, properties,
+        tiling == VK_IMAGE_TILING_LINEAR);
 
-    if (vkAllocateMemory(device->device, &allocInfo, NULL,
-                         &image.memory) != VK_SUCCESS)
+    if (image.allocation.memory == VK_NULL_HANDLE)
     {
         slb_Error("Failed to allocate image memory",
                   slb_ErrorType_Warning);
+        return image;
     }
 
-    vkBindImageMemory(device->device, image.image, image.memory, 0);
+    vkBindImageMemory(device->device, image.image,
+                      image.allocation.memory,
+                      image.allocation.offset);
 
     return image;
 }
 
+void slb_Image_Destroy(slb_Image* image, slb_Device* device)
+{
+    if (image->imageView != VK_NULL_HANDLE)
+    {
+        vkDestroyImageView(device->device, image->imageView, NULL);
+        image->imageView = VK_NULL_HANDLE;
+    }
+
+    vkDestroyImage(device->device, image->image, NULL);
+    slb_Allocator_Free(device->allocator, &image->allocation);
+    image->image = VK_NULL_HANDLE;
+}
+
 VkImageView slb_ImageView_Create(slb_Device* device, VkImage image,
                                  VkFormat           format,
                                  VkImageAspectFlags flags)
@@ -1244,6 +1285,33 @@ VkImageView slb_ImageView_Create(slb_Device* device, VkImage image,
     return imageView;
 }
 
+VkImageView slb_ImageView_CreateArray(slb_Device* device,
+                                      VkImage image, VkFormat format,
+                                      VkImageAspectFlags flags,
+                                      uint32_t           layerCount)
+{
+    VkImageViewCreateInfo viewInfo = {0};
+    viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+    viewInfo.image = image;
+    viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D_ARRAY;
+    viewInfo.format = format;
+    viewInfo.subresourceRange.aspectMask = flags;
+    viewInfo.subresourceRange.baseMipLevel = 0;
+    viewInfo.subresourceRange.levelCount = 1;
+    viewInfo.subresourceRange.baseArrayLayer = 0;
+    viewInfo.subresourceRange.layerCount = layerCount;
+
+    VkImageView imageView;
+    if (vkCreateImageView(device->device, &viewInfo, NULL,
+                          &imageView) != VK_SUCCESS)
+    {
+        slb_Error("Failed to create image view for image",
+                  slb_ErrorType_Warning);
+    }
+
+    return imageView;
+}
+
 slb_CommandPool
 slb_CommandPool_Create(slb_PhysicalDevice physicalDevice,
                        slb_Device* device, slb_Surface surface)
@@ -1308,28 +1376,14 @@ slb_DescriptorPool_Create(VkDescriptorPoolSize* poolSizes,
     return pool;
 }
 
-void slb_TransitionImageLayout(VkImage image, VkFormat format,
-                               VkImageLayout    oldLayout,
-                               VkImageLayout    newLayout,
-                               slb_Device*      device,
-                               slb_CommandPool* commandPool)
+// Records the barrier for one of the layout transitions an upload
+// goes through
+static void slb_RecordImageLayoutTransition(VkCommandBuffer commandBuffer,
+                                            VkImage         image,
+                                            uint32_t        layerCount,
+                                            VkImageLayout   oldLayout,
+                                            VkImageLayout   newLayout)
 {
-    VkCommandBufferAllocateInfo allocInfo = {0};
-    allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
-    allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
-    allocInfo.commandPool = commandPool->commandPool;
-    allocInfo.commandBufferCount = 1;
-
-    VkCommandBuffer commandBuffer;
-    vkAllocateCommandBuffers(device->device, &allocInfo,
-                             &commandBuffer);
-
-    VkCommandBufferBeginInfo beginInfo = {0};
-    beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
-    beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
-
-    vkBeginCommandBuffer(commandBuffer, &beginInfo);
-
     VkImageMemoryBarrier barrier = {0};
     barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
     barrier.oldLayout = oldLayout;
@@ -1341,7 +1395,7 @@ void slb_TransitionImageLayout(VkImage image, VkFormat format,
     barrier.subresourceRange.baseMipLevel = 0;
     barrier.subresourceRange.levelCount = 1;
     barrier.subresourceRange.baseArrayLayer = 0;
-    barrier.subresourceRange.layerCount = 1;
+    barrier.subresourceRange.layerCount = layerCount;
 
     VkPipelineStageFlags sourceStage;
     VkPipelineStageFlags destinationStage;
@@ -1364,14 +1418,51 @@ void slb_TransitionImageLayout(VkImage image, VkFormat format,
         sourceStage = VK_PIPELINE_STAGE_TRANSFER_BIT;
         destinationStage = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
     }
+    else if (oldLayout == VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL &&
+             newLayout == VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL)
+    {
+        // Rewriting an image earlier frames may still sample
+        barrier.srcAccessMask = VK_ACCESS_SHADER_READ_BIT;
+        barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+
+        sourceStage = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+        destinationStage = VK_PIPELINE_STAGE_TRANSFER_BIT;
+    }
     else
     {
         slb_Error("Unsupported layout transition",
                   slb_ErrorType_Error);
+        return;
     }
 
     vkCmdPipelineBarrier(commandBuffer, sourceStage, destinationStage,
                          0, 0, NULL, 0, NULL, 1, &barrier);
+}
+
+void slb_TransitionImageLayout(VkImage image, VkFormat format,
+                               VkImageLayout    oldLayout,
+                               VkImageLayout    newLayout,
+                               slb_Device*      device,
+                               slb_CommandPool* commandPool)
+{
+    VkCommandBufferAllocateInfo allocInfo = {0};
+    allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+    allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+    allocInfo.commandPool = commandPool->commandPool;
+    allocInfo.commandBufferCount = 1;
+
+    VkCommandBuffer commandBuffer;
+    vkAllocateCommandBuffers(device->device, &allocInfo,
+                             &commandBuffer);
+
+    VkCommandBufferBeginInfo beginInfo = {0};
+    beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+    beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+
+    vkBeginCommandBuffer(commandBuffer, &beginInfo);
+
+    slb_RecordImageLayoutTransition(commandBuffer, image, 1, oldLayout,
+                                    newLayout);
 
     vkEndCommandBuffer(commandBuffer);
 
@@ -1472,3 +1563,320 @@ slb_Sampler_Create(VkFilter magFilter, VkFilter minFilter,
 
     return sampler;
 }
+
+slb_UploadContext slb_UploadContext_Create(
+    slb_PhysicalDevice physicalDevice, slb_Device* device,
+    slb_CommandPool* commandPool)
+{
+    slb_UploadContext context = {0};
+    context.physicalDevice = physicalDevice;
+    context.device = device;
+    context.commandPool = commandPool;
+    context.batches = slb_Vector_Create(sizeof(slb_UploadBatch), 2);
+    context.recordingBatch = -1;
+
+    return context;
+}
+
+static void slb_UploadContext_ReleaseStaging(slb_UploadContext* context,
+                                             slb_UploadBatch*   batch)
+{
+    for (size_t i = 0; i < batch->stagingBuffers->size; i++)
+    {
+        slb_Buffer* staging = slb_Vector_Get(batch->stagingBuffers, i);
+        slb_Buffer_Destroy(staging, context->device);
+    }
+
+    slb_Vector_Clear(batch->stagingBuffers);
+}
+
+void slb_UploadContext_Destroy(slb_UploadContext* context)
+{
+    slb_UploadContext_Wait(context);
+
+    for (size_t i = 0; i < context->batches->size; i++)
+    {
+        slb_UploadBatch* batch = slb_Vector_Get(context->batches, i);
+
+        slb_UploadContext_ReleaseStaging(context, batch);
+        slb_Vector_Free(batch->stagingBuffers);
+
+        vkDestroyFence(context->device->device, batch->fence, NULL);
+        vkFreeCommandBuffers(context->device->device,
+                             context->commandPool->commandPool, 1,
+                             &batch->commandBuffer);
+    }
+
+    slb_Vector_Free(context->batches);
+}
+
+// Returns the command buffer uploads are recorded into, beginning a
+// batch if none is open. Idle batches are reused before new ones are
+// made.
+static VkCommandBuffer slb_UploadContext_Begin(
+    slb_UploadContext* context)
+{
+    if (context->recordingBatch >= 0)
+    {
+        slb_UploadBatch* batch =
+            slb_Vector_Get(context->batches, context->recordingBatch);
+        return batch->commandBuffer;
+    }
+
+    slb_UploadContext_Poll(context);
+
+    int batchIndex = -1;
+    for (size_t i = 0; i < context->batches->size; i++)
+    {
+        slb_UploadBatch* batch = slb_Vector_Get(context->batches, i);
+        if (!batch->inFlight)
+        {
+            batchIndex = (int)i;
+            break;
+        }
+    }
+
+    if (batchIndex < 0)
+    {
+        slb_UploadBatch batch = {0};
+
+        VkCommandBufferAllocateInfo allocInfo = {0};
+        allocInfo.sType =
+            VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+        allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+        allocInfo.commandPool = context->commandPool->commandPool;
+        allocInfo.commandBufferCount = 1;
+
+        vkAllocateCommandBuffers(context->device->device, &allocInfo,
+                                 &batch.commandBuffer);
+
+        VkFenceCreateInfo fenceInfo = {0};
+        fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+
+        if (vkCreateFence(context->device->device, &fenceInfo, NULL,
+                          &batch.fence) != VK_SUCCESS)
+        {
+            slb_Error("Failed to create upload fence",
+                      slb_ErrorType_Error);
+        }
+
+        batch.stagingBuffers = slb_Vector_Create(sizeof(slb_Buffer), 4);
+
+        slb_Vector_PushBack(context->batches, &batch);
+        batchIndex = (int)context->batches->size - 1;
+    }
+
+    slb_UploadBatch* batch = slb_Vector_Get(context->batches, batchIndex);
+
+    vkResetCommandBuffer(batch->commandBuffer, 0);
+
+    VkCommandBufferBeginInfo beginInfo = {0};
+    beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+    beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+
+    vkBeginCommandBuffer(batch->commandBuffer, &beginInfo);
+
+    context->recordingBatch = batchIndex;
+
+    return batch->commandBuffer;
+}
+
+// Copies [data] into a staging buffer that lives until the batch
+// recording it has finished on the GPU
+static slb_Buffer slb_UploadContext_Stage(slb_UploadContext* context,
+                                          const void*        data,
+                                          VkDeviceSize       size)
+{
+    slb_Buffer staging = slb_Buffer_Create(
+        size, VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
+            VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+        context->physicalDevice, context->device);
+
+    memcpy(staging.allocation.mapped, data, (size_t)size);
+
+    slb_UploadBatch* batch =
+        slb_Vector_Get(context->batches, context->recordingBatch);
+    slb_Vector_PushBack(batch->stagingBuffers, &staging);
+
+    return staging;
+}
+
+void slb_UploadContext_CopyBuffer(slb_UploadContext* context,
+                                  const void* data, VkDeviceSize size,
+                                  VkBuffer     dstBuffer,
+                                  VkDeviceSize dstOffset)
+{
+    VkCommandBuffer commandBuffer = slb_UploadContext_Begin(context);
+    slb_Buffer staging = slb_UploadContext_Stage(context, data, size);
+
+    VkBufferCopy copyRegion = {0};
+    copyRegion.dstOffset = dstOffset;
+    copyRegion.size = size;
+    vkCmdCopyBuffer(commandBuffer, staging.buffer, dstBuffer, 1,
+                    &copyRegion);
+
+    // Later submits on the queue don't wait for the fence, so make the
+    // write visible to the draws that read it as vertices or indices
+    VkBufferMemoryBarrier barrier = {0};
+    barrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+    barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    barrier.dstAccessMask =
+        VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT | VK_ACCESS_INDEX_READ_BIT;
+    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.buffer = dstBuffer;
+    barrier.offset = dstOffset;
+    barrier.size = size;
+
+    vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT,
+                         VK_PIPELINE_STAGE_VERTEX_INPUT_BIT, 0, 0, NULL,
+                         1, &barrier, 0, NULL);
+}
+
+void slb_UploadContext_TransitionImageLayout(
+    slb_UploadContext* context, VkImage image, VkImageLayout oldLayout,
+    VkImageLayout newLayout)
+{
+    slb_UploadContext_TransitionImageLayers(context, image, 1, oldLayout,
+                                            newLayout);
+}
+
+void slb_UploadContext_TransitionImageLayers(
+    slb_UploadContext* context, VkImage image, uint32_t layerCount,
+    VkImageLayout oldLayout, VkImageLayout newLayout)
+{
+    VkCommandBuffer commandBuffer = slb_UploadContext_Begin(context);
+    slb_RecordImageLayoutTransition(commandBuffer, image, layerCount,
+                                    oldLayout, newLayout);
+}
+
+void slb_UploadContext_CopyToImage(slb_UploadContext* context,
+                                   const void* data, VkDeviceSize size,
+                                   VkImage image, uint32_t width,
+                                   uint32_t height)
+{
+    VkCommandBuffer commandBuffer = slb_UploadContext_Begin(context);
+    slb_Buffer staging = slb_UploadContext_Stage(context, data, size);
+
+    VkBufferImageCopy region = {0};
+    region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    region.imageSubresource.mipLevel = 0;
+    region.imageSubresource.baseArrayLayer = 0;
+    region.imageSubresource.layerCount = 1;
+    region.imageOffset = (VkOffset3D) {0, 0, 0};
+    region.imageExtent = (VkExtent3D) {width, height, 1};
+
+    vkCmdCopyBufferToImage(commandBuffer, staging.buffer, image,
+                           VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1,
+                           &region);
+}
+
+void slb_UploadContext_CopyToImageRegion(
+    slb_UploadContext* context, const void* data, VkDeviceSize size,
+    VkImage image, uint32_t layer, VkOffset2D offset, VkExtent2D extent)
+{
+    VkCommandBuffer commandBuffer = slb_UploadContext_Begin(context);
+    slb_Buffer staging = slb_UploadContext_Stage(context, data, size);
+
+    VkBufferImageCopy region = {0};
+    region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    region.imageSubresource.mipLevel = 0;
+    region.imageSubresource.baseArrayLayer = layer;
+    region.imageSubresource.layerCount = 1;
+    region.imageOffset = (VkOffset3D) {offset.x, offset.y, 0};
+    region.imageExtent =
+        (VkExtent3D) {extent.width, extent.height, 1};
+
+    vkCmdCopyBufferToImage(commandBuffer, staging.buffer, image,
+                           VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1,
+                           &region);
+}
+
+void slb_UploadContext_UploadImage(slb_UploadContext* context,
+                                   const void* data, VkDeviceSize size,
+                                   VkImage image, uint32_t width,
+                                   uint32_t height)
+{
+    slb_UploadContext_TransitionImageLayout(
+        context, image, VK_IMAGE_LAYOUT_UNDEFINED,
+        VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
+    slb_UploadContext_CopyToImage(context, data, size, image, width,
+                                  height);
+    slb_UploadContext_TransitionImageLayout(
+        context, image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+        VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+}
+
+void slb_UploadContext_Flush(slb_UploadContext* context)
+{
+    if (context->recordingBatch < 0)
+    {
+        return;
+    }
+
+    slb_UploadBatch* batch =
+        slb_Vector_Get(context->batches, context->recordingBatch);
+
+    vkEndCommandBuffer(batch->commandBuffer);
+
+    VkSubmitInfo submitInfo = {0};
+    submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+    submitInfo.commandBufferCount = 1;
+    submitInfo.pCommandBuffers = &batch->commandBuffer;
+
+    if (vkQueueSubmit(context->device->graphicsQueue, 1, &submitInfo,
+                      batch->fence) != VK_SUCCESS)
+    {
+        slb_Error("Failed to submit uploads", slb_ErrorType_Error);
+    }
+
+    batch->inFlight = true;
+    context->recordingBatch = -1;
+}
+
+bool slb_UploadContext_Poll(slb_UploadContext* context)
+{
+    bool idle = context->recordingBatch < 0;
+
+    for (size_t i = 0; i < context->batches->size; i++)
+    {
+        slb_UploadBatch* batch = slb_Vector_Get(context->batches, i);
+
+        if (!batch->inFlight)
+        {
+            continue;
+        }
+
+        if (vkGetFenceStatus(context->device->device, batch->fence) !=
+            VK_SUCCESS)
+        {
+            idle = false;
+            continue;
+        }
+
+        vkResetFences(context->device->device, 1, &batch->fence);
+        slb_UploadContext_ReleaseStaging(context, batch);
+        batch->inFlight = false;
+    }
+
+    return idle;
+}
+
+void slb_UploadContext_Wait(slb_UploadContext* context)
+{
+    slb_UploadContext_Flush(context);
+
+    for (size_t i = 0; i < context->batches->size; i++)
+    {
+        slb_UploadBatch* batch = slb_Vector_Get(context->batches, i);
+
+        if (batch->inFlight)
+        {
+            vkWaitForFences(context->device->device, 1, &batch->fence,
+                            VK_TRUE, UINT64_MAX);
+        }
+    }
+
+    slb_UploadContext_Poll(context);
+}
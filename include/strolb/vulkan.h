@@ -7,6 +7,7 @@
 
 #include <strolb/vector.h>
 #include <strolb/window.h>
+#include <strolb/allocator.h>
 
 #define SLB_FRAMES_IN_FLIGHT 2
 #define SLB_USE_VALIDATION_LAYERS true
@@ -43,9 +44,10 @@ slb_PhysicalDevice slb_PhysicalDevice_Create(slb_Instance instance, slb_Surface
 
 typedef struct
 {
-    VkDevice device;
-    VkQueue  graphicsQueue;
-    VkQueue  presentQueue;
+    VkDevice       device;
+    VkQueue        graphicsQueue;
+    VkQueue        presentQueue;
+    slb_Allocator* allocator; // Backs every slb_Buffer and slb_Image
 } slb_Device;
 
 slb_Device slb_Device_Create(slb_Instance instance, slb_PhysicalDevice physicalDevice, 
@@ -54,7 +56,7 @@ slb_Device slb_Device_Create(slb_Instance instance, slb_PhysicalDevice physicalD
 typedef struct
 {
     VkImage        image;
-    VkDeviceMemory memory;
+    slb_Allocation allocation;
     VkImageView    imageView;
     VkSampler      sampler;
 } slb_Image;
@@ -69,8 +71,10 @@ typedef struct
     slb_Vector*    swapchainFramebuffers; // VkFramebuffer
 } slb_Swapchain;
 
+// [presentMode] is used if the surface supports it, FIFO otherwise
 slb_Swapchain slb_Swapchain_Create(slb_Window* window, slb_PhysicalDevice physicalDevice,
-        slb_Surface surface, slb_Device* device, slb_Image* depthImage);
+        slb_Surface surface, slb_Device* device, slb_Image* depthImage,
+        VkPresentModeKHR presentMode);
 
 typedef VkRenderPass slb_RenderPass;
 
@@ -92,8 +96,8 @@ slb_DescriptorSetLayout slb_DescriptorSetLayout_Create(
 
 typedef struct
 {
-    VkBuffer buffer;
-    VkDeviceMemory memory;
+    VkBuffer       buffer;
+    slb_Allocation allocation; // allocation.mapped if host visible
 } slb_Buffer;
 
 typedef struct
@@ -116,11 +120,14 @@ typedef struct
 slb_Pipeline slb_Pipeline_Create(
     slb_Device* device, slb_Swapchain* swapchain,
     slb_RenderPass renderPass, const char* vsPath, const char* fsPath,
-    VkVertexInputBindingDescription*   bindingDescription,
+    VkVertexInputBindingDescription*   bindingDescriptions,
+    uint32_t                           bindingDescriptionCount,
     VkVertexInputAttributeDescription* attributeDescriptions,
     uint32_t                           attributeDescriptionCount,
     slb_DescriptorSetLayout* layouts, uint32_t layoutCount,
-    VkPrimitiveTopology topology);
+    VkPushConstantRange* pushConstantRanges,
+    uint32_t             pushConstantRangeCount,
+    VkPrimitiveTopology  topology);
 
 slb_CommandPool slb_CommandPool_Create(slb_PhysicalDevice physicalDevice, 
         slb_Device* device,
@@ -150,6 +157,8 @@ slb_Buffer slb_Buffer_Create(uint32_t size, VkBufferUsageFlags usage,
         VkMemoryPropertyFlags properties, slb_PhysicalDevice physicalDevice,
         slb_Device* device);
 
+void slb_Buffer_Destroy(slb_Buffer* buffer, slb_Device* device);
+
 void slb_CopyBuffer(VkBuffer srcBuffer, VkBuffer dstBuffer, VkDeviceSize size, 
         slb_Device* device, slb_CommandPool* commandPool);
 
@@ -161,16 +170,101 @@ slb_Image slb_Image_Create(slb_Device* device,
         VkImageUsageFlags     usage,
         VkMemoryPropertyFlags properties);
 
+// An image with [layerCount] array layers, for a 2D array view
+slb_Image slb_Image_CreateArray(slb_Device* device,
+        slb_PhysicalDevice physicalDevice,
+        uint32_t width, uint32_t height, uint32_t layerCount,
+        VkFormat              format,
+        VkImageTiling         tiling,
+        VkImageUsageFlags     usage,
+        VkMemoryPropertyFlags properties);
+
+// Destroys the image view too if there is one, but never the sampler
+void slb_Image_Destroy(slb_Image* image, slb_Device* device);
+
 VkImageView slb_ImageView_Create(slb_Device* device,
     VkImage image, VkFormat format,
     VkImageAspectFlags flags);
 
+VkImageView slb_ImageView_CreateArray(slb_Device* device,
+    VkImage image, VkFormat format,
+    VkImageAspectFlags flags, uint32_t layerCount);
+
 void slb_TransitionImageLayout(VkImage image, VkFormat format, VkImageLayout oldLayout, 
         VkImageLayout newLayout, slb_Device* device, slb_CommandPool* commandPool);
 
 void slb_CopyBufferToImage(VkBuffer buffer, VkImage image, uint32_t width, uint32_t height,
         slb_Device* device, slb_CommandPool* commandPool);
 
+typedef struct
+{
+    VkCommandBuffer commandBuffer;
+    VkFence         fence;
+    slb_Vector*     stagingBuffers; // slb_Buffer
+    bool            inFlight;
+} slb_UploadBatch;
+
+// Records uploads into one command buffer and submits them together
+// with a fence, instead of a blocking submit per copy like
+// slb_CopyBuffer. Staging buffers are freed once the GPU is done with
+// them. Later submits on the graphics queue don't wait on the fence;
+// each upload records the barrier that makes it visible to them.
+typedef struct
+{
+    slb_PhysicalDevice physicalDevice;
+    slb_Device*        device;
+    slb_CommandPool*   commandPool;
+    slb_Vector*        batches;        // slb_UploadBatch
+    int                recordingBatch; // -1 when nothing is recorded
+} slb_UploadContext;
+
+slb_UploadContext slb_UploadContext_Create(
+    slb_PhysicalDevice physicalDevice, slb_Device* device,
+    slb_CommandPool* commandPool);
+
+// Waits for every pending upload before freeing them
+void slb_UploadContext_Destroy(slb_UploadContext* context);
+
+// [dstBuffer] is read by later draws as vertices or indices
+void slb_UploadContext_CopyBuffer(slb_UploadContext* context,
+        const void* data, VkDeviceSize size, VkBuffer dstBuffer,
+        VkDeviceSize dstOffset);
+
+// Only the transitions an upload needs are supported
+void slb_UploadContext_TransitionImageLayout(slb_UploadContext* context,
+        VkImage image, VkImageLayout oldLayout, VkImageLayout newLayout);
+
+// Transitions the first [layerCount] layers of an array image
+void slb_UploadContext_TransitionImageLayers(slb_UploadContext* context,
+        VkImage image, uint32_t layerCount, VkImageLayout oldLayout,
+        VkImageLayout newLayout);
+
+// The image must be in VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL
+void slb_UploadContext_CopyToImage(slb_UploadContext* context,
+        const void* data, VkDeviceSize size, VkImage image,
+        uint32_t width, uint32_t height);
+
+// Copies tightly packed [data] into a rectangle of one layer. The
+// image must be in VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL.
+void slb_UploadContext_CopyToImageRegion(slb_UploadContext* context,
+        const void* data, VkDeviceSize size, VkImage image,
+        uint32_t layer, VkOffset2D offset, VkExtent2D extent);
+
+// Fills a freshly created image and leaves it ready for sampling
+void slb_UploadContext_UploadImage(slb_UploadContext* context,
+        const void* data, VkDeviceSize size, VkImage image,
+        uint32_t width, uint32_t height);
+
+// Submits everything recorded so far, without waiting
+void slb_UploadContext_Flush(slb_UploadContext* context);
+
+// Frees the staging memory of finished batches. Returns true once
+// nothing is recorded or in flight.
+bool slb_UploadContext_Poll(slb_UploadContext* context);
+
+// Flushes and blocks until every upload is done
+void slb_UploadContext_Wait(slb_UploadContext* context);
+
 typedef VkSampler slb_Sampler;
 
 slb_Sampler slb_Sampler_Create(VkFilter magFilter, VkFilter minFilter, 
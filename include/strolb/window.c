@@ -3,8 +3,64 @@
 void slb_Window_FramebufferSizeCallback(GLFWwindow* window, int height,
                                         int width)
 {
+    // Maximizing resizes the window before slb_Window_Attach, and the
+    // swapchain is created at the new size anyway
     slb_Window* win = (slb_Window*)(glfwGetWindowUserPointer(window));
-    win->framebufferResized = true;
+    if (win != NULL)
+    {
+        win->framebufferResized = true;
+        win->needsRedraw = true;
+    }
+}
+
+static void slb_Window_MarkRedraw(GLFWwindow* window)
+{
+    slb_Window* win = (slb_Window*)(glfwGetWindowUserPointer(window));
+    if (win != NULL)
+    {
+        win->needsRedraw = true;
+    }
+}
+
+static void slb_Window_KeyCallback(GLFWwindow* window, int key,
+                                   int scancode, int action, int mods)
+{
+    slb_Window_MarkRedraw(window);
+}
+
+static void slb_Window_CharCallback(GLFWwindow* window,
+                                    unsigned int codepoint)
+{
+    slb_Window_MarkRedraw(window);
+}
+
+static void slb_Window_CursorPosCallback(GLFWwindow* window, double x,
+                                         double y)
+{
+    slb_Window_MarkRedraw(window);
+}
+
+static void slb_Window_MouseButtonCallback(GLFWwindow* window,
+                                           int button, int action,
+                                           int mods)
+{
+    slb_Window_MarkRedraw(window);
+}
+
+static void slb_Window_ScrollCallback(GLFWwindow* window, double x,
+                                      double y)
+{
+    slb_Window_MarkRedraw(window);
+}
+
+static void slb_Window_RefreshCallback(GLFWwindow* window)
+{
+    slb_Window_MarkRedraw(window);
+}
+
+static void slb_Window_FocusCallback(GLFWwindow* window, int focused)
+{
+    slb_Window_MarkRedraw(window);
 }
 
 slb_Window slb_Window_Create(const char* title, int16_t width, int16_t height,
@@ -36,19 +92,58 @@ slb_Window slb_Window_Create(const char* title, int16_t width, int16_t height,
     }
 
     glfwMakeContextCurrent(window.window);
-    glfwSetWindowUserPointer(window.window, &window);
+    glfwSetWindowUserPointer(window.window, NULL);
+
+    // Installed before ImGui so its backend chains to them
     glfwSetFramebufferSizeCallback(window.window,
                                    slb_Window_FramebufferSizeCallback);
+    glfwSetKeyCallback(window.window, slb_Window_KeyCallback);
+    glfwSetCharCallback(window.window, slb_Window_CharCallback);
+    glfwSetCursorPosCallback(window.window,
+                             slb_Window_CursorPosCallback);
+    glfwSetMouseButtonCallback(window.window,
+                               slb_Window_MouseButtonCallback);
+    glfwSetScrollCallback(window.window, slb_Window_ScrollCallback);
+    glfwSetWindowRefreshCallback(window.window,
+                                 slb_Window_RefreshCallback);
+    glfwSetWindowFocusCallback(window.window, slb_Window_FocusCallback);
 
     if (maximize)
         glfwMaximizeWindow(window.window);
 
     window.width = width;
     window.height = height;
+    window.framebufferResized = false;
+    window.needsRedraw = true;
 
     return window;
 }
 
+void slb_Window_Attach(slb_Window* window)
+{
+    glfwSetWindowUserPointer(window->window, window);
+}
+
+void slb_Window_WaitEvents(slb_Window* window, double timeout)
+{
+    // GLFW rejects a timeout that isn't positive
+    if (timeout > 0.0)
+    {
+        glfwWaitEventsTimeout(timeout);
+    }
+    else
+    {
+        glfwPollEvents();
+    }
+}
+
+bool slb_Window_ConsumeRedraw(slb_Window* window)
+{
+    bool needsRedraw = window->needsRedraw;
+    window->needsRedraw = false;
+    return needsRedraw;
+}
+
 bool slb_Window_ShouldClose(slb_Window* window)
 {
     return glfwWindowShouldClose(window->window);
@@ -11,12 +11,24 @@ typedef struct
     int16_t            height;
     struct GLFWwindow* window;
     bool               framebufferResized;
+    bool               needsRedraw; // Set by any input or window event
 } slb_Window;
 
 // Initialize a GLFW window and OpenGL context
 slb_Window slb_Window_Create(const char* title, int16_t width, int16_t height,
                          bool fullscreen, bool maximize);
 
+// Points GLFW's callbacks at [window]. slb_Window_Create returns the
+// window by value, so call this once it has reached its final address.
+void slb_Window_Attach(slb_Window* window);
+
+// Sleeps until an event arrives or [timeout] seconds pass. Only
+// polls if [timeout] isn't positive.
+void slb_Window_WaitEvents(slb_Window* window, double timeout);
+
+// Returns whether anything happened since the last call, and clears it
+bool slb_Window_ConsumeRedraw(slb_Window* window);
+
 // Is the window closed or not? Useful for running a game loop
 bool slb_Window_ShouldClose(slb_Window* window);
 
@@ -1,13 +1,16 @@
 #version 450
 
-layout(binding = 0) uniform UniformBufferObject {
-    mat4 model;
+layout(set = 0, binding = 0) uniform Camera {
     mat4 view;
     mat4 proj;
-} ubo;
+} camera;
+
+layout(push_constant) uniform Draw {
+    mat4 model;
+} draw;
 
 layout(location = 0) in vec3 inPosition;
 
 void main() {
-    gl_Position = ubo.proj * ubo.view * ubo.model * vec4(inPosition, 1.0);
+    gl_Position = camera.proj * camera.view * draw.model * vec4(inPosition, 1.0);
 }
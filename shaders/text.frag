@@ -1,11 +1,15 @@
 #version 450
 
-layout(binding = 1) uniform sampler2D texSampler;
-layout(location = 0) in vec2 fragTexCoord;
+layout(set = 1, binding = 0) uniform sampler2DArray texSampler;
+layout(location = 0) in vec3 fragTexCoord;
 layout(location = 0) out vec4 outColor;
 
 void main() 
 {
-    float alpha = texture(texSampler, fragTexCoord).r;
+    // The atlas holds signed distance fields with the outline at 0.5,
+    // so the edge stays about a pixel wide at any zoom
+    float dist = texture(texSampler, fragTexCoord).r;
+    float width = fwidth(dist);
+    float alpha = smoothstep(0.5 - width, 0.5 + width, dist);
     outColor = vec4(1.0, 1.0, 1.0, alpha);
 }
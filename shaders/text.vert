@@ -1,17 +1,20 @@
 #version 450
 
-layout(binding = 0) uniform UniformBufferObject {
-    mat4 model;
+layout(set = 0, binding = 0) uniform Camera {
     mat4 view;
     mat4 proj;
-} ubo;
+} camera;
+
+layout(push_constant) uniform Draw {
+    mat4 model;
+} draw;
 
 layout(location = 0) in vec3 inPosition;
-layout(location = 1) in vec2 inTexCoord;
+layout(location = 1) in vec3 inTexCoord; // z is the atlas page
 
-layout(location = 0) out vec2 fragTexCoord;
+layout(location = 0) out vec3 fragTexCoord;
 
 void main() {
-    gl_Position = ubo.proj * ubo.view * ubo.model * vec4(inPosition, 1.0);
+    gl_Position = camera.proj * camera.view * draw.model * vec4(inPosition, 1.0);
     fragTexCoord = inTexCoord;
 }
@@ -1,14 +1,22 @@
 #version 450
 
-layout(binding = 1) uniform sampler2D texSampler;
+layout(set = 1, binding = 0) uniform sampler2D texSampler;
 
 layout(location = 0) in vec2 fragTexCoord;
+layout(location = 1) flat in uint fragFlags;
 
 layout(location = 0) out vec4 outColor;
 
 void main() 
 {
     outColor = texture(texSampler, fragTexCoord);
+
+    // RenderObjectFlags_Selected
+    if ((fragFlags & 1u) != 0u)
+    {
+        outColor.rgb = mix(outColor.rgb, vec3(1.0, 0.8, 0.3), 0.35);
+    }
+
     outColor.rgb = pow(outColor.rgb, vec3(1.0/2.2));
 
     if (outColor.w < 0.8)
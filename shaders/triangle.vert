@@ -1,17 +1,32 @@
 #version 450
 
-layout(binding = 0) uniform UniformBufferObject {
-    mat4 model;
+layout(set = 0, binding = 0) uniform Camera {
     mat4 view;
     mat4 proj;
-} ubo;
+} camera;
+
+layout(push_constant) uniform Draw {
+    mat4 model;
+} draw;
 
 layout(location = 0) in vec3 inPosition;
 layout(location = 1) in vec2 inTexCoord;
 
+// Per instance
+layout(location = 2) in vec2 inInstancePosition;
+layout(location = 3) in vec2 inInstanceScale;
+layout(location = 4) in uint inInstanceFlags;
+
 layout(location = 0) out vec2 fragTexCoord;
+layout(location = 1) flat out uint fragFlags;
 
 void main() {
-    gl_Position = ubo.proj * ubo.view * ubo.model * vec4(inPosition, 1.0);
+    vec3 worldPosition = vec3(
+        inPosition.x * inInstanceScale.x + inInstancePosition.x,
+        0.0,
+        inPosition.z * inInstanceScale.y + inInstancePosition.y);
+
+    gl_Position = camera.proj * camera.view * draw.model * vec4(worldPosition, 1.0);
     fragTexCoord = inTexCoord;
+    fragFlags = inInstanceFlags;
 }
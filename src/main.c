@@ -1,18 +1,42 @@
 #include <stdio.h>
+#include <float.h>
+#include <limits.h>
+#include <time.h>
 #include <strolb/vulkan.h>
+#include <strolb/texture.h>
+#include <strolb/descriptor.h>
 #include <strolb/camera.h>
 #include <strolb/input.h>
 #include <strolb/imgui.h>
 #include <strolb/json.h>
-#include <stb/stb_image.h>
+#include <strolb/jsonwriter.h>
+#include <strolb/jsontape.h>
+#include <strolb/mappedfile.h>
+#include <strolb/font.h>
+#include <strolb/slotmap.h>
+#include <strolb/stringarena.h>
+#include <strolb/spatialgrid.h>
 #include <cglm/cglm.h>
-#include <ft2build.h>
-#include FT_FREETYPE_H
 
-#define MAX_RENDER_OBJECTS 1000
-#define MAX_TEXT_OBJECTS   100
-#define ATLAS_WIDTH        512
-#define ATLAS_HEIGHT       512
+// Frames drawn after the last event, enough for ImGui to settle and
+// every frame in flight to catch up with the change
+#define REDRAW_FRAMES (SLB_FRAMES_IN_FLIGHT + 1)
+
+// Longest the idle loop sleeps without an event, in seconds
+#define IDLE_TIMEOUT 0.5
+
+// Memory the undo history may hold before its oldest edits go
+#define UNDO_BYTE_LIMIT (16 * 1024 * 1024)
+
+// Typing into the same field within this many seconds of the last
+// change is undone as one edit
+#define UNDO_MERGE_TIME 1.0
+
+// Side of the box grid's cells in world units, a few boxes wide
+#define BOX_GRID_CELL_SIZE 4.0f
+
+// Newest .diagb layout this build reads and the one it writes
+#define DIAGB_VERSION 1
 
 typedef struct
 {
@@ -20,83 +44,236 @@ typedef struct
     vec2 texCoord;
 } Vertex;
 
+// Glyph quad corner, texCoord.z is the atlas page to sample
+typedef struct
+{
+    vec3 pos;
+    vec3 texCoord;
+} TextVertex;
+
+// Scene wide matrices, written once per frame into the global set
+// (set 0) that every pipeline shares
 typedef struct
 {
-    mat4 model;
     mat4 view;
     mat4 proj;
-} UniformBufferObject;
+} CameraUniforms;
 
-// Character info for font atlas
+// Per draw data, pushed instead of living in a uniform buffer
 typedef struct
 {
-    float ax; // advance.x
-    float ay; // advance.y
-
-    float bw; // bitmap.width
-    float bh; // bitmap.rows
-
-    float bl; // bitmap_left
-    float bt; // bitmap_top
+    mat4 model;
+} DrawPushConstants;
 
-    float tx; // x offset in texture atlas
-    float ty; // y offset in texture atlas
-} Character;
+typedef enum
+{
+    RenderObjectFlags_Selected = 1 << 0,
+} RenderObjectFlags;
 
+// A render object is exactly one instance of the box quad, so each
+// box's render object is copied into the instance buffer as is
 typedef struct
 {
-    slb_Image         texture;
-    slb_DescriptorSet descriptorSet;
-    slb_Buffer        vertexBuffer;
-    slb_Buffer        indexBuffer;
-    vec2              position;
-    vec2              scale;
+    vec2     position;
+    vec2     scale;
+    uint32_t flags; // RenderObjectFlags
 } RenderObject;
 
+// Draws every render object from one shared quad. Instance 0 is the
+// cursor, which samples its own texture, and all the dialogue boxes
+// after it go out in a single instanced draw.
 typedef struct
 {
-    char              text[256];
-    vec2              position;
-    vec3              color;
-    float             scale;
-    slb_DescriptorSet descriptorSet;
-    slb_Buffer        vertexBuffer;
-    slb_Buffer        indexBuffer;
-    int               vertexCount;
-} TextObject;
+    slb_Buffer            vertexBuffer;
+    slb_Buffer            indexBuffer;
+    slb_Buffer            instanceBuffers[SLB_FRAMES_IN_FLIGHT];
+    void*                 instanceMaps[SLB_FRAMES_IN_FLIGHT];
+    uint32_t              capacity; // in instances
+    slb_Image             cursorTexture;
+    slb_Image             boxTexture;
+    uint32_t              instanceCount[SLB_FRAMES_IN_FLIGHT];
+    VkDescriptorSet       cursorTextureSet;
+    VkDescriptorSet       boxTextureSet;
+    VkDescriptorSetLayout textureLayout;
+} BoxRenderer;
 
 typedef struct
 {
-    slb_Buffer vertexBuffer;
-    slb_Buffer indexBuffer;
+    slb_StringId text;
+    vec2        position; // Relative to the owner's position, if any
+    vec3        color;
+    float       scale;
+    TextVertex* vertices; // Glyph quads relative to position
+    int         vertexCount;
+    vec2        boundsMin; // Of the glyph quads, relative to position
+    vec2        boundsMax;
+    float       width;           // Advance of the whole line
+    uint32_t    glyphGeneration; // Cache generation the quads are from
+    uint32_t    pageMask;        // Atlas pages the quads sample
+} TextObject;
 
-    uint32_t vertexCount;
-    uint32_t indexCount;
+// All text goes through one host visible vertex buffer, split into a
+// region per frame in flight. Every frame the glyph quads of each line
+// are appended with the box and line positions baked in, and the whole
+// scene's text draws with one vkCmdDraw.
+typedef struct
+{
+    slb_Buffer            vertexBuffer;
+    void*                 vertexMap;
+    uint32_t              capacity; // in vertices, per frame
+    uint32_t              vertexCount[SLB_FRAMES_IN_FLIGHT];
+    VkDescriptorSet       textureSet; // font atlas
+    VkDescriptorSetLayout textureLayout;
+} TextBatcher;
 
+typedef struct
+{
     vec3  color;
     float lineWidth;
 
-    slb_DescriptorSet descriptorSet;
+    slb_Handle firstBox;
+    slb_Handle secondBox;
+} LineObject;
 
-    mat4 transform;
+// Every connection lives in one persistently mapped vertex buffer per
+// frame in flight, two vertices per line, in the order of the line
+// store's dense array. Each frame only rewrites the
+// lines queued in its dirty list, or all of them after a structural
+// change, and then lists the visible lines in the index buffer so all
+// of them draw with a single vkCmdDrawIndexed.
+typedef struct
+{
+    slb_Buffer        vertexBuffers[SLB_FRAMES_IN_FLIGHT];
+    void*             vertexMaps[SLB_FRAMES_IN_FLIGHT];
+    slb_Buffer        indexBuffers[SLB_FRAMES_IN_FLIGHT];
+    void*             indexMaps[SLB_FRAMES_IN_FLIGHT]; // uint32_t
+    uint32_t          indexCount[SLB_FRAMES_IN_FLIGHT];
+    slb_Vector*       dirtyLines[SLB_FRAMES_IN_FLIGHT]; // int
+    bool              rewriteAll[SLB_FRAMES_IN_FLIGHT];
+    uint32_t          capacity; // in lines
+} EdgeBuffer;
+
+// The part of the y = 0 plane the camera can see, in world space
+typedef struct
+{
+    vec2 min;
+    vec2 max;
+} VisibleRect;
 
-    int firstBoxIndex;
-    int secondBoxIndex;
-} LineObject;
+// How many objects the last frame recorded and how many it skipped
+typedef struct
+{
+    uint32_t drawnBoxes;
+    uint32_t culledBoxes;
+    uint32_t drawnText;
+    uint32_t culledText; // Only lines of boxes in view are counted
+    uint32_t drawnEdges;
+    uint32_t culledEdges;
+} CullStats;
 
 // Global font data
-Character characters[128];
-slb_Image fontAtlas;
+slb_GlyphCache glyphCache;
 
+// Every box's text and event and every line of text they are split
+// into, so identical strings are only stored once
+slb_StringArena strings;
+
+// Bounds of every dialogue box by handle, for picking and culling
+// without visiting every box
+slb_SpatialGrid boxGrid;
+
+// A node of the dialogue tree. Boxes live in a slot map and refer to
+// each other by handle, so removing one leaves every other handle,
+// connection and line valid. Edges are indexed from both ends, which
+// lets a box be removed by visiting only its neighbours.
 typedef struct
 {
-    char        text[1024];
-    char        event[1024];
-    slb_Vector* connections; // int
-    int         numTextObjects;
-    int         beginningTextIndex;
+    slb_StringId text;
+    slb_StringId event;
+    slb_Vector*  connections; // slb_Handle of the boxes this leads to
+    slb_Vector*  incoming;    // slb_Handle of the boxes leading here
+    slb_Vector*  lines;       // slb_Handle of lines touching this box
+    slb_Vector*  textObjects; // TextObject, one per line of text
+    RenderObject renderObject;
 } DialogueBox;
 
+// Edits the undo log can replay, each stored as a small delta
+typedef enum
+{
+    EditType_Create,
+    EditType_Delete,
+    EditType_Move,
+    EditType_Connect,
+    EditType_Disconnect,
+    EditType_Text,
+    EditType_Event,
+} EditType;
+
+// Where a box sat in another box's connections, which decide the order
+// choices are saved in
+typedef struct
+{
+    slb_Handle  source;
+    slb_Vector* connections; // slb_Handle, the source's whole list
+} ConnectionOrder;
+
+// A box taken out of the scene whole, text objects and all, so
+// putting it back only has to relink handles
+typedef struct
+{
+    DialogueBox box;
+    bool        stashed;  // Whether [box] is out here or in the scene
+    slb_Vector* outgoing; // slb_Handle, box.connections when stashed
+    slb_Vector* incoming; // slb_Handle, box.incoming when stashed
+    slb_Vector* orders;   // ConnectionOrder of each other source
+} StashedBox;
+
+typedef struct
+{
+    EditType   type;
+    uint32_t   group; // Edits of one group are undone together
+    slb_Handle box;
+    size_t     bytes; // Counted against the log's limit
+    union
+    {
+        StashedBox stash; // Create, Delete
+        struct
+        {
+            slb_Vector* boxes; // slb_Handle, everything that moved
+            vec2        delta;
+        } move; // Move
+        struct
+        {
+            slb_Handle target;
+            int        index; // In the source's connections
+        } connection;         // Connect, Disconnect
+        struct
+        {
+            slb_StringId before;
+            slb_StringId after;
+        } text; // Text, Event
+    };
+} Edit;
+
+// Linear history of edits. Everything before [undoCount] is done and
+// everything after it can be redone until the next new edit. Once the
+// edits take more than [byteLimit] the oldest groups are dropped.
+typedef struct
+{
+    slb_Vector*  edits; // Edit, oldest first
+    size_t       undoCount;
+    size_t       bytes;
+    size_t       byteLimit;
+    uint32_t     nextGroup;
+    uint32_t     openGroup; // Of the edits between Begin/EndUndoGroup
+    int          groupDepth;
+    double       lastTime; // Of the last recorded edit
+    bool         sealed;   // Keeps the next edit from merging
+    slb_SlotMap* dialogueBoxes;
+    slb_SlotMap* lineObjects;
+    EdgeBuffer*  edgeBuffer;
+} UndoLog;
+
 static const Vertex vertices[] = {
     {{-0.5f, 0.0f, -0.5f}, {0.0f, 1.0f}}, // Bottom left
     {{0.5f, 0.0f, -0.5f}, {1.0f, 1.0f}},  // Bottom right
@@ -111,39 +288,14 @@ static const uint16_t indices[] = {
 
 float sensitivity = -0.01f;
 
-void CreateDialogueBox(const char* text, vec2 pos, float textScale,
-                       slb_Vector*             renderObjects,
-                       slb_Vector*             textObjects,
-                       slb_Vector*             dialogueBoxes,
-                       slb_PhysicalDevice      physicalDevice,
-                       slb_Device*             device,
-                       slb_CommandPool*        commandPool,
-                       slb_DescriptorSetLayout descriptorSetLayout,
-                       slb_DescriptorPool      descriptorPool);
-
-void CreateDialogueBoxAtIndex(
-    const char* text, vec2 pos, float textScale,
-    slb_Vector* renderObjects, slb_Vector* textObjects,
-    slb_Vector* dialogueBoxes, int insertIndex,
-    slb_PhysicalDevice physicalDevice, slb_Device* device,
-    slb_CommandPool*        commandPool,
-    slb_DescriptorSetLayout descriptorSetLayout,
-    slb_DescriptorPool      descriptorPool);
-
-void UpdateDialogueBox(int dialogueIndex, slb_Vector* renderObjects,
-                       slb_Vector*             textObjects,
-                       slb_Vector*             dialogueBoxes,
-                       slb_Vector*             lineObjects,
-                       slb_PhysicalDevice      physicalDevice,
-                       slb_Device*             device,
-                       slb_CommandPool*        commandPool,
-                       slb_DescriptorSetLayout descriptorSetLayout,
-                       slb_DescriptorPool      descriptorPool);
-
-void ControlCamera(slb_Camera* camera, slb_Window* window, float dt)
+// Returns whether the camera moved
+bool ControlCamera(slb_Camera* camera, slb_Window* window, float dt)
 {
     float speed = 0.4f * dt;
 
+    vec3 previousPosition;
+    glm_vec3_copy(camera->position, previousPosition);
+
     // Up/down movement (W/S)
     if (slb_Input_GetKey(window, SLB_KEY_W))
     {
@@ -173,1114 +325,3189 @@ void ControlCamera(slb_Camera* camera, slb_Window* window, float dt)
     {
         camera->position[1] += 1.0f * speed;
     }
+
+    return !glm_vec3_eqv(camera->position, previousPosition);
 }
 
-// Initialize FreeType and create font atlas
-int InitializeFreeType(const char* fontPath, int fontSize,
-                       slb_PhysicalDevice physicalDevice,
-                       slb_Device*        device,
-                       slb_CommandPool*   commandPool)
+// Lays out the glyph quads of [textObj]'s line relative to its
+// position, rasterizing glyphs the cache hasn't seen yet. Has to run
+// again whenever the cache's generation moves past the object's.
+void LayoutTextObject(TextObject* textObj)
 {
-    FT_Library ft;
-    if (FT_Init_FreeType(&ft))
-    {
-        fprintf(stderr, "Could not init FreeType Library\n");
-        return -1;
-    }
-
-    FT_Face face;
-    if (FT_New_Face(ft, fontPath, 0, &face))
+    free(textObj->vertices);
+
+    // Never more glyphs than bytes
+    int len = slb_StringArena_GetLength(&strings, textObj->text);
+    textObj->vertices = malloc(len * 6 * sizeof(TextVertex));
+    textObj->vertexCount = 0;
+    textObj->pageMask = 0;
+    textObj->glyphGeneration = glyphCache.generation;
+
+    TextVertex* textVertices = textObj->vertices;
+    float       scale = textObj->scale;
+    float       x = 0.0f;
+
+    // The glyph cache never touches the arena, so this stays valid
+    const char* cursor = slb_StringArena_Get(&strings, textObj->text);
+    while (*cursor != '\0')
     {
-        fprintf(stderr, "Failed to load font\n");
-        return -1;
-    }
-
-    FT_Set_Pixel_Sizes(face, 0, fontSize);
+        slb_Glyph glyph =
+            slb_GlyphCache_Get(&glyphCache, slb_Utf8_Decode(&cursor));
 
-    // Create atlas texture
-    unsigned char* atlasData = calloc(ATLAS_WIDTH * ATLAS_HEIGHT, 1);
-    int            pen_x = 0, pen_y = 0;
-    int            row_height = 0;
-
-    // Load first 128 ASCII characters
-    for (unsigned char c = 0; c < 128; c++)
-    {
-        if (FT_Load_Char(face, c, FT_LOAD_RENDER))
+        if (glyph.page != SLB_GLYPH_NO_PAGE)
         {
-            fprintf(stderr, "Failed to load Glyph\n");
-            continue;
+            float xpos = x + glyph.bl * scale;
+            float ypos = -(glyph.bh - glyph.bt) * scale;
+            float w = glyph.bw * scale;
+            float h = glyph.bh * scale;
+            float page = (float)glyph.page;
+
+            TextVertex* quad = textVertices + textObj->vertexCount;
+
+            // First triangle
+            quad[0] = (TextVertex) {{xpos, 0.0f, ypos + h},
+                                    {glyph.u0, glyph.v0, page}};
+            quad[1] = (TextVertex) {{xpos, 0.0f, ypos},
+                                    {glyph.u0, glyph.v1, page}};
+            quad[2] = (TextVertex) {{xpos + w, 0.0f, ypos},
+                                    {glyph.u1, glyph.v1, page}};
+
+            // Second triangle
+            quad[3] = (TextVertex) {{xpos, 0.0f, ypos + h},
+                                    {glyph.u0, glyph.v0, page}};
+            quad[4] = (TextVertex) {{xpos + w, 0.0f, ypos},
+                                    {glyph.u1, glyph.v1, page}};
+            quad[5] = (TextVertex) {{xpos + w, 0.0f, ypos + h},
+                                    {glyph.u1, glyph.v0, page}};
+
+            textObj->vertexCount += 6;
+            textObj->pageMask |= 1u << glyph.page;
         }
 
-        FT_GlyphSlot g = face->glyph;
+        x += glyph.ax * scale;
+    }
 
-        // If we've run out of room, go to next row
-        if (pen_x + g->bitmap.width >= ATLAS_WIDTH)
-        {
-            pen_x = 0;
-            pen_y += row_height;
-            row_height = 0;
-        }
+    textObj->width = x;
 
-        // Check if we have enough vertical space
-        if (pen_y + g->bitmap.rows >= ATLAS_HEIGHT)
-        {
-            fprintf(stderr, "Font atlas too small\n");
-            break;
-        }
+    glm_vec2_zero(textObj->boundsMin);
+    glm_vec2_zero(textObj->boundsMax);
+
+    for (int v = 0; v < textObj->vertexCount; v++)
+    {
+        vec2 corner = {textVertices[v].pos[0], textVertices[v].pos[2]};
 
-        // Copy glyph bitmap to atlas
-        for (int y = 0; y < g->bitmap.rows; y++)
+        if (v == 0)
         {
-            for (int x = 0; x < g->bitmap.width; x++)
-            {
-                int atlas_x = pen_x + x;
-                int atlas_y = pen_y + y;
-                atlasData[atlas_y * ATLAS_WIDTH + atlas_x] =
-                    g->bitmap.buffer[y * g->bitmap.width + x];
-            }
+            glm_vec2_copy(corner, textObj->boundsMin);
+            glm_vec2_copy(corner, textObj->boundsMax);
         }
 
-        // Store character info
-        characters[c].ax = g->advance.x >> 6;
-        characters[c].ay = g->advance.y >> 6;
-        characters[c].bw = g->bitmap.width;
-        characters[c].bh = g->bitmap.rows;
-        characters[c].bl = g->bitmap_left;
-        characters[c].bt = g->bitmap_top;
-        characters[c].tx = (float)pen_x / ATLAS_WIDTH;
-        characters[c].ty = (float)pen_y / ATLAS_HEIGHT;
-
-        row_height = (g->bitmap.rows > row_height) ? g->bitmap.rows
-                                                   : row_height;
-        pen_x += g->bitmap.width + 20; // padding
-    }
-
-    // Create Vulkan texture from atlas
-    VkDeviceSize imageSize = ATLAS_WIDTH * ATLAS_HEIGHT;
-
-    slb_Buffer stagingBuffer =
-        slb_Buffer_Create(imageSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-                          VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
-                              VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-                          physicalDevice, device);
-
-    void* data;
-    vkMapMemory(device->device, stagingBuffer.memory, 0, imageSize, 0,
-                &data);
-    memcpy(data, atlasData, (size_t)imageSize);
-    vkUnmapMemory(device->device, stagingBuffer.memory);
-
-    fontAtlas = slb_Image_Create(
-        device, physicalDevice, ATLAS_WIDTH, ATLAS_HEIGHT,
-        VK_FORMAT_R8_UNORM, VK_IMAGE_TILING_OPTIMAL,
-        VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
-        VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
-
-    // Transition image layout for transfer
-    slb_TransitionImageLayout(fontAtlas.image, VK_FORMAT_R8_UNORM,
-                              VK_IMAGE_LAYOUT_UNDEFINED,
-                              VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-                              device, commandPool);
-
-    // Copy buffer to image
-    slb_CopyBufferToImage(stagingBuffer.buffer, fontAtlas.image,
-                          ATLAS_WIDTH, ATLAS_HEIGHT, device,
-                          commandPool);
-
-    // Transition image layout for shader access
-    slb_TransitionImageLayout(
-        fontAtlas.image, VK_FORMAT_R8_UNORM,
-        VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-        VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, device,
-        commandPool);
-
-    // Create image view
-    fontAtlas.imageView = slb_ImageView_Create(
-        device, fontAtlas.image, VK_FORMAT_R8_UNORM,
-        VK_IMAGE_ASPECT_COLOR_BIT);
-
-    fontAtlas.sampler = slb_Sampler_Create(
-        VK_FILTER_LINEAR, VK_FILTER_LINEAR, false, 1.0f, false, false,
-        VK_COMPARE_OP_ALWAYS, VK_SAMPLER_MIPMAP_MODE_LINEAR, device);
-
-    // Clean up
-    vkDestroyBuffer(device->device, stagingBuffer.buffer, NULL);
-    vkFreeMemory(device->device, stagingBuffer.memory, NULL);
-    free(atlasData);
-    FT_Done_Face(face);
-    FT_Done_FreeType(ft);
-
-    return 0;
+        glm_vec2_minv(textObj->boundsMin, corner, textObj->boundsMin);
+        glm_vec2_maxv(textObj->boundsMax, corner, textObj->boundsMax);
+    }
 }
 
-TextObject CreateTextObject(const char* text, vec2 position,
-                            vec3 color, float scale,
-                            slb_PhysicalDevice      physicalDevice,
-                            slb_Device*             device,
-                            slb_CommandPool*        commandPool,
-                            slb_DescriptorSetLayout layout,
-                            slb_DescriptorPool      pool)
+// Lays out the glyph quads of one line relative to [position]. Nothing
+// is uploaded here, the text batcher copies the quads every frame.
+// Takes over the reference to [text].
+TextObject CreateTextObject(slb_StringId text, vec2 position,
+                            vec3 color, float scale)
 {
     TextObject textObj = {0};
-    strcpy(textObj.text, text);
+    textObj.text = text;
     glm_vec2_copy(position, textObj.position);
     glm_vec3_copy(color, textObj.color);
     textObj.scale = scale;
 
-    // Generate vertex data for text
-    float x = 0.0f;
-    int   len = strlen(text);
-    textObj.vertexCount =
-        len * 6; // 6 vertices per character (2 triangles)
-
-    Vertex* textVertices =
-        malloc(textObj.vertexCount * sizeof(Vertex));
-
-    for (int i = 0; i < len; i++)
-    {
-        char      c = text[i];
-        Character ch = characters[(int)c];
-
-        float xpos = x + ch.bl * scale;
-        float ypos = -(ch.bh - ch.bt) * scale;
-        float w = ch.bw * scale;
-        float h = ch.bh * scale;
+    LayoutTextObject(&textObj);
 
-        // Texture coordinates
-        float tx = ch.tx;
-        float ty = ch.ty;
-        float tw = ch.bw / (float)ATLAS_WIDTH;
-        float th = ch.bh / (float)ATLAS_HEIGHT;
-
-        // First triangle
-        textVertices[i * 6 + 0] =
-            (Vertex) {{xpos, 0.0f, ypos + h}, {tx, ty}};
-        textVertices[i * 6 + 1] =
-            (Vertex) {{xpos, 0.0f, ypos}, {tx, ty + th}};
-        textVertices[i * 6 + 2] =
-            (Vertex) {{xpos + w, 0.0f, ypos}, {tx + tw, ty + th}};
-
-        // Second triangle
-        textVertices[i * 6 + 3] =
-            (Vertex) {{xpos, 0.0f, ypos + h}, {tx, ty}};
-        textVertices[i * 6 + 4] =
-            (Vertex) {{xpos + w, 0.0f, ypos}, {tx + tw, ty + th}};
-        textVertices[i * 6 + 5] =
-            (Vertex) {{xpos + w, 0.0f, ypos + h}, {tx + tw, ty}};
-
-        x += ch.ax * scale;
-    }
-
-    // Create vertex buffer
-    VkDeviceSize bufferSize = textObj.vertexCount * sizeof(Vertex);
+    return textObj;
+}
 
-    slb_Buffer stagingBuffer = slb_Buffer_Create(
-        bufferSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
-            VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-        physicalDevice, device);
+// Creates a device local buffer and records the upload of [size]
+// bytes into it
+slb_Buffer CreateDeviceLocalBuffer(const void* data, VkDeviceSize size,
+                                   VkBufferUsageFlags usage,
+                                   slb_PhysicalDevice physicalDevice,
+                                   slb_Device*        device,
+                                   slb_UploadContext* uploadContext)
+{
+    slb_Buffer buffer = slb_Buffer_Create(
+        size, VK_BUFFER_USAGE_TRANSFER_DST_BIT | usage,
+        VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, physicalDevice, device);
 
-    void* data;
-    vkMapMemory(device->device, stagingBuffer.memory, 0, bufferSize,
-                0, &data);
-    memcpy(data, textVertices, (size_t)bufferSize);
-    vkUnmapMemory(device->device, stagingBuffer.memory);
+    slb_UploadContext_CopyBuffer(uploadContext, data, size,
+                                 buffer.buffer, 0);
 
-    textObj.vertexBuffer = slb_Buffer_Create(
-        bufferSize,
-        VK_BUFFER_USAGE_TRANSFER_DST_BIT |
-            VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
-        VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, physicalDevice, device);
+    return buffer;
+}
 
-    slb_CopyBuffer(stagingBuffer.buffer, textObj.vertexBuffer.buffer,
-                   bufferSize, device, commandPool);
+// Creates the global set (set 0): one camera uniform buffer and
+// descriptor set per frame in flight
+slb_DescriptorSet CreateCameraDescriptorSet(
+    slb_PhysicalDevice physicalDevice, slb_Device* device,
+    slb_DescriptorSetLayout  layout,
+    slb_DescriptorAllocator* descriptorAllocator)
+{
+    slb_DescriptorSet descriptorSet = {0};
 
-    vkDestroyBuffer(device->device, stagingBuffer.buffer, NULL);
-    vkFreeMemory(device->device, stagingBuffer.memory, NULL);
+    // CREATE UNIFORM BUFFERS
 
-    // Create uniform buffers
-    VkDeviceSize uniformBufferSize = sizeof(UniformBufferObject);
+    VkDeviceSize bufferSize = sizeof(CameraUniforms);
 
     for (size_t i = 0; i < SLB_FRAMES_IN_FLIGHT; i++)
     {
-        textObj.descriptorSet.buffers[i] = slb_Buffer_Create(
-            uniformBufferSize, VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
+        descriptorSet.buffers[i] = slb_Buffer_Create(
+            bufferSize, VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
             VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
                 VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
             physicalDevice, device);
 
-        vkMapMemory(device->device,
-                    textObj.descriptorSet.buffers[i].memory, 0,
-                    uniformBufferSize, 0,
-                    &textObj.descriptorSet.buffersMap[i]);
-    }
-
-    // Create descriptor sets
-    VkDescriptorSetLayout layouts[SLB_FRAMES_IN_FLIGHT];
-    for (int i = 0; i < SLB_FRAMES_IN_FLIGHT; i++)
-    {
-        layouts[i] = layout;
+        descriptorSet.buffersMap[i] =
+            descriptorSet.buffers[i].allocation.mapped;
     }
 
-    VkDescriptorSetAllocateInfo allocInfo = {0};
-    allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
-    allocInfo.descriptorPool = pool;
-    allocInfo.descriptorSetCount = SLB_FRAMES_IN_FLIGHT;
-    allocInfo.pSetLayouts = layouts;
-
-    if (vkAllocateDescriptorSets(
-            device->device, &allocInfo,
-            textObj.descriptorSet.descriptorSets) != VK_SUCCESS)
-    {
-        slb_Error("Failed to allocate text descriptor sets",
-                  slb_ErrorType_Error);
-    }
+    // CREATE DESCRIPTOR SETS
 
     for (size_t i = 0; i < SLB_FRAMES_IN_FLIGHT; i++)
     {
+        descriptorSet.descriptorSets[i] =
+            slb_DescriptorAllocator_Allocate(descriptorAllocator,
+                                             layout);
+
         VkDescriptorBufferInfo bufferInfo = {0};
-        bufferInfo.buffer = textObj.descriptorSet.buffers[i].buffer;
+        bufferInfo.buffer = descriptorSet.buffers[i].buffer;
         bufferInfo.offset = 0;
-        bufferInfo.range = sizeof(UniformBufferObject);
-
-        VkDescriptorImageInfo imageInfo = {0};
-        imageInfo.imageLayout =
-            VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-        imageInfo.imageView = fontAtlas.imageView;
-        imageInfo.sampler = fontAtlas.sampler;
-
-        VkWriteDescriptorSet descriptorWrites[2] = {0};
-
-        descriptorWrites[0].sType =
-            VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-        descriptorWrites[0].dstSet =
-            textObj.descriptorSet.descriptorSets[i];
-        descriptorWrites[0].dstBinding = 0;
-        descriptorWrites[0].dstArrayElement = 0;
-        descriptorWrites[0].descriptorType =
+        bufferInfo.range = sizeof(CameraUniforms);
+
+        VkWriteDescriptorSet descriptorWrite = {0};
+        descriptorWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        descriptorWrite.dstSet = descriptorSet.descriptorSets[i];
+        descriptorWrite.dstBinding = 0;
+        descriptorWrite.dstArrayElement = 0;
+        descriptorWrite.descriptorType =
             VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-        descriptorWrites[0].descriptorCount = 1;
-        descriptorWrites[0].pBufferInfo = &bufferInfo;
-
-        descriptorWrites[1].sType =
-            VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-        descriptorWrites[1].dstSet =
-            textObj.descriptorSet.descriptorSets[i];
-        descriptorWrites[1].dstBinding = 1;
-        descriptorWrites[1].dstArrayElement = 0;
-        descriptorWrites[1].descriptorType =
-            VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-        descriptorWrites[1].descriptorCount = 1;
-        descriptorWrites[1].pImageInfo = &imageInfo;
-
-        vkUpdateDescriptorSets(device->device, 2, descriptorWrites, 0,
+        descriptorWrite.descriptorCount = 1;
+        descriptorWrite.pBufferInfo = &bufferInfo;
+
+        vkUpdateDescriptorSets(device->device, 1, &descriptorWrite, 0,
                                NULL);
     }
 
-    free(textVertices);
-    return textObj;
+    return descriptorSet;
 }
 
-RenderObject CreateRenderObject(const char* texturePath,
-                                vec2 position, vec2 scale,
-                                slb_PhysicalDevice physicalDevice,
-                                slb_Device*        device,
-                                slb_CommandPool*   commandPool,
-                                slb_DescriptorSetLayout layout,
-                                slb_DescriptorPool      pool)
+void DestroyCameraDescriptorSet(
+    slb_DescriptorSet* descriptorSet, slb_Device* device,
+    slb_DescriptorSetLayout  layout,
+    slb_DescriptorAllocator* descriptorAllocator)
 {
-    RenderObject renderObject;
-    glm_vec2_copy(position, renderObject.position);
-    glm_vec2_copy(scale, renderObject.scale);
-
-    VkDeviceSize vertexBufferSize = sizeof(vertices);
-
-    slb_Buffer stagingVertexBuffer = slb_Buffer_Create(
-        vertexBufferSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
-            VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-        physicalDevice, device);
-
-    void* data;
-    vkMapMemory(device->device, stagingVertexBuffer.memory, 0,
-                vertexBufferSize, 0, &data);
-    memcpy(data, vertices, (size_t)vertexBufferSize);
-    vkUnmapMemory(device->device, stagingVertexBuffer.memory);
-
-    renderObject.vertexBuffer = slb_Buffer_Create(
-        vertexBufferSize,
-        VK_BUFFER_USAGE_TRANSFER_DST_BIT |
-            VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
-        VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, physicalDevice, device);
-
-    slb_CopyBuffer(stagingVertexBuffer.buffer,
-                   renderObject.vertexBuffer.buffer, vertexBufferSize,
-                   device, commandPool);
-
-    vkDestroyBuffer(device->device, stagingVertexBuffer.buffer, NULL);
-    vkFreeMemory(device->device, stagingVertexBuffer.memory, NULL);
-
-    VkDeviceSize indexBufferSize = sizeof(indices);
-
-    slb_Buffer stagingIndexBuffer = slb_Buffer_Create(
-        indexBufferSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
-            VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-        physicalDevice, device);
-
-    void* indexData;
-    vkMapMemory(device->device, stagingIndexBuffer.memory, 0,
-                indexBufferSize, 0, &indexData);
-    memcpy(indexData, indices, (size_t)indexBufferSize);
-    vkUnmapMemory(device->device, stagingIndexBuffer.memory);
-
-    renderObject.indexBuffer = slb_Buffer_Create(
-        indexBufferSize,
-        VK_BUFFER_USAGE_TRANSFER_DST_BIT |
-            VK_BUFFER_USAGE_INDEX_BUFFER_BIT,
-        VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, physicalDevice, device);
-
-    slb_CopyBuffer(stagingIndexBuffer.buffer,
-                   renderObject.indexBuffer.buffer, indexBufferSize,
-                   device, commandPool);
-
-    vkDestroyBuffer(device->device, stagingIndexBuffer.buffer, NULL);
-    vkFreeMemory(device->device, stagingIndexBuffer.memory, NULL);
-
-    // CREATE TEXTURE
-
-    int      texWidth, texHeight, texChannels;
-    stbi_uc* pixels = stbi_load(texturePath, &texWidth, &texHeight,
-                                &texChannels, STBI_rgb_alpha);
-
-    VkDeviceSize imageSize = texWidth * texHeight * 4; // RGBA
-
-    slb_Buffer stagingBuffer =
-        slb_Buffer_Create(imageSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-                          VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
-                              VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-                          physicalDevice, device);
+    for (size_t j = 0; j < SLB_FRAMES_IN_FLIGHT; j++)
+    {
+        slb_Buffer_Destroy(&descriptorSet->buffers[j], device);
+        slb_DescriptorAllocator_Free(descriptorAllocator, layout,
+                                     descriptorSet->descriptorSets[j]);
+    }
+}
 
-    void* textureData;
-    vkMapMemory(device->device, stagingBuffer.memory, 0, imageSize, 0,
-                &textureData);
-    memcpy(textureData, pixels, (size_t)imageSize);
-    vkUnmapMemory(device->device, stagingBuffer.memory);
+// Creates a texture set (set 1) that samples [texture]. Textures never
+// change between frames, so one set serves every frame in flight.
+VkDescriptorSet CreateTextureDescriptorSet(
+    slb_Image* texture, slb_Device* device,
+    slb_DescriptorSetLayout  layout,
+    slb_DescriptorAllocator* descriptorAllocator)
+{
+    VkDescriptorSet descriptorSet =
+        slb_DescriptorAllocator_Allocate(descriptorAllocator, layout);
+
+    VkDescriptorImageInfo imageInfo = {0};
+    imageInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+    imageInfo.imageView = texture->imageView;
+    imageInfo.sampler = texture->sampler;
+
+    VkWriteDescriptorSet descriptorWrite = {0};
+    descriptorWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+    descriptorWrite.dstSet = descriptorSet;
+    descriptorWrite.dstBinding = 0;
+    descriptorWrite.dstArrayElement = 0;
+    descriptorWrite.descriptorType =
+        VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    descriptorWrite.descriptorCount = 1;
+    descriptorWrite.pImageInfo = &imageInfo;
 
-    renderObject.texture = slb_Image_Create(
-        device, physicalDevice, texWidth, texHeight,
-        VK_FORMAT_R8G8B8A8_SRGB, VK_IMAGE_TILING_OPTIMAL,
-        VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
-        VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+    vkUpdateDescriptorSets(device->device, 1, &descriptorWrite, 0,
+                           NULL);
 
-    // Transition image layout for transfer
-    slb_TransitionImageLayout(
-        renderObject.texture.image, VK_FORMAT_R8G8B8A8_SRGB,
-        VK_IMAGE_LAYOUT_UNDEFINED,
-        VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, device, commandPool);
-
-    // Copy buffer to image
-    slb_CopyBufferToImage(stagingBuffer.buffer,
-                          renderObject.texture.image, texWidth,
-                          texHeight, device, commandPool);
-
-    // Transition image layout for shader access
-    slb_TransitionImageLayout(
-        renderObject.texture.image, VK_FORMAT_R8G8B8A8_SRGB,
-        VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-        VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, device,
-        commandPool);
-
-    // Create image view
-    renderObject.texture.imageView = slb_ImageView_Create(
-        device, renderObject.texture.image, VK_FORMAT_R8G8B8A8_SRGB,
-        VK_IMAGE_ASPECT_COLOR_BIT);
-
-    renderObject.texture.sampler = slb_Sampler_Create(
-        VK_FILTER_NEAREST, VK_FILTER_NEAREST, false, 1.0f, false,
-        false, VK_COMPARE_OP_ALWAYS, VK_SAMPLER_MIPMAP_MODE_NEAREST,
-        device);
-
-    // Clean up staging buffer
-    vkDestroyBuffer(device->device, stagingBuffer.buffer, NULL);
-    vkFreeMemory(device->device, stagingBuffer.memory, NULL);
+    return descriptorSet;
+}
 
-    // CREATE UNIFORM BUFFERS
+// Intersects the rays through the four screen corners with the y = 0
+// plane. If any of them misses the plane the view reaches the horizon
+// and nothing is culled.
+void ComputeVisibleRect(mat4 view, mat4 proj, VisibleRect* rect)
+{
+    mat4 viewProj;
+    mat4 inverseViewProj;
+    glm_mat4_mul(proj, view, viewProj);
+    glm_mat4_inv(viewProj, inverseViewProj);
 
-    VkDeviceSize bufferSize = sizeof(UniformBufferObject);
+    glm_vec2_fill(rect->min, FLT_MAX);
+    glm_vec2_fill(rect->max, -FLT_MAX);
 
-    for (size_t i = 0; i < SLB_FRAMES_IN_FLIGHT; i++)
+    for (int i = 0; i < 4; i++)
     {
-        renderObject.descriptorSet.buffers[i] = slb_Buffer_Create(
-            bufferSize, VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
-            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
-                VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-            physicalDevice, device);
-
-        vkMapMemory(device->device,
-                    renderObject.descriptorSet.buffers[i].memory, 0,
-                    bufferSize, 0,
-                    &renderObject.descriptorSet.buffersMap[i]);
-    }
+        float ndcX = (i & 1) ? 1.0f : -1.0f;
+        float ndcY = (i & 2) ? 1.0f : -1.0f;
 
-    // CREATE DESCRIPTOR SETS
+        vec4 nearPoint = {ndcX, ndcY, 0.0f, 1.0f};
+        vec4 farPoint = {ndcX, ndcY, 1.0f, 1.0f};
+        glm_mat4_mulv(inverseViewProj, nearPoint, nearPoint);
+        glm_mat4_mulv(inverseViewProj, farPoint, farPoint);
+        glm_vec4_scale(nearPoint, 1.0f / nearPoint[3], nearPoint);
+        glm_vec4_scale(farPoint, 1.0f / farPoint[3], farPoint);
 
-    VkDescriptorSetLayout layouts[SLB_FRAMES_IN_FLIGHT];
-    for (int i = 0; i < SLB_FRAMES_IN_FLIGHT; i++)
-    {
-        layouts[i] = layout;
-    }
+        float dy = farPoint[1] - nearPoint[1];
+        float t = dy != 0.0f ? -nearPoint[1] / dy : -1.0f;
 
-    VkDescriptorSetAllocateInfo allocInfo = {0};
-    allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
-    allocInfo.descriptorPool = pool;
-    allocInfo.descriptorSetCount = SLB_FRAMES_IN_FLIGHT;
-    allocInfo.pSetLayouts = layouts;
+        if (t < 0.0f)
+        {
+            glm_vec2_fill(rect->min, -FLT_MAX);
+            glm_vec2_fill(rect->max, FLT_MAX);
+            return;
+        }
 
-    if (vkAllocateDescriptorSets(
-            device->device, &allocInfo,
-            renderObject.descriptorSet.descriptorSets) != VK_SUCCESS)
-    {
-        slb_Error("Failed to allocate descriptor sets",
-                  slb_ErrorType_Error);
-    }
+        float x = nearPoint[0] + t * (farPoint[0] - nearPoint[0]);
+        float z = nearPoint[2] + t * (farPoint[2] - nearPoint[2]);
 
-    for (size_t i = 0; i < SLB_FRAMES_IN_FLIGHT; i++)
-    {
-        VkDescriptorBufferInfo bufferInfo = {0};
-        bufferInfo.buffer =
-            renderObject.descriptorSet.buffers[i].buffer;
-        bufferInfo.offset = 0;
-        bufferInfo.range = sizeof(UniformBufferObject);
-
-        VkDescriptorImageInfo imageInfo = {0};
-        imageInfo.imageLayout =
-            VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-        imageInfo.imageView = renderObject.texture.imageView;
-        imageInfo.sampler = renderObject.texture.sampler;
-
-        VkWriteDescriptorSet descriptorWrites[2] = {0};
-
-        descriptorWrites[0].sType =
-            VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-        descriptorWrites[0].dstSet =
-            renderObject.descriptorSet.descriptorSets[i];
-        descriptorWrites[0].dstBinding = 0;
-        descriptorWrites[0].dstArrayElement = 0;
-        descriptorWrites[0].descriptorType =
-            VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-        descriptorWrites[0].descriptorCount = 1;
-        descriptorWrites[0].pBufferInfo = &bufferInfo;
-
-        descriptorWrites[1].sType =
-            VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-        descriptorWrites[1].dstSet =
-            renderObject.descriptorSet.descriptorSets[i];
-        descriptorWrites[1].dstBinding = 1;
-        descriptorWrites[1].dstArrayElement = 0;
-        descriptorWrites[1].descriptorType =
-            VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-        descriptorWrites[1].descriptorCount = 1;
-        descriptorWrites[1].pImageInfo = &imageInfo;
-
-        vkUpdateDescriptorSets(device->device, 2, descriptorWrites, 0,
-                               NULL);
+        rect->min[0] = glm_min(rect->min[0], x);
+        rect->min[1] = glm_min(rect->min[1], z);
+        rect->max[0] = glm_max(rect->max[0], x);
+        rect->max[1] = glm_max(rect->max[1], z);
     }
+}
 
-    return renderObject;
+bool RectOverlaps(VisibleRect* rect, vec2 min, vec2 max)
+{
+    return min[0] <= rect->max[0] && max[0] >= rect->min[0] &&
+           min[1] <= rect->max[1] && max[1] >= rect->min[1];
 }
 
-void DestroyTextObject(TextObject* textObj, slb_Device* device)
+int CompareIndices(const void* a, const void* b)
 {
-    vkDestroyBuffer(device->device, textObj->vertexBuffer.buffer,
-                    NULL);
-    vkFreeMemory(device->device, textObj->vertexBuffer.memory, NULL);
+    uint32_t left = *(const uint32_t*)a;
+    uint32_t right = *(const uint32_t*)b;
 
-    for (size_t j = 0; j < SLB_FRAMES_IN_FLIGHT; j++)
-    {
-        vkUnmapMemory(device->device,
-                      textObj->descriptorSet.buffers[j].memory);
-        vkDestroyBuffer(device->device,
-                        textObj->descriptorSet.buffers[j].buffer,
-                        NULL);
-        vkFreeMemory(device->device,
-                     textObj->descriptorSet.buffers[j].memory, NULL);
-    }
+    return (left > right) - (left < right);
 }
 
-int currentDialogueBox = -1;
-
-void DestroyRenderObject(RenderObject* obj, slb_Device* device)
+// Fills [indices] with the dense indices of the boxes overlapping
+// [rect], in dense order so boxes keep drawing in the same order.
+// [scratch] holds the handles the grid returns.
+void GetVisibleBoxes(slb_SlotMap* dialogueBoxes, VisibleRect* rect,
+                     slb_Vector* scratch, slb_Vector* indices)
 {
-    vkDestroyBuffer(device->device, obj->vertexBuffer.buffer, NULL);
-    vkFreeMemory(device->device, obj->vertexBuffer.memory, NULL);
-    vkDestroyBuffer(device->device, obj->indexBuffer.buffer, NULL);
-    vkFreeMemory(device->device, obj->indexBuffer.memory, NULL);
+    slb_Vector_Clear(scratch);
+    slb_Vector_Clear(indices);
+    slb_SpatialGrid_QueryRect(&boxGrid, rect->min, rect->max, scratch);
 
-    vkDestroyImageView(device->device, obj->texture.imageView, NULL);
-    vkDestroySampler(device->device, obj->texture.sampler, NULL);
-    vkDestroyImage(device->device, obj->texture.image, NULL);
-    vkFreeMemory(device->device, obj->texture.memory, NULL);
-
-    for (size_t j = 0; j < SLB_FRAMES_IN_FLIGHT; j++)
+    slb_Vector_Reserve(indices, scratch->size);
+    for (size_t i = 0; i < scratch->size; i++)
     {
-        vkUnmapMemory(device->device,
-                      obj->descriptorSet.buffers[j].memory);
-        vkDestroyBuffer(device->device,
-                        obj->descriptorSet.buffers[j].buffer, NULL);
-        vkFreeMemory(device->device,
-                     obj->descriptorSet.buffers[j].memory, NULL);
+        slb_Handle handle = SLB_VECTOR_AT(scratch, slb_Handle, i);
+        uint32_t   index =
+            (uint32_t)slb_SlotMap_IndexOf(dialogueBoxes, handle);
+        slb_Vector_PushBack(indices, &index);
     }
+
+    qsort(indices->data, indices->size, sizeof(uint32_t),
+          CompareIndices);
 }
 
-void CreateDialogueBoxAtIndex(
-    const char* textOriginal, vec2 pos, float textScale,
-    slb_Vector* renderObjects, slb_Vector* textObjects,
-    slb_Vector* dialogueBoxes, int insertIndex,
-    slb_PhysicalDevice physicalDevice, slb_Device* device,
-    slb_CommandPool*        commandPool,
-    slb_DescriptorSetLayout descriptorSetLayout,
-    slb_DescriptorPool      descriptorPool)
-{
-    char text[1024];
-
-    char buffer[1024];
-    strcpy(buffer, textOriginal);
-    
-    // Count lines and store pointers
-    char* lines[100];
-    int line_count = 0;
-    
-    char* token = strtok(buffer, "\n");
-    while (token != NULL && line_count < 100) {
-        lines[line_count++] = token;
-        token = strtok(NULL, "\n");
-    }
-    
-    // Build reversed string
-    text[0] = '\0';
-    for (int i = line_count - 1; i >= 0; i--) {
-        strcat(text, lines[i]);
-        if (i > 0) {
-            strcat(text, "\n");
-        }
-    }
+// Liang-Barsky clip of the segment [a, b] against the rectangle
+bool SegmentIntersectsRect(VisibleRect* rect, vec2 a, vec2 b)
+{
+    float dx = b[0] - a[0];
+    float dy = b[1] - a[1];
 
-    DialogueBox box = {};
-    strcpy(box.text, textOriginal);
+    float p[4] = {-dx, dx, -dy, dy};
+    float q[4] = {a[0] - rect->min[0], rect->max[0] - a[0],
+                  a[1] - rect->min[1], rect->max[1] - a[1]};
 
-    // Calculate box dimensions (same as before)
-    const char* delimiter = "\n";
-    char*       textCopy = strdup(text);
-    char*       line = strtok(textCopy, delimiter);
-    int         lineCount = 0;
-    float       maxLineWidth = 0.0f;
+    float t0 = 0.0f;
+    float t1 = 1.0f;
 
-    while (line != NULL)
+    for (int i = 0; i < 4; i++)
     {
-        lineCount++;
-        float lineWidth = 0.0f;
-        for (int i = 0; i < strlen(line); i++)
+        if (p[i] == 0.0f)
+        {
+            // Parallel to this edge, and outside of it
+            if (q[i] < 0.0f)
+            {
+                return false;
+            }
+            continue;
+        }
+
+        float r = q[i] / p[i];
+
+        if (p[i] < 0.0f)
         {
-            Character ch = characters[(int)line[i]];
-            lineWidth += ch.ax * textScale;
+            if (r > t1)
+            {
+                return false;
+            }
+            t0 = glm_max(t0, r);
         }
-        if (lineWidth > maxLineWidth)
+        else
         {
-            maxLineWidth = lineWidth;
+            if (r < t0)
+            {
+                return false;
+            }
+            t1 = glm_min(t1, r);
         }
-        line = strtok(NULL, delimiter);
     }
-    free(textCopy);
 
-    const float padding = 0.4f;
-    float       boxWidth = maxLineWidth + 2 * padding;
-    float       boxHeight =
-        (characters['A'].bh * textScale * lineCount) + 2 * padding;
+    return true;
+}
 
-    RenderObject boxObj = CreateRenderObject(
-        "res/textures/grey.png", (vec2) {pos[0], pos[1]},
-        (vec2) {boxWidth, boxHeight}, physicalDevice, device,
-        commandPool, descriptorSetLayout, descriptorPool);
+RenderObject CreateRenderObject(vec2 position, vec2 scale)
+{
+    RenderObject renderObject = {0};
+    glm_vec2_copy(position, renderObject.position);
+    glm_vec2_copy(scale, renderObject.scale);
 
-    slb_Vector_Insert(renderObjects, insertIndex + 1, &boxObj);
+    return renderObject;
+}
 
-    textCopy = strdup(text);
-    line = strtok(textCopy, delimiter);
-    float yOffset = padding;
-    int   textInsertIndex = 0;
+void CreateBoxInstanceBuffers(BoxRenderer* renderer, uint32_t capacity,
+                              slb_PhysicalDevice physicalDevice,
+                              slb_Device*        device)
+{
+    VkDeviceSize bufferSize = capacity * sizeof(RenderObject);
 
-    // Calculate where to insert text objects
-    for (int i = 0; i < insertIndex; i++)
+    for (size_t i = 0; i < SLB_FRAMES_IN_FLIGHT; i++)
     {
-        DialogueBox* prevBox = slb_Vector_Get(dialogueBoxes, i);
-        textInsertIndex += prevBox->numTextObjects;
-    }
+        renderer->instanceBuffers[i] = slb_Buffer_Create(
+            bufferSize, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
+            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
+                VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+            physicalDevice, device);
 
-    printf("InsertIndex: %d\n", insertIndex);
+        renderer->instanceMaps[i] =
+            renderer->instanceBuffers[i].allocation.mapped;
+    }
 
-    box.beginningTextIndex = textInsertIndex;
-    box.numTextObjects = lineCount;
+    renderer->capacity = capacity;
+}
 
-    for (int i = 0; i < lineCount; i++)
+void DestroyBoxInstanceBuffers(BoxRenderer* renderer,
+                               slb_Device*  device)
+{
+    for (size_t i = 0; i < SLB_FRAMES_IN_FLIGHT; i++)
     {
-        vec2 textPos = {pos[0] - boxWidth / 2 + padding,
-                        pos[1] - boxHeight / 2 + yOffset};
-
-        TextObject textObj = CreateTextObject(
-            line, textPos, (vec3) {0.0f, 0.0f, 0.0f}, textScale,
-            physicalDevice, device, commandPool, descriptorSetLayout,
-            descriptorPool);
+        slb_Buffer_Destroy(&renderer->instanceBuffers[i], device);
+    }
+}
 
-        slb_Vector_Insert(textObjects, textInsertIndex + i, &textObj);
+BoxRenderer CreateBoxRenderer(
+    uint32_t                 initialCapacity,
+    slb_TextureCache*        textureCache,
+    slb_PhysicalDevice       physicalDevice,
+    slb_Device*              device,
+    slb_UploadContext*       uploadContext,
+    slb_DescriptorSetLayout  textureLayout,
+    slb_DescriptorAllocator* descriptorAllocator)
+{
+    BoxRenderer renderer = {0};
+    renderer.textureLayout = textureLayout;
+
+    renderer.vertexBuffer = CreateDeviceLocalBuffer(
+        vertices, sizeof(vertices), VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
+        physicalDevice, device, uploadContext);
+    renderer.indexBuffer = CreateDeviceLocalBuffer(
+        indices, sizeof(indices), VK_BUFFER_USAGE_INDEX_BUFFER_BIT,
+        physicalDevice, device, uploadContext);
+
+    CreateBoxInstanceBuffers(&renderer, initialCapacity,
+                             physicalDevice, device);
+
+    renderer.cursorTexture = slb_TextureCache_Acquire(
+        textureCache, "res/textures/cursor.png", VK_FILTER_NEAREST);
+    renderer.boxTexture = slb_TextureCache_Acquire(
+        textureCache, "res/textures/grey.png", VK_FILTER_NEAREST);
+
+    renderer.cursorTextureSet =
+        CreateTextureDescriptorSet(&renderer.cursorTexture, device,
+                                   textureLayout, descriptorAllocator);
+    renderer.boxTextureSet =
+        CreateTextureDescriptorSet(&renderer.boxTexture, device,
+                                   textureLayout, descriptorAllocator);
+
+    return renderer;
+}
 
-        yOffset += characters['A'].bh * textScale * 1.2f;
-        line = strtok(NULL, delimiter);
-    }
-    free(textCopy);
+void DestroyBoxRenderer(BoxRenderer*             renderer,
+                        slb_TextureCache*        textureCache,
+                        slb_DescriptorAllocator* descriptorAllocator,
+                        slb_Device*              device)
+{
+    slb_Buffer_Destroy(&renderer->vertexBuffer, device);
+    slb_Buffer_Destroy(&renderer->indexBuffer, device);
 
-    // Update text indices for dialogue boxes that come after this one
-    for (int i = insertIndex; i < dialogueBoxes->size; i++)
-    {
-        DialogueBox* laterBox = slb_Vector_Get(dialogueBoxes, i);
-        laterBox->beginningTextIndex += lineCount;
-    }
+    DestroyBoxInstanceBuffers(renderer, device);
 
-    box.connections = slb_Vector_Create(sizeof(int), 1);
+    slb_DescriptorAllocator_Free(descriptorAllocator,
+                                 renderer->textureLayout,
+                                 renderer->cursorTextureSet);
+    slb_DescriptorAllocator_Free(descriptorAllocator,
+                                 renderer->textureLayout,
+                                 renderer->boxTextureSet);
 
-    slb_Vector_Insert(dialogueBoxes, insertIndex, &box);
+    slb_TextureCache_Release(textureCache, renderer->cursorTexture);
+    slb_TextureCache_Release(textureCache, renderer->boxTexture);
 }
 
-void UpdateDialogueBox(int dialogueIndex, slb_Vector* renderObjects,
-                       slb_Vector*             textObjects,
-                       slb_Vector*             dialogueBoxes,
-                       slb_Vector*             lineObjects,
-                       slb_PhysicalDevice      physicalDevice,
-                       slb_Device*             device,
-                       slb_CommandPool*        commandPool,
-                       slb_DescriptorSetLayout descriptorSetLayout,
-                       slb_DescriptorPool      descriptorPool)
+// Copies the cursor and every box overlapping [visible] into this
+// frame's instance buffer, growing it first if needed. Selected boxes
+// carry their highlight flag already, so a whole moved selection goes
+// up with the rest in this one write.
+// [visibleBoxes] are the dense indices from GetVisibleBoxes
+void UpdateBoxRenderer(BoxRenderer* renderer, int frame,
+                       RenderObject* cursor, slb_SlotMap* dialogueBoxes,
+                       slb_Vector* visibleBoxes,
+                       CullStats* stats, slb_PhysicalDevice physicalDevice,
+                       slb_Device* device)
 {
-    DialogueBox* box = slb_Vector_Get(dialogueBoxes, dialogueIndex);
-    RenderObject* obj = slb_Vector_Get(renderObjects, dialogueIndex + 1);
-
-    // Store the data we need before cleanup
-    char text[1024];
-    strcpy(text, box->text);
-    char event[1024];
-    strcpy(event, box->event);
-    vec2 pos;
-    glm_vec2_copy(obj->position, pos);
+    uint32_t requiredCapacity = dialogueBoxes->size + 1;
 
-    // Store connections
-    slb_Vector* tempConnections = slb_Vector_Create(sizeof(int), 1);
-    for (int i = 0; i < box->connections->size; i++)
+    if (requiredCapacity > renderer->capacity)
     {
-        int* connection = slb_Vector_Get(box->connections, i);
-        slb_Vector_PushBack(tempConnections, connection);
-    }
+        uint32_t newCapacity = renderer->capacity;
+        while (newCapacity < requiredCapacity)
+        {
+            newCapacity *= 2;
+        }
 
-    // Store the old number of text objects BEFORE cleanup
-    int oldNumTextObjects = box->numTextObjects;
+        // The other frame may still be reading its instance buffer
+        vkDeviceWaitIdle(device->device);
 
-    // Clean up old text objects
-    for (int i = box->beginningTextIndex;
-         i < box->numTextObjects + box->beginningTextIndex; i++)
-    {
-        TextObject* textObj = slb_Vector_Get(textObjects, i);
-        DestroyTextObject(textObj, device);
+        DestroyBoxInstanceBuffers(renderer, device);
+        CreateBoxInstanceBuffers(renderer, newCapacity, physicalDevice,
+                                 device);
     }
 
-    // Remove old elements (from highest index to lowest to avoid shifting issues)
-    for (int i = box->numTextObjects + box->beginningTextIndex - 1;
-         i >= box->beginningTextIndex; i--)
-    {
-        slb_Vector_Remove(textObjects, i);
-    }
+    RenderObject* instances = renderer->instanceMaps[frame];
+    uint32_t      instanceCount = 0;
 
-    // Clean up old render object
-    DestroyRenderObject(obj, device);
-    slb_Vector_Remove(renderObjects, dialogueIndex + 1);
+    // The cursor is always instance 0
+    instances[instanceCount++] = *cursor;
 
-    // Free the old dialogue box connections
-    slb_Vector_Free(box->connections);
-    slb_Vector_Remove(dialogueBoxes, dialogueIndex);
+    stats->drawnBoxes += visibleBoxes->size;
+    stats->culledBoxes += dialogueBoxes->size - visibleBoxes->size;
 
-    // Update text indices for dialogue boxes that come after this one
-    // This must be done BEFORE creating the new dialogue box
-    for (int i = dialogueIndex; i < dialogueBoxes->size; i++)
+    for (size_t i = 0; i < visibleBoxes->size; i++)
     {
-        DialogueBox* laterBox = slb_Vector_Get(dialogueBoxes, i);
-        laterBox->beginningTextIndex -= oldNumTextObjects;
-    }
+        uint32_t     index = SLB_VECTOR_AT(visibleBoxes, uint32_t, i);
+        DialogueBox* box = slb_SlotMap_At(dialogueBoxes, index);
 
-    // Create new dialogue box at the same index
-    CreateDialogueBoxAtIndex(
-        text, pos, 0.01f, renderObjects, textObjects, dialogueBoxes,
-        dialogueIndex, physicalDevice, device, commandPool,
-        descriptorSetLayout, descriptorPool);
-
-    // Restore event and connections
-    DialogueBox* newBox = slb_Vector_Get(dialogueBoxes, dialogueIndex);
-    strcpy(newBox->event, event);
-
-    // Restore connections
-    for (int i = 0; i < tempConnections->size; i++)
-    {
-        int* connection = slb_Vector_Get(tempConnections, i);
-        slb_Vector_PushBack(newBox->connections, connection);
+        instances[instanceCount++] = box->renderObject;
     }
 
-    slb_Vector_Free(tempConnections);
-
-    currentDialogueBox = dialogueIndex + 1; // +1 for render object index
+    renderer->instanceCount[frame] = instanceCount;
 }
 
-LineObject CreateLineObject(vec3 startPos, vec3 endPos, vec3 color,
-                            float                   lineWidth,
-                            slb_PhysicalDevice      physicalDevice,
-                            slb_Device*             device,
-                            slb_CommandPool*        commandPool,
-                            slb_DescriptorSetLayout layout,
-                            slb_DescriptorPool      pool)
+void DestroyTextObject(TextObject* textObj)
 {
-    LineObject lineObj = {0};
-
-    glm_vec3_copy(color, lineObj.color);
-    lineObj.lineWidth = lineWidth;
-    glm_mat4_identity(lineObj.transform);
+    free(textObj->vertices);
+    textObj->vertices = NULL;
 
-    // Create line vertices
-    Vertex lineVertices[2] = {
-        {{startPos[0], startPos[1], startPos[2]}, {0.0f, 0.0f}},
-        {{endPos[0], endPos[1], endPos[2]}, {1.0f, 0.0f}}};
-
-    lineObj.vertexCount = 2;
+    slb_StringArena_Release(&strings, textObj->text);
+    textObj->text = SLB_EMPTY_STRING;
+}
 
-    // Create vertex buffer
-    VkDeviceSize bufferSize = sizeof(lineVertices);
+void CreateTextVertexBuffer(TextBatcher* batcher, uint32_t capacity,
+                            slb_PhysicalDevice physicalDevice,
+                            slb_Device*        device)
+{
+    VkDeviceSize bufferSize =
+        SLB_FRAMES_IN_FLIGHT * capacity * sizeof(TextVertex);
 
-    slb_Buffer stagingBuffer = slb_Buffer_Create(
-        bufferSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+    batcher->vertexBuffer = slb_Buffer_Create(
+        bufferSize, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
         VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
             VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
         physicalDevice, device);
 
-    void* data;
-    vkMapMemory(device->device, stagingBuffer.memory, 0, bufferSize,
-                0, &data);
-    memcpy(data, lineVertices, bufferSize);
-    vkUnmapMemory(device->device, stagingBuffer.memory);
+    batcher->vertexMap = batcher->vertexBuffer.allocation.mapped;
 
-    lineObj.vertexBuffer = slb_Buffer_Create(
-        bufferSize,
-        VK_BUFFER_USAGE_TRANSFER_DST_BIT |
-            VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
-        VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, physicalDevice, device);
+    batcher->capacity = capacity;
+}
 
-    slb_CopyBuffer(stagingBuffer.buffer, lineObj.vertexBuffer.buffer,
-                   bufferSize, device, commandPool);
+void DestroyTextVertexBuffer(TextBatcher* batcher, slb_Device* device)
+{
+    slb_Buffer_Destroy(&batcher->vertexBuffer, device);
+}
 
-    vkDestroyBuffer(device->device, stagingBuffer.buffer, NULL);
-    vkFreeMemory(device->device, stagingBuffer.memory, NULL);
+TextBatcher CreateTextBatcher(
+    uint32_t                 initialCapacity,
+    slb_PhysicalDevice       physicalDevice,
+    slb_Device*              device,
+    slb_DescriptorSetLayout  textureLayout,
+    slb_DescriptorAllocator* descriptorAllocator)
+{
+    TextBatcher batcher = {0};
+    batcher.textureLayout = textureLayout;
 
-    // Create uniform buffers
-    VkDeviceSize uniformBufferSize = sizeof(UniformBufferObject);
+    CreateTextVertexBuffer(&batcher, initialCapacity, physicalDevice,
+                           device);
 
-    for (size_t i = 0; i < SLB_FRAMES_IN_FLIGHT; i++)
-    {
-        lineObj.descriptorSet.buffers[i] = slb_Buffer_Create(
-            uniformBufferSize, VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
-            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
-                VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+    batcher.textureSet = CreateTextureDescriptorSet(
+        &glyphCache.atlas, device, textureLayout, descriptorAllocator);
+
+    return batcher;
+}
+
+void DestroyTextBatcher(TextBatcher*             batcher,
+                        slb_DescriptorAllocator* descriptorAllocator,
+                        slb_Device*              device)
+{
+    DestroyTextVertexBuffer(batcher, device);
+    slb_DescriptorAllocator_Free(descriptorAllocator,
+                                 batcher->textureLayout,
+                                 batcher->textureSet);
+}
+
+// Returns the byte offset of [frame]'s region in the vertex buffer
+VkDeviceSize GetTextBatchOffset(TextBatcher* batcher, int frame)
+{
+    return (VkDeviceSize)frame * batcher->capacity * sizeof(TextVertex);
+}
+
+// Returns whether [textObj] overlaps [visible] when placed at [origin]
+bool TextObjectVisible(TextObject* textObj, vec2 origin,
+                       VisibleRect* visible)
+{
+    vec2 min;
+    vec2 max;
+    glm_vec2_add(origin, textObj->boundsMin, min);
+    glm_vec2_add(origin, textObj->boundsMax, max);
+
+    return RectOverlaps(visible, min, max);
+}
+
+// Appends the glyph quads of every text object overlapping [visible]
+// into this frame's region of the vertex buffer, growing it first if
+// needed. Objects whose glyphs were evicted from the cache are laid
+// out again first, and the pages they sample are kept for this frame.
+// Only the boxes in [visibleBoxes], dense indices from
+// GetVisibleBoxes, are looked at
+void UpdateTextBatcher(TextBatcher* batcher, int frame,
+                       slb_SlotMap* dialogueBoxes,
+                       slb_Vector* visibleBoxes, VisibleRect* visible,
+                       CullStats*         stats,
+                       slb_PhysicalDevice physicalDevice,
+                       slb_Device*        device)
+{
+    // Relayout can evict a page another visible object was laid out
+    // against, so keep going until every one of them is current
+    bool stale = true;
+    while (stale)
+    {
+        stale = false;
+        for (size_t i = 0; i < visibleBoxes->size; i++)
+        {
+            DialogueBox* box = slb_SlotMap_At(
+                dialogueBoxes, SLB_VECTOR_AT(visibleBoxes, uint32_t, i));
+
+            for (int j = 0; j < box->textObjects->size; j++)
+            {
+                TextObject* textObj =
+                    &SLB_VECTOR_AT(box->textObjects, TextObject, j);
+
+                vec2 origin;
+                glm_vec2_add(box->renderObject.position,
+                             textObj->position, origin);
+
+                if (!TextObjectVisible(textObj, origin, visible))
+                {
+                    continue;
+                }
+
+                if (textObj->glyphGeneration != glyphCache.generation)
+                {
+                    LayoutTextObject(textObj);
+                    stale = true;
+                }
+                else
+                {
+                    slb_GlyphCache_TouchPages(&glyphCache,
+                                              textObj->pageMask);
+                }
+            }
+        }
+    }
+
+    uint32_t totalVertices = 0;
+    for (size_t i = 0; i < visibleBoxes->size; i++)
+    {
+        DialogueBox* box = slb_SlotMap_At(
+            dialogueBoxes, SLB_VECTOR_AT(visibleBoxes, uint32_t, i));
+
+        for (int j = 0; j < box->textObjects->size; j++)
+        {
+            totalVertices +=
+                SLB_VECTOR_AT(box->textObjects, TextObject, j).vertexCount;
+        }
+    }
+
+    if (totalVertices > batcher->capacity)
+    {
+        uint32_t newCapacity = batcher->capacity;
+        while (newCapacity < totalVertices)
+        {
+            newCapacity *= 2;
+        }
+
+        // The other frame may still be reading its region
+        vkDeviceWaitIdle(device->device);
+
+        DestroyTextVertexBuffer(batcher, device);
+        CreateTextVertexBuffer(batcher, newCapacity, physicalDevice,
+                               device);
+    }
+
+    TextVertex* target =
+        (TextVertex*)((char*)batcher->vertexMap +
+                      GetTextBatchOffset(batcher, frame));
+    uint32_t vertexCount = 0;
+
+    for (size_t i = 0; i < visibleBoxes->size; i++)
+    {
+        DialogueBox* box = slb_SlotMap_At(
+            dialogueBoxes, SLB_VECTOR_AT(visibleBoxes, uint32_t, i));
+
+        for (int j = 0; j < box->textObjects->size; j++)
+        {
+            TextObject* textObj =
+                &SLB_VECTOR_AT(box->textObjects, TextObject, j);
+
+            // Lines are laid out relative to their box, so moving a box
+            // never touches its text
+            vec2 origin;
+            glm_vec2_add(box->renderObject.position, textObj->position,
+                         origin);
+
+            if (!TextObjectVisible(textObj, origin, visible))
+            {
+                stats->culledText++;
+                continue;
+            }
+
+            stats->drawnText++;
+            vertexCount += textObj->vertexCount;
+            slb_GlyphCache_TouchPages(&glyphCache, textObj->pageMask);
+
+            for (int v = 0; v < textObj->vertexCount; v++)
+            {
+                TextVertex vertex = textObj->vertices[v];
+                vertex.pos[0] += origin[0];
+                vertex.pos[1] += 0.01f; // Just above the boxes
+                vertex.pos[2] += origin[1];
+
+                *target++ = vertex;
+            }
+        }
+    }
+
+    batcher->vertexCount[frame] = vertexCount;
+}
+
+slb_Handle currentDialogueBox = SLB_NULL_HANDLE;
+
+// Brings [box]'s text objects in line with its text and sizes the box
+// to fit them around its position. Lines are placed relative to the
+// box, so only layout sets their offsets. Lines that didn't change
+// keep their glyph quads, so typing into a big box only lays out the
+// line being edited.
+void LayoutDialogueBox(DialogueBox* box, float textScale)
+{
+    // Interning can move the arena, so split a copy of the text
+    char* textCopy = strdup(slb_StringArena_Get(&strings, box->text));
+    slb_Vector* tokens = slb_Vector_Create(sizeof(char*), 8);
+
+    char* token = strtok(textCopy, "\n");
+    while (token != NULL)
+    {
+        slb_Vector_PushBack(tokens, &token);
+        token = strtok(NULL, "\n");
+    }
+
+    // Lines are placed from the bottom of the box up, so text objects
+    // are kept last line first
+    slb_Vector* lines = slb_Vector_Create(sizeof(slb_StringId), 8);
+    for (int i = tokens->size - 1; i >= 0; i--)
+    {
+        char*        line = *(char**)slb_Vector_Get(tokens, i);
+        slb_StringId id = slb_StringArena_Intern(&strings, line);
+        slb_Vector_PushBack(lines, &id);
+    }
+
+    slb_Vector_Free(tokens);
+    free(textCopy);
+
+    // Equal strings have equal ids, so the lines that didn't change
+    // are the longest matching runs at both ends
+    slb_Vector* oldObjects = box->textObjects;
+    int         oldCount = oldObjects->size;
+    int         newCount = lines->size;
+
+    int prefix = 0;
+    while (prefix < oldCount && prefix < newCount)
+    {
+        TextObject*  textObj = slb_Vector_Get(oldObjects, prefix);
+        slb_StringId line = *(slb_StringId*)slb_Vector_Get(lines, prefix);
+
+        if (textObj->text != line || textObj->scale != textScale)
+        {
+            break;
+        }
+        prefix++;
+    }
+
+    int suffix = 0;
+    while (suffix < oldCount - prefix && suffix < newCount - prefix)
+    {
+        TextObject* textObj =
+            slb_Vector_Get(oldObjects, oldCount - 1 - suffix);
+        slb_StringId line =
+            *(slb_StringId*)slb_Vector_Get(lines, newCount - 1 - suffix);
+
+        if (textObj->text != line || textObj->scale != textScale)
+        {
+            break;
+        }
+        suffix++;
+    }
+
+    slb_Vector* newObjects =
+        slb_Vector_Create(sizeof(TextObject), newCount + 1);
+
+    for (int i = 0; i < newCount; i++)
+    {
+        slb_StringId line = *(slb_StringId*)slb_Vector_Get(lines, i);
+
+        if (i < prefix || i >= newCount - suffix)
+        {
+            int oldIndex = i < prefix ? i : oldCount - (newCount - i);
+
+            // The kept object already holds a reference to the line
+            slb_Vector_PushBack(newObjects,
+                                slb_Vector_Get(oldObjects, oldIndex));
+            slb_StringArena_Release(&strings, line);
+        }
+        else
+        {
+            // Only changed lines get new glyph quads, positions are
+            // set below along with everything else
+            TextObject textObj = CreateTextObject(
+                line, (vec2) {0.0f, 0.0f}, (vec3) {0.0f, 0.0f, 0.0f},
+                textScale);
+            slb_Vector_PushBack(newObjects, &textObj);
+        }
+    }
+
+    for (int i = prefix; i < oldCount - suffix; i++)
+    {
+        DestroyTextObject(slb_Vector_Get(oldObjects, i));
+    }
+
+    slb_Vector_Free(oldObjects);
+    slb_Vector_Free(lines);
+    box->textObjects = newObjects;
+
+    // Resize the box quad in place
+    float maxLineWidth = 0.0f;
+    for (int i = 0; i < newCount; i++)
+    {
+        TextObject* textObj = slb_Vector_Get(newObjects, i);
+        if (textObj->width > maxLineWidth)
+        {
+            maxLineWidth = textObj->width;
+        }
+    }
+
+    const float padding = 0.4f;
+    float       boxWidth = maxLineWidth + 2 * padding;
+    float       boxHeight =
+        (glyphCache.capHeight * textScale * newCount) + 2 * padding;
+
+    glm_vec2_copy((vec2) {boxWidth, boxHeight}, box->renderObject.scale);
+
+    float yOffset = padding;
+
+    for (int i = 0; i < newCount; i++)
+    {
+        TextObject* textObj = slb_Vector_Get(newObjects, i);
+
+        textObj->position[0] = -boxWidth / 2 + padding;
+        textObj->position[1] = -boxHeight / 2 + yOffset;
+
+        yOffset += glyphCache.capHeight * textScale * 1.2f;
+    }
+}
+
+// Refiles [box] in the grid after it moved or was resized
+void UpdateBoxBounds(slb_Handle handle, DialogueBox* box)
+{
+    RenderObject* renderObj = &box->renderObject;
+
+    vec2 halfScale;
+    vec2 min;
+    vec2 max;
+    glm_vec2_scale(renderObj->scale, 0.5f, halfScale);
+    glm_vec2_sub(renderObj->position, halfScale, min);
+    glm_vec2_add(renderObj->position, halfScale, max);
+
+    slb_SpatialGrid_Update(&boxGrid, handle, min, max);
+}
+
+// Returns the box under [point], the one drawn last if several
+// overlap, or a null handle. [scratch] holds the grid's results.
+slb_Handle PickDialogueBox(slb_SlotMap* dialogueBoxes, vec2 point,
+                           slb_Vector* scratch)
+{
+    slb_Vector_Clear(scratch);
+    slb_SpatialGrid_QueryPoint(&boxGrid, point, scratch);
+
+    slb_Handle picked = SLB_NULL_HANDLE;
+    int64_t    pickedIndex = -1;
+
+    for (size_t i = 0; i < scratch->size; i++)
+    {
+        slb_Handle handle = SLB_VECTOR_AT(scratch, slb_Handle, i);
+        int64_t    index = slb_SlotMap_IndexOf(dialogueBoxes, handle);
+
+        if (index > pickedIndex)
+        {
+            picked = handle;
+            pickedIndex = index;
+        }
+    }
+
+    return picked;
+}
+
+slb_Handle CreateDialogueBox(const char* text, vec2 pos, float textScale,
+                             slb_SlotMap* dialogueBoxes)
+{
+    DialogueBox box = {0};
+    box.text = slb_StringArena_Intern(&strings, text);
+    box.renderObject = CreateRenderObject(pos, (vec2) {0.0f, 0.0f});
+    box.connections = slb_Vector_Create(sizeof(slb_Handle), 1);
+    box.incoming = slb_Vector_Create(sizeof(slb_Handle), 1);
+    box.lines = slb_Vector_Create(sizeof(slb_Handle), 1);
+    box.textObjects = slb_Vector_Create(sizeof(TextObject), 1);
+
+    LayoutDialogueBox(&box, textScale);
+
+    slb_Handle handle = slb_SlotMap_Insert(dialogueBoxes, &box);
+    UpdateBoxBounds(handle, &box);
+
+    return handle;
+}
+
+// Frees what [box] owns, the box itself stays in its slot map
+void DestroyDialogueBox(DialogueBox* box)
+{
+    for (int i = 0; i < box->textObjects->size; i++)
+    {
+        TextObject* textObj = slb_Vector_Get(box->textObjects, i);
+        DestroyTextObject(textObj);
+    }
+
+    slb_Vector_Free(box->textObjects);
+    slb_Vector_Free(box->connections);
+    slb_Vector_Free(box->incoming);
+    slb_Vector_Free(box->lines);
+
+    slb_StringArena_Release(&strings, box->text);
+    slb_StringArena_Release(&strings, box->event);
+}
+
+// Points [id] at [text], releasing the string it referred to before
+void ReplaceString(slb_StringId* id, const char* text)
+{
+    slb_StringId old = *id;
+    *id = slb_StringArena_Intern(&strings, text);
+    slb_StringArena_Release(&strings, old);
+}
+
+// Copies [text] into a malloc'd buffer the inspector can edit
+void SetEditBuffer(char** buffer, size_t* capacity, const char* text)
+{
+    size_t length = strlen(text) + 1;
+
+    if (length > *capacity)
+    {
+        *capacity = length > 256 ? length : 256;
+        *buffer = realloc(*buffer, *capacity);
+    }
+
+    memcpy(*buffer, text, length);
+}
+
+// Position of the first occurrence of [handle], or -1
+int FindHandle(slb_Vector* handles, slb_Handle handle)
+{
+    slb_Handle* data = SLB_VECTOR_DATA(handles, slb_Handle);
+
+    for (int i = 0; i < handles->size; i++)
+    {
+        if (slb_Handle_Equals(data[i], handle))
+        {
+            return i;
+        }
+    }
+
+    return -1;
+}
+
+bool ContainsHandle(slb_Vector* handles, slb_Handle handle)
+{
+    return FindHandle(handles, handle) >= 0;
+}
+
+slb_Vector* CopyHandles(slb_Vector* handles)
+{
+    slb_Vector* copy =
+        slb_Vector_Create(sizeof(slb_Handle), handles->size + 1);
+    slb_Vector_InsertRange(copy, 0, handles->data, handles->size);
+
+    return copy;
+}
+
+// Removes the first occurrence of [handle], keeping the order of the
+// rest
+void RemoveHandle(slb_Vector* handles, slb_Handle handle)
+{
+    int index = FindHandle(handles, handle);
+
+    if (index >= 0)
+    {
+        slb_Vector_Remove(handles, index);
+    }
+}
+
+LineObject CreateLineObject(slb_Handle firstBox, slb_Handle secondBox,
+                            vec3 color, float lineWidth)
+{
+    LineObject lineObj = {0};
+
+    glm_vec3_copy(color, lineObj.color);
+    lineObj.lineWidth = lineWidth;
+    lineObj.firstBox = firstBox;
+    lineObj.secondBox = secondBox;
+
+    return lineObj;
+}
+
+void CreateEdgeVertexBuffers(EdgeBuffer* edges, uint32_t capacity,
+                             slb_PhysicalDevice physicalDevice,
+                             slb_Device*        device)
+{
+    VkDeviceSize bufferSize = capacity * 2 * sizeof(Vertex);
+
+    for (size_t i = 0; i < SLB_FRAMES_IN_FLIGHT; i++)
+    {
+        edges->vertexBuffers[i] = slb_Buffer_Create(
+            bufferSize, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
+            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
+                VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+            physicalDevice, device);
+
+        edges->vertexMaps[i] =
+            edges->vertexBuffers[i].allocation.mapped;
+
+        edges->indexBuffers[i] = slb_Buffer_Create(
+            capacity * 2 * sizeof(uint32_t),
+            VK_BUFFER_USAGE_INDEX_BUFFER_BIT,
+            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
+                VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
             physicalDevice, device);
 
-        vkMapMemory(device->device,
-                    lineObj.descriptorSet.buffers[i].memory, 0,
-                    uniformBufferSize, 0,
-                    &lineObj.descriptorSet.buffersMap[i]);
+        edges->indexMaps[i] = edges->indexBuffers[i].allocation.mapped;
+
+        edges->rewriteAll[i] = true;
+    }
+
+    edges->capacity = capacity;
+}
+
+void DestroyEdgeVertexBuffers(EdgeBuffer* edges, slb_Device* device)
+{
+    for (size_t i = 0; i < SLB_FRAMES_IN_FLIGHT; i++)
+    {
+        slb_Buffer_Destroy(&edges->vertexBuffers[i], device);
+        slb_Buffer_Destroy(&edges->indexBuffers[i], device);
+    }
+}
+
+EdgeBuffer CreateEdgeBuffer(uint32_t           initialCapacity,
+                            slb_PhysicalDevice physicalDevice,
+                            slb_Device*        device)
+{
+    EdgeBuffer edges = {0};
+
+    CreateEdgeVertexBuffers(&edges, initialCapacity, physicalDevice,
+                            device);
+
+    for (size_t i = 0; i < SLB_FRAMES_IN_FLIGHT; i++)
+    {
+        edges.dirtyLines[i] = slb_Vector_Create(sizeof(int), 16);
+    }
+
+    return edges;
+}
+
+void DestroyEdgeBuffer(EdgeBuffer* edges, slb_Device* device)
+{
+    DestroyEdgeVertexBuffers(edges, device);
+
+    for (size_t i = 0; i < SLB_FRAMES_IN_FLIGHT; i++)
+    {
+        slb_Vector_Free(edges->dirtyLines[i]);
+    }
+}
+
+// Queue one line to be rewritten in every frame's vertex buffer
+void MarkEdgeDirty(EdgeBuffer* edges, int lineIndex)
+{
+    for (size_t i = 0; i < SLB_FRAMES_IN_FLIGHT; i++)
+    {
+        if (!edges->rewriteAll[i])
+        {
+            slb_Vector_PushBack(edges->dirtyLines[i], &lineIndex);
+        }
+    }
+}
+
+// Every line has to be rewritten, like after the buffers grew
+void MarkAllEdgesDirty(EdgeBuffer* edges)
+{
+    for (size_t i = 0; i < SLB_FRAMES_IN_FLIGHT; i++)
+    {
+        edges->rewriteAll[i] = true;
+        slb_Vector_Clear(edges->dirtyLines[i]);
+    }
+}
+
+// Queue every line that starts or ends at a moved dialogue box
+void MarkBoxEdgesDirty(EdgeBuffer* edges, slb_SlotMap* lineObjects,
+                       DialogueBox* box)
+{
+    for (int i = 0; i < box->lines->size; i++)
+    {
+        slb_Handle line = SLB_VECTOR_AT(box->lines, slb_Handle, i);
+        MarkEdgeDirty(edges, slb_SlotMap_IndexOf(lineObjects, line));
+    }
+}
+
+slb_Handle AddLineObject(slb_SlotMap* lineObjects, EdgeBuffer* edges,
+                         slb_Handle firstBox, slb_Handle secondBox)
+{
+    LineObject line = CreateLineObject(
+        firstBox, secondBox, (vec3) {1.0f, 1.0f, 1.0f}, 3.0f);
+
+    slb_Handle handle = slb_SlotMap_Insert(lineObjects, &line);
+    MarkEdgeDirty(edges, lineObjects->size - 1);
+
+    return handle;
+}
+
+// The last line moves into the removed one's place, so only that slot
+// of the vertex buffer needs rewriting
+void RemoveLineObject(slb_SlotMap* lineObjects, EdgeBuffer* edges,
+                      slb_Handle line)
+{
+    int64_t index = slb_SlotMap_IndexOf(lineObjects, line);
+
+    if (slb_SlotMap_Remove(lineObjects, line) &&
+        index < (int64_t)lineObjects->size)
+    {
+        MarkEdgeDirty(edges, (int)index);
+    }
+}
+
+void WriteEdgeVertices(EdgeBuffer* edges, int frame, int lineIndex,
+                       slb_SlotMap* lineObjects,
+                       slb_SlotMap* dialogueBoxes)
+{
+    LineObject* line = slb_SlotMap_At(lineObjects, lineIndex);
+
+    DialogueBox* box1 = slb_SlotMap_Get(dialogueBoxes, line->firstBox);
+    DialogueBox* box2 = slb_SlotMap_Get(dialogueBoxes, line->secondBox);
+    RenderObject* renderObj1 = &box1->renderObject;
+    RenderObject* renderObj2 = &box2->renderObject;
+
+    Vertex* target = (Vertex*)edges->vertexMaps[frame] + lineIndex * 2;
+
+    target[0] = (Vertex) {
+        {renderObj1->position[0], 0.0f, renderObj1->position[1]},
+        {0.0f, 0.0f}};
+    target[1] = (Vertex) {
+        {renderObj2->position[0], 0.0f, renderObj2->position[1]},
+        {1.0f, 0.0f}};
+}
+
+// Bring this frame's vertex buffer up to date and list the lines
+// crossing [visible] in its index buffer, must be called after the
+// frame's fence has been waited on
+void UpdateEdgeBuffer(EdgeBuffer* edges, int frame,
+                      slb_SlotMap* lineObjects, slb_SlotMap* dialogueBoxes,
+                      VisibleRect* visible, CullStats* stats,
+                      slb_PhysicalDevice physicalDevice,
+                      slb_Device*        device)
+{
+    if (lineObjects->size > edges->capacity)
+    {
+        uint32_t newCapacity = edges->capacity * 2;
+        while (newCapacity < lineObjects->size)
+        {
+            newCapacity *= 2;
+        }
+
+        // The other frame may still be reading its buffer
+        vkDeviceWaitIdle(device->device);
+        DestroyEdgeVertexBuffers(edges, device);
+        CreateEdgeVertexBuffers(edges, newCapacity, physicalDevice,
+                                device);
+        MarkAllEdgesDirty(edges);
+    }
+
+    if (edges->rewriteAll[frame])
+    {
+        for (int i = 0; i < lineObjects->size; i++)
+        {
+            WriteEdgeVertices(edges, frame, i, lineObjects,
+                              dialogueBoxes);
+        }
+
+        edges->rewriteAll[frame] = false;
+    }
+    else
+    {
+        slb_Vector* dirty = edges->dirtyLines[frame];
+        for (int i = 0; i < dirty->size; i++)
+        {
+            int lineIndex = SLB_VECTOR_AT(dirty, int, i);
+
+            // Lines removed after being queued shrink the store
+            if (lineIndex < lineObjects->size)
+            {
+                WriteEdgeVertices(edges, frame, lineIndex, lineObjects,
+                                  dialogueBoxes);
+            }
+        }
+    }
+
+    slb_Vector_Clear(edges->dirtyLines[frame]);
+
+    uint32_t* lineIndices = edges->indexMaps[frame];
+    uint32_t  indexCount = 0;
+
+    for (int i = 0; i < lineObjects->size; i++)
+    {
+        LineObject* line = slb_SlotMap_At(lineObjects, i);
+
+        DialogueBox* box1 =
+            slb_SlotMap_Get(dialogueBoxes, line->firstBox);
+        DialogueBox* box2 =
+            slb_SlotMap_Get(dialogueBoxes, line->secondBox);
+        RenderObject* renderObj1 = &box1->renderObject;
+        RenderObject* renderObj2 = &box2->renderObject;
+
+        if (!SegmentIntersectsRect(visible, renderObj1->position,
+                                   renderObj2->position))
+        {
+            stats->culledEdges++;
+            continue;
+        }
+
+        stats->drawnEdges++;
+        lineIndices[indexCount++] = i * 2;
+        lineIndices[indexCount++] = i * 2 + 1;
+    }
+
+    edges->indexCount[frame] = indexCount;
+}
+
+// Connects [from] to [to] and draws a line between them
+void ConnectDialogueBoxes(slb_SlotMap* dialogueBoxes,
+                          slb_SlotMap* lineObjects, EdgeBuffer* edgeBuffer,
+                          slb_Handle from, slb_Handle to)
+{
+    DialogueBox* source = slb_SlotMap_Get(dialogueBoxes, from);
+    DialogueBox* target = slb_SlotMap_Get(dialogueBoxes, to);
+    if (source == NULL || target == NULL)
+    {
+        return;
+    }
+
+    slb_Handle line = AddLineObject(lineObjects, edgeBuffer, from, to);
+
+    slb_Vector_PushBack(source->connections, &to);
+    slb_Vector_PushBack(target->incoming, &from);
+
+    slb_Vector_PushBack(source->lines, &line);
+    if (!slb_Handle_Equals(from, to))
+    {
+        slb_Vector_PushBack(target->lines, &line);
+    }
+}
+
+// Undoes one ConnectDialogueBoxes([from], [to])
+void DisconnectDialogueBoxes(slb_SlotMap* dialogueBoxes,
+                             slb_SlotMap* lineObjects,
+                             EdgeBuffer* edgeBuffer, slb_Handle from,
+                             slb_Handle to)
+{
+    DialogueBox* source = slb_SlotMap_Get(dialogueBoxes, from);
+    DialogueBox* target = slb_SlotMap_Get(dialogueBoxes, to);
+    if (source == NULL || target == NULL)
+    {
+        return;
+    }
+
+    RemoveHandle(source->connections, to);
+    RemoveHandle(target->incoming, from);
+
+    for (int i = 0; i < source->lines->size; i++)
+    {
+        slb_Handle handle =
+            *(slb_Handle*)slb_Vector_Get(source->lines, i);
+        LineObject* line = slb_SlotMap_Get(lineObjects, handle);
+
+        if (slb_Handle_Equals(line->firstBox, from) &&
+            slb_Handle_Equals(line->secondBox, to))
+        {
+            RemoveHandle(source->lines, handle);
+            if (!slb_Handle_Equals(from, to))
+            {
+                RemoveHandle(target->lines, handle);
+            }
+
+            RemoveLineObject(lineObjects, edgeBuffer, handle);
+            return;
+        }
+    }
+}
+
+// Removes [handle]'s lines and every connection into or out of it
+// from its neighbours, leaving the box's own lists as they were. Only
+// its neighbours are visited and nothing is renumbered, other handles
+// stay valid.
+void DetachDialogueBox(slb_SlotMap* dialogueBoxes,
+                       slb_SlotMap* lineObjects, EdgeBuffer* edgeBuffer,
+                       slb_Handle handle)
+{
+    DialogueBox* boxToDelete = slb_SlotMap_Get(dialogueBoxes, handle);
+    if (boxToDelete == NULL)
+    {
+        return;
+    }
+
+    // Remove the lines from the other end's list too
+    for (int i = 0; i < boxToDelete->lines->size; i++)
+    {
+        slb_Handle lineHandle =
+            *(slb_Handle*)slb_Vector_Get(boxToDelete->lines, i);
+        LineObject* line = slb_SlotMap_Get(lineObjects, lineHandle);
+
+        slb_Handle other = slb_Handle_Equals(line->firstBox, handle)
+                               ? line->secondBox
+                               : line->firstBox;
+
+        if (!slb_Handle_Equals(other, handle))
+        {
+            DialogueBox* otherBox = slb_SlotMap_Get(dialogueBoxes, other);
+            RemoveHandle(otherBox->lines, lineHandle);
+        }
+
+        RemoveLineObject(lineObjects, edgeBuffer, lineHandle);
+    }
+
+    // Remove connections from other dialogue boxes that point to this
+    // one, once per incoming entry since either side may repeat
+    for (int i = 0; i < boxToDelete->incoming->size; i++)
+    {
+        slb_Handle source =
+            *(slb_Handle*)slb_Vector_Get(boxToDelete->incoming, i);
+
+        if (!slb_Handle_Equals(source, handle))
+        {
+            DialogueBox* sourceBox =
+                slb_SlotMap_Get(dialogueBoxes, source);
+            RemoveHandle(sourceBox->connections, handle);
+        }
+    }
+
+    for (int i = 0; i < boxToDelete->connections->size; i++)
+    {
+        slb_Handle target =
+            *(slb_Handle*)slb_Vector_Get(boxToDelete->connections, i);
+
+        if (!slb_Handle_Equals(target, handle))
+        {
+            DialogueBox* targetBox =
+                slb_SlotMap_Get(dialogueBoxes, target);
+            RemoveHandle(targetBox->incoming, handle);
+        }
+    }
+}
+
+// Moves every box in [handles] by [delta]. Their text follows without
+// being touched. Once most of the boxes move, rewriting every line is
+// cheaper than queuing them one by one.
+void MoveDialogueBoxes(slb_SlotMap* dialogueBoxes,
+                       slb_SlotMap* lineObjects, EdgeBuffer* edgeBuffer,
+                       slb_Vector* handles, vec2 delta)
+{
+    bool rewriteAll = handles->size * 2 > dialogueBoxes->size;
+
+    for (size_t i = 0; i < handles->size; i++)
+    {
+        slb_Handle   handle = SLB_VECTOR_AT(handles, slb_Handle, i);
+        DialogueBox* box = slb_SlotMap_Get(dialogueBoxes, handle);
+        if (box == NULL)
+        {
+            continue;
+        }
+
+        glm_vec2_add(box->renderObject.position, delta,
+                     box->renderObject.position);
+
+        if (!rewriteAll)
+        {
+            MarkBoxEdgesDirty(edgeBuffer, lineObjects, box);
+        }
+        UpdateBoxBounds(handle, box);
+    }
+
+    if (rewriteAll)
+    {
+        MarkAllEdgesDirty(edgeBuffer);
+    }
+}
+
+// The selection is a list of box handles, and every selected box also
+// carries RenderObjectFlags_Selected so the renderer can copy it as is
+bool IsBoxSelected(slb_SlotMap* dialogueBoxes, slb_Handle handle)
+{
+    DialogueBox* box = slb_SlotMap_Get(dialogueBoxes, handle);
+
+    return box != NULL &&
+           (box->renderObject.flags & RenderObjectFlags_Selected);
+}
+
+void SelectDialogueBox(slb_SlotMap* dialogueBoxes,
+                       slb_Vector* selection, slb_Handle handle)
+{
+    DialogueBox* box = slb_SlotMap_Get(dialogueBoxes, handle);
+    if (box == NULL ||
+        (box->renderObject.flags & RenderObjectFlags_Selected))
+    {
+        return;
+    }
+
+    box->renderObject.flags |= RenderObjectFlags_Selected;
+    slb_Vector_PushBack(selection, &handle);
+}
+
+void DeselectDialogueBox(slb_SlotMap* dialogueBoxes,
+                         slb_Vector* selection, slb_Handle handle)
+{
+    DialogueBox* box = slb_SlotMap_Get(dialogueBoxes, handle);
+    if (box != NULL)
+    {
+        box->renderObject.flags &= ~RenderObjectFlags_Selected;
+    }
+
+    RemoveHandle(selection, handle);
+}
+
+void ClearSelection(slb_SlotMap* dialogueBoxes, slb_Vector* selection)
+{
+    for (size_t i = 0; i < selection->size; i++)
+    {
+        DialogueBox* box = slb_SlotMap_Get(
+            dialogueBoxes, SLB_VECTOR_AT(selection, slb_Handle, i));
+        if (box != NULL)
+        {
+            box->renderObject.flags &= ~RenderObjectFlags_Selected;
+        }
+    }
+
+    slb_Vector_Clear(selection);
+}
+
+// Drops the boxes that are gone and highlights the rest again, since
+// undo and redo can take boxes away and bring them back
+void PruneSelection(slb_SlotMap* dialogueBoxes, slb_Vector* selection)
+{
+    size_t kept = 0;
+
+    for (size_t i = 0; i < selection->size; i++)
+    {
+        slb_Handle   handle = SLB_VECTOR_AT(selection, slb_Handle, i);
+        DialogueBox* box = slb_SlotMap_Get(dialogueBoxes, handle);
+        if (box == NULL)
+        {
+            continue;
+        }
+
+        box->renderObject.flags |= RenderObjectFlags_Selected;
+        SLB_VECTOR_AT(selection, slb_Handle, kept++) = handle;
+    }
+
+    slb_Vector_EraseRange(selection, kept, selection->size - kept);
+}
+
+// Takes [handle]'s box out of the scene without destroying it. Its
+// links are kept in [stash] for RestoreDialogueBox.
+bool StashDialogueBox(slb_SlotMap* dialogueBoxes,
+                      slb_SlotMap* lineObjects, EdgeBuffer* edgeBuffer,
+                      slb_Handle handle, StashedBox* stash)
+{
+    DialogueBox* box = slb_SlotMap_Get(dialogueBoxes, handle);
+    if (box == NULL)
+    {
+        return false;
+    }
+
+    // Reconnecting appends to the sources' connections, so remember
+    // where this box sat in each of them
+    stash->orders = slb_Vector_Create(sizeof(ConnectionOrder), 1);
+
+    for (int i = 0; i < box->incoming->size; i++)
+    {
+        slb_Handle source = *(slb_Handle*)slb_Vector_Get(box->incoming, i);
+        bool       seen = slb_Handle_Equals(source, handle);
+
+        for (int j = 0; j < stash->orders->size && !seen; j++)
+        {
+            ConnectionOrder* order = slb_Vector_Get(stash->orders, j);
+            seen = slb_Handle_Equals(order->source, source);
+        }
+
+        if (!seen)
+        {
+            DialogueBox*    sourceBox =
+                slb_SlotMap_Get(dialogueBoxes, source);
+            ConnectionOrder order = {
+                source, CopyHandles(sourceBox->connections)};
+            slb_Vector_PushBack(stash->orders, &order);
+        }
+    }
+
+    DetachDialogueBox(dialogueBoxes, lineObjects, edgeBuffer, handle);
+
+    stash->outgoing = box->connections;
+    stash->incoming = box->incoming;
+    box->connections = slb_Vector_Create(sizeof(slb_Handle), 1);
+    box->incoming = slb_Vector_Create(sizeof(slb_Handle), 1);
+    slb_Vector_Clear(box->lines);
+
+    // It comes back unselected
+    box->renderObject.flags &= ~RenderObjectFlags_Selected;
+
+    stash->box = *box;
+    stash->stashed = true;
+    slb_SlotMap_Remove(dialogueBoxes, handle);
+    slb_SpatialGrid_Remove(&boxGrid, handle);
+
+    return true;
+}
+
+void FreeConnectionOrders(slb_Vector* orders)
+{
+    for (int i = 0; i < orders->size; i++)
+    {
+        ConnectionOrder* order = slb_Vector_Get(orders, i);
+        slb_Vector_Free(order->connections);
+    }
+
+    slb_Vector_Free(orders);
+}
+
+// Puts a stashed box back under the same handle and reconnects it
+// exactly as it was
+bool RestoreDialogueBox(slb_SlotMap* dialogueBoxes,
+                        slb_SlotMap* lineObjects, EdgeBuffer* edgeBuffer,
+                        slb_Handle handle, StashedBox* stash)
+{
+    if (!stash->stashed ||
+        !slb_SlotMap_InsertAt(dialogueBoxes, handle, &stash->box))
+    {
+        return false;
+    }
+
+    stash->stashed = false;
+    UpdateBoxBounds(handle, &stash->box);
+
+    for (int i = 0; i < stash->outgoing->size; i++)
+    {
+        slb_Handle target =
+            *(slb_Handle*)slb_Vector_Get(stash->outgoing, i);
+        ConnectDialogueBoxes(dialogueBoxes, lineObjects, edgeBuffer,
+                             handle, target);
+    }
+
+    // Self loops came back with the outgoing connections
+    for (int i = 0; i < stash->incoming->size; i++)
+    {
+        slb_Handle source =
+            *(slb_Handle*)slb_Vector_Get(stash->incoming, i);
+
+        if (!slb_Handle_Equals(source, handle))
+        {
+            ConnectDialogueBoxes(dialogueBoxes, lineObjects, edgeBuffer,
+                                 source, handle);
+        }
+    }
+
+    for (int i = 0; i < stash->orders->size; i++)
+    {
+        ConnectionOrder* order = slb_Vector_Get(stash->orders, i);
+        DialogueBox*     source =
+            slb_SlotMap_Get(dialogueBoxes, order->source);
+
+        if (source != NULL &&
+            source->connections->size == order->connections->size)
+        {
+            memcpy(source->connections->data, order->connections->data,
+                   order->connections->size * sizeof(slb_Handle));
+        }
+    }
+
+    slb_Vector_Free(stash->outgoing);
+    slb_Vector_Free(stash->incoming);
+    FreeConnectionOrders(stash->orders);
+
+    return true;
+}
+
+void DestroyStashedBox(StashedBox* stash)
+{
+    if (!stash->stashed)
+    {
+        return;
+    }
+
+    DestroyDialogueBox(&stash->box);
+    slb_Vector_Free(stash->outgoing);
+    slb_Vector_Free(stash->incoming);
+    FreeConnectionOrders(stash->orders);
+    stash->stashed = false;
+}
+
+// What the value being read belongs to
+typedef enum
+{
+    DiagsvField_None,
+    DiagsvField_Position,
+    DiagsvField_Text,
+    DiagsvField_Event,
+    DiagsvField_Connections,
+} DiagsvField;
+
+// A connection read from a .diagsv, kept until every box exists
+typedef struct
+{
+    int source; // Position in the file
+    int target; // 1-based, as saved
+} SavedConnection;
+
+// State of a streaming .diagsv load. The file is an array of box
+// objects, and each box is created as soon as its object ends.
+typedef struct
+{
+    slb_SlotMap* dialogueBoxes;
+    slb_Vector*  handles;     // slb_Handle of each box, in file order
+    slb_Vector*  connections; // SavedConnection
+    int          depth;
+    int          skipDepth; // Of a value under an unknown key
+    DiagsvField  field;
+    vec2         position;
+    int          positionCount;
+    slb_Vector*  text;  // char, terminated
+    slb_Vector*  event; // char, terminated
+} DiagsvLoader;
+
+void SetLoaderString(slb_Vector* target, const slb_JsonEvent* event)
+{
+    slb_Vector_Clear(target);
+    slb_Vector_InsertRange(target, 0, event->string, event->length);
+    slb_Vector_PushBack(target, "");
+}
+
+bool HandleDiagsvEvent(const slb_JsonEvent* event, void* userData)
+{
+    DiagsvLoader* loader = userData;
+
+    bool opens = event->type == slb_JsonEventType_BeginObject ||
+                 event->type == slb_JsonEventType_BeginArray;
+    bool closes = event->type == slb_JsonEventType_EndObject ||
+                  event->type == slb_JsonEventType_EndArray;
+
+    // Values under keys this version doesn't know are passed over
+    if (loader->skipDepth > 0)
+    {
+        loader->skipDepth += opens ? 1 : closes ? -1 : 0;
+        return true;
+    }
+
+    if (closes)
+    {
+        loader->depth--;
+    }
+
+    switch (loader->depth)
+    {
+    case 0:
+        // The root has to be the array of boxes
+        if (event->type != slb_JsonEventType_BeginArray &&
+            event->type != slb_JsonEventType_EndArray)
+        {
+            return false;
+        }
+        break;
+    case 1:
+        if (event->type == slb_JsonEventType_BeginObject)
+        {
+            loader->positionCount = 0;
+            glm_vec2_zero(loader->position);
+            slb_Vector_Clear(loader->text);
+            slb_Vector_PushBack(loader->text, "");
+            slb_Vector_Clear(loader->event);
+            slb_Vector_PushBack(loader->event, "");
+        }
+        else if (event->type == slb_JsonEventType_EndObject)
+        {
+            slb_Handle handle = CreateDialogueBox(
+                SLB_VECTOR_DATA(loader->text, char), loader->position,
+                0.01f, loader->dialogueBoxes);
+
+            DialogueBox* box =
+                slb_SlotMap_Get(loader->dialogueBoxes, handle);
+            box->event = slb_StringArena_Intern(
+                &strings, SLB_VECTOR_DATA(loader->event, char));
+
+            slb_Vector_PushBack(loader->handles, &handle);
+        }
+        else
+        {
+            return false;
+        }
+        break;
+    case 2:
+        if (event->type == slb_JsonEventType_Key)
+        {
+            const char* key = event->string;
+
+            if (strcmp(key, "position") == 0)
+            {
+                loader->field = DiagsvField_Position;
+            }
+            else if (strcmp(key, "text") == 0)
+            {
+                loader->field = DiagsvField_Text;
+            }
+            else if (strcmp(key, "event") == 0)
+            {
+                loader->field = DiagsvField_Event;
+            }
+            else if (strcmp(key, "connections") == 0)
+            {
+                loader->field = DiagsvField_Connections;
+            }
+            else
+            {
+                loader->field = DiagsvField_None;
+            }
+        }
+        else if (loader->field == DiagsvField_None && opens)
+        {
+            loader->skipDepth = 1;
+            return true;
+        }
+        else if (event->type == slb_JsonEventType_String &&
+                 loader->field == DiagsvField_Text)
+        {
+            SetLoaderString(loader->text, event);
+        }
+        else if (event->type == slb_JsonEventType_String &&
+                 loader->field == DiagsvField_Event)
+        {
+            SetLoaderString(loader->event, event);
+        }
+        break;
+    case 3:
+        // Nothing is nested deeper than a field's array
+        if (opens)
+        {
+            loader->skipDepth = 1;
+            return true;
+        }
+
+        if (event->type != slb_JsonEventType_Number)
+        {
+            break;
+        }
+
+        if (loader->field == DiagsvField_Position &&
+            loader->positionCount < 2)
+        {
+            loader->position[loader->positionCount++] =
+                (float)event->number;
+        }
+        else if (loader->field == DiagsvField_Connections)
+        {
+            // A fraction or a number past int can't name a box
+            if (!event->isInteger || event->integer < INT_MIN ||
+                event->integer > INT_MAX)
+            {
+                return false;
+            }
+
+            SavedConnection connection = {
+                (int)loader->handles->size, (int)event->integer};
+            slb_Vector_PushBack(loader->connections, &connection);
+        }
+        break;
+    }
+
+    if (opens)
+    {
+        loader->depth++;
+    }
+
+    return true;
+}
+
+// Destroys every box and line, leaving an empty scene
+void ClearDialogueBoxes(slb_SlotMap* dialogueBoxes,
+                        slb_SlotMap* lineObjects, EdgeBuffer* edgeBuffer)
+{
+    for (size_t i = 0; i < dialogueBoxes->size; i++)
+    {
+        DialogueBox* box = slb_SlotMap_At(dialogueBoxes, i);
+        DestroyDialogueBox(box);
+    }
+
+    slb_SlotMap_Clear(dialogueBoxes);
+    slb_SlotMap_Clear(lineObjects);
+    slb_SpatialGrid_Clear(&boxGrid);
+    MarkAllEdgesDirty(edgeBuffer);
+}
+
+// Replaces the scene with the boxes in a .diagsv, reading it in one
+// streaming pass. Only the connections are held until the end, since
+// they can point at boxes further down the file.
+void LoadDiagsv(const char* filename, slb_SlotMap* dialogueBoxes,
+                slb_SlotMap* lineObjects, EdgeBuffer* edgeBuffer)
+{
+    ClearDialogueBoxes(dialogueBoxes, lineObjects, edgeBuffer);
+
+    DiagsvLoader loader = {0};
+    loader.dialogueBoxes = dialogueBoxes;
+    loader.handles = slb_Vector_Create(sizeof(slb_Handle), 64);
+    loader.connections = slb_Vector_Create(sizeof(SavedConnection), 64);
+    loader.text = slb_Vector_Create(sizeof(char), 256);
+    loader.event = slb_Vector_Create(sizeof(char), 64);
+
+    if (slb_Json_ParseFile(filename, HandleDiagsvEvent, &loader))
+    {
+        int boxCount = (int)loader.handles->size;
+
+        for (size_t i = 0; i < loader.connections->size; i++)
+        {
+            SavedConnection* connection =
+                &SLB_VECTOR_AT(loader.connections, SavedConnection, i);
+
+            if (connection->target >= 1 && connection->target <= boxCount)
+            {
+                ConnectDialogueBoxes(
+                    dialogueBoxes, lineObjects, edgeBuffer,
+                    SLB_VECTOR_AT(loader.handles, slb_Handle,
+                                  connection->source),
+                    SLB_VECTOR_AT(loader.handles, slb_Handle,
+                                  connection->target - 1));
+            }
+        }
+    }
+    else
+    {
+        // Don't leave half a file loaded
+        printf("Failed to load file: %s\n", filename);
+        ClearDialogueBoxes(dialogueBoxes, lineObjects, edgeBuffer);
+    }
+
+    slb_Vector_Free(loader.handles);
+    slb_Vector_Free(loader.connections);
+    slb_Vector_Free(loader.text);
+    slb_Vector_Free(loader.event);
+}
+
+// Streams every box to [filename] in one pass, connections as the
+// 1-based positions of their targets. Exports leave out the editor
+// only positions. Returns false if the file couldn't be written.
+bool SaveDialogueBoxes(const char* filename, slb_SlotMap* dialogueBoxes,
+                       bool withPositions, bool pretty)
+{
+    slb_JsonWriter writer;
+    if (!slb_JsonWriter_Open(&writer, filename, pretty))
+    {
+        return false;
+    }
+
+    slb_JsonWriter_BeginArray(&writer);
+
+    for (size_t i = 0; i < dialogueBoxes->size; i++)
+    {
+        DialogueBox* box = slb_SlotMap_At(dialogueBoxes, i);
+
+        slb_JsonWriter_BeginObject(&writer);
+
+        if (withPositions)
+        {
+            slb_JsonWriter_Key(&writer, "position");
+            slb_JsonWriter_Float2(&writer, box->renderObject.position);
+        }
+
+        slb_JsonWriter_Key(&writer, "text");
+        slb_JsonWriter_String(&writer,
+                              slb_StringArena_Get(&strings, box->text));
+        slb_JsonWriter_Key(&writer, "event");
+        slb_JsonWriter_String(&writer,
+                              slb_StringArena_Get(&strings, box->event));
+
+        slb_JsonWriter_Key(&writer, "connections");
+        slb_JsonWriter_BeginArray(&writer);
+
+        for (size_t j = 0; j < box->connections->size; j++)
+        {
+            slb_Handle target =
+                SLB_VECTOR_AT(box->connections, slb_Handle, j);
+            int64_t index = slb_SlotMap_IndexOf(dialogueBoxes, target);
+
+            if (index >= 0)
+            {
+                slb_JsonWriter_Int(&writer, (int)index + 1);
+            }
+        }
+
+        slb_JsonWriter_EndArray(&writer);
+        slb_JsonWriter_EndObject(&writer);
+    }
+
+    slb_JsonWriter_EndArray(&writer);
+
+    return slb_JsonWriter_Close(&writer);
+}
+
+// Start of a .diagb file, the binary twin of .diagsv. It is written
+// in the machine's byte order, little endian everywhere this runs,
+// and every offset is from the start of the file. The node table and
+// edges are 4 byte aligned so they can be read in place once mapped.
+typedef struct
+{
+    char     magic[4]; // "DIAB"
+    uint32_t version;
+    uint32_t nodeCount;
+    uint32_t edgeCount;
+    uint64_t nodeOffset;   // DiagbNode, one per box in save order
+    uint64_t edgeOffset;   // uint32_t, the target of each connection
+    uint64_t stringOffset; // Terminated strings, the empty one first
+    uint64_t stringSize;
+} DiagbHeader;
+
+typedef struct
+{
+    float    position[2];
+    uint32_t text;  // Offset into the strings
+    uint32_t event; // Offset into the strings
+    uint32_t edgeStart; // Connections, in order, are the edges from
+    uint32_t edgeCount; // [edgeStart] on
+} DiagbNode;
+
+// Where each interned string went in a .diagb's string blob
+typedef struct
+{
+    uint32_t*   offsets; // By slb_StringId, UINT32_MAX if not placed
+    slb_Vector* order;   // slb_StringId, in the order they were placed
+    uint32_t    size;    // Bytes of the blob so far
+} DiagbStrings;
+
+// Returns [id]'s offset in the blob, giving it one if it has none
+uint32_t PlaceDiagbString(DiagbStrings* blob, slb_StringId id)
+{
+    if (blob->offsets[id] == UINT32_MAX)
+    {
+        blob->offsets[id] = blob->size;
+        blob->size += slb_StringArena_GetLength(&strings, id) + 1;
+        slb_Vector_PushBack(blob->order, &id);
+    }
+
+    return blob->offsets[id];
+}
+
+// Writes every box to a .diagb: the header, a node table, the
+// connections of all nodes back to back (CSR) and one blob holding
+// each distinct string once. Returns false if it couldn't be written.
+bool SaveDiagb(const char* filename, slb_SlotMap* dialogueBoxes)
+{
+    // Every id the arena has handed out indexes its entries
+    size_t idCount = strings.entries->size;
+
+    DiagbStrings blob = {0};
+    blob.offsets = malloc(idCount * sizeof(uint32_t));
+    blob.order = slb_Vector_Create(sizeof(slb_StringId), 64);
+    memset(blob.offsets, 0xff, idCount * sizeof(uint32_t));
+    PlaceDiagbString(&blob, SLB_EMPTY_STRING);
+
+    // Lay out the nodes first, which settles every offset
+    DiagbNode* nodes =
+        malloc((dialogueBoxes->size + 1) * sizeof(DiagbNode));
+    uint32_t   edgeCount = 0;
+
+    for (size_t i = 0; i < dialogueBoxes->size; i++)
+    {
+        DialogueBox* box = slb_SlotMap_At(dialogueBoxes, i);
+        DiagbNode*   node = &nodes[i];
+
+        glm_vec2_copy(box->renderObject.position, node->position);
+        node->text = PlaceDiagbString(&blob, box->text);
+        node->event = PlaceDiagbString(&blob, box->event);
+        node->edgeStart = edgeCount;
+        node->edgeCount = 0;
+
+        for (size_t j = 0; j < box->connections->size; j++)
+        {
+            slb_Handle target =
+                SLB_VECTOR_AT(box->connections, slb_Handle, j);
+            node->edgeCount +=
+                slb_SlotMap_IndexOf(dialogueBoxes, target) >= 0;
+        }
+
+        edgeCount += node->edgeCount;
+    }
+
+    DiagbHeader header = {0};
+    memcpy(header.magic, "DIAB", 4);
+    header.version = DIAGB_VERSION;
+    header.nodeCount = (uint32_t)dialogueBoxes->size;
+    header.edgeCount = edgeCount;
+    header.nodeOffset = sizeof(DiagbHeader);
+    header.edgeOffset =
+        header.nodeOffset + dialogueBoxes->size * sizeof(DiagbNode);
+    header.stringOffset =
+        header.edgeOffset + (uint64_t)edgeCount * sizeof(uint32_t);
+    header.stringSize = blob.size;
+
+    FILE* file = fopen(filename, "wb");
+    bool  written = file != NULL;
+
+    if (written)
+    {
+        written =
+            fwrite(&header, sizeof(header), 1, file) == 1 &&
+            fwrite(nodes, sizeof(DiagbNode), dialogueBoxes->size,
+                   file) == dialogueBoxes->size;
+    }
+
+    for (size_t i = 0; i < dialogueBoxes->size && written; i++)
+    {
+        DialogueBox* box = slb_SlotMap_At(dialogueBoxes, i);
+
+        for (size_t j = 0; j < box->connections->size; j++)
+        {
+            slb_Handle target =
+                SLB_VECTOR_AT(box->connections, slb_Handle, j);
+            int64_t    index = slb_SlotMap_IndexOf(dialogueBoxes, target);
+
+            if (index >= 0)
+            {
+                uint32_t edge = (uint32_t)index;
+                fwrite(&edge, sizeof(edge), 1, file);
+            }
+        }
+    }
+
+    // In placing order, so each string lands on its offset
+    for (size_t i = 0; i < blob.order->size && written; i++)
+    {
+        slb_StringId id = SLB_VECTOR_AT(blob.order, slb_StringId, i);
+        fwrite(slb_StringArena_Get(&strings, id), 1,
+               slb_StringArena_GetLength(&strings, id) + 1, file);
+    }
+
+    if (file != NULL)
+    {
+        written = !ferror(file) && written;
+        written = fclose(file) == 0 && written;
+    }
+
+    free(nodes);
+    free(blob.offsets);
+    slb_Vector_Free(blob.order);
+
+    return written;
+}
+
+// Checks that everything [header] points at lies inside the file and
+// every node refers to real edges, boxes and strings, so loading can't
+// read out of bounds
+bool ValidateDiagb(const slb_MappedFile* file)
+{
+    if (file->size < sizeof(DiagbHeader))
+    {
+        return false;
+    }
+
+    const DiagbHeader* header = file->data;
+    const char*        bytes = file->data;
+
+    if (memcmp(header->magic, "DIAB", 4) != 0 ||
+        header->version == 0 || header->version > DIAGB_VERSION)
+    {
+        return false;
+    }
+
+    uint64_t nodeBytes = (uint64_t)header->nodeCount * sizeof(DiagbNode);
+    uint64_t edgeBytes = (uint64_t)header->edgeCount * sizeof(uint32_t);
+
+    if (header->nodeOffset % 4 != 0 || header->edgeOffset % 4 != 0 ||
+        header->nodeOffset > file->size ||
+        nodeBytes > file->size - header->nodeOffset ||
+        header->edgeOffset > file->size ||
+        edgeBytes > file->size - header->edgeOffset ||
+        header->stringOffset > file->size ||
+        header->stringSize > file->size - header->stringOffset ||
+        header->stringSize == 0 || header->stringSize > UINT32_MAX)
+    {
+        return false;
+    }
+
+    // With the blob ending in a terminator, every offset inside it
+    // starts a terminated string
+    const char* blob = bytes + header->stringOffset;
+    if (blob[header->stringSize - 1] != '\0')
+    {
+        return false;
+    }
+
+    const DiagbNode* nodes =
+        (const DiagbNode*)(bytes + header->nodeOffset);
+    const uint32_t* edges =
+        (const uint32_t*)(bytes + header->edgeOffset);
+
+    for (uint32_t i = 0; i < header->nodeCount; i++)
+    {
+        const DiagbNode* node = &nodes[i];
+
+        if (node->text >= header->stringSize ||
+            node->event >= header->stringSize ||
+            node->edgeStart > header->edgeCount ||
+            node->edgeCount > header->edgeCount - node->edgeStart)
+        {
+            return false;
+        }
+    }
+
+    for (uint32_t i = 0; i < header->edgeCount; i++)
+    {
+        if (edges[i] >= header->nodeCount)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+// Replaces the scene with the boxes in a .diagb. The file is mapped
+// and read in place, strings are handed to the arena straight out of
+// the mapping.
+void LoadDiagb(const char* filename, slb_SlotMap* dialogueBoxes,
+               slb_SlotMap* lineObjects, EdgeBuffer* edgeBuffer)
+{
+    ClearDialogueBoxes(dialogueBoxes, lineObjects, edgeBuffer);
+
+    slb_MappedFile file;
+    if (!slb_MappedFile_Open(&file, filename))
+    {
+        printf("Failed to load file: %s\n", filename);
+        return;
+    }
+
+    if (!ValidateDiagb(&file))
+    {
+        printf("Failed to load file: %s\n", filename);
+        slb_MappedFile_Close(&file);
+        return;
+    }
+
+    const char*        bytes = file.data;
+    const DiagbHeader* header = file.data;
+    const DiagbNode*   nodes =
+        (const DiagbNode*)(bytes + header->nodeOffset);
+    const uint32_t* edges =
+        (const uint32_t*)(bytes + header->edgeOffset);
+    const char* blob = bytes + header->stringOffset;
+
+    slb_SlotMap_Reserve(dialogueBoxes, header->nodeCount);
+    slb_SlotMap_Reserve(lineObjects, header->edgeCount);
+
+    slb_Handle* handles =
+        malloc(((size_t)header->nodeCount + 1) * sizeof(slb_Handle));
+
+    for (uint32_t i = 0; i < header->nodeCount; i++)
+    {
+        const DiagbNode* node = &nodes[i];
+        vec2 position = {node->position[0], node->position[1]};
+
+        handles[i] = CreateDialogueBox(blob + node->text, position,
+                                       0.01f, dialogueBoxes);
+
+        DialogueBox* box = slb_SlotMap_Get(dialogueBoxes, handles[i]);
+        box->event = slb_StringArena_Intern(&strings, blob + node->event);
+    }
+
+    for (uint32_t i = 0; i < header->nodeCount; i++)
+    {
+        const DiagbNode* node = &nodes[i];
+
+        for (uint32_t j = 0; j < node->edgeCount; j++)
+        {
+            ConnectDialogueBoxes(dialogueBoxes, lineObjects, edgeBuffer,
+                                 handles[i],
+                                 handles[edges[node->edgeStart + j]]);
+        }
+    }
+
+    free(handles);
+    slb_MappedFile_Close(&file);
+}
+
+bool HasExtension(const char* filename, const char* extension)
+{
+    size_t length = strlen(filename);
+    size_t extensionLength = strlen(extension);
+
+    return length >= extensionLength &&
+           strcmp(filename + length - extensionLength, extension) == 0;
+}
+
+// Replaces the scene with [filename], a .diagb or a .diagsv
+void LoadDialogueBoxes(const char* filename, slb_SlotMap* dialogueBoxes,
+                       slb_SlotMap* lineObjects, EdgeBuffer* edgeBuffer)
+{
+    if (HasExtension(filename, ".diagb"))
+    {
+        LoadDiagb(filename, dialogueBoxes, lineObjects, edgeBuffer);
+    }
+    else
+    {
+        LoadDiagsv(filename, dialogueBoxes, lineObjects, edgeBuffer);
+    }
+}
+
+slb_Handle connectionStart = SLB_NULL_HANDLE;
+bool       isConnecting = false;
+
+bool preferencesWindow = false;
+bool manualWindow = false;
+
+double GetSeconds()
+{
+    struct timespec time;
+    timespec_get(&time, TIME_UTC);
+
+    return (double)time.tv_sec + (double)time.tv_nsec / 1e9;
+}
+
+UndoLog CreateUndoLog(size_t byteLimit, slb_SlotMap* dialogueBoxes,
+                      slb_SlotMap* lineObjects, EdgeBuffer* edgeBuffer)
+{
+    UndoLog log = {0};
+    log.edits = slb_Vector_Create(sizeof(Edit), 64);
+    log.byteLimit = byteLimit;
+    log.nextGroup = 1;
+    log.sealed = true;
+    log.dialogueBoxes = dialogueBoxes;
+    log.lineObjects = lineObjects;
+    log.edgeBuffer = edgeBuffer;
+
+    return log;
+}
+
+size_t GetVectorBytes(slb_Vector* vector)
+{
+    return vector->capacity * vector->elemSize;
+}
+
+size_t GetEditBytes(Edit* edit)
+{
+    size_t bytes = sizeof(Edit);
+
+    if ((edit->type == EditType_Create ||
+         edit->type == EditType_Delete) &&
+        edit->stash.stashed)
+    {
+        StashedBox* stash = &edit->stash;
+
+        bytes += GetVectorBytes(stash->box.textObjects) +
+                 GetVectorBytes(stash->box.connections) +
+                 GetVectorBytes(stash->box.incoming) +
+                 GetVectorBytes(stash->box.lines) +
+                 GetVectorBytes(stash->outgoing) +
+                 GetVectorBytes(stash->incoming) +
+                 GetVectorBytes(stash->orders);
+
+        for (int i = 0; i < stash->box.textObjects->size; i++)
+        {
+            TextObject* textObj =
+                slb_Vector_Get(stash->box.textObjects, i);
+            bytes += textObj->vertexCount * sizeof(TextVertex);
+        }
+
+        for (int i = 0; i < stash->orders->size; i++)
+        {
+            ConnectionOrder* order = slb_Vector_Get(stash->orders, i);
+            bytes += GetVectorBytes(order->connections);
+        }
+    }
+    else if (edit->type == EditType_Move)
+    {
+        bytes += GetVectorBytes(edit->move.boxes);
+    }
+    else if (edit->type == EditType_Text ||
+             edit->type == EditType_Event)
+    {
+        bytes += slb_StringArena_GetLength(&strings, edit->text.before) +
+                 slb_StringArena_GetLength(&strings, edit->text.after);
+    }
+
+    return bytes;
+}
+
+// Brings the log's byte count in line after [edit] changed size
+void RecountEdit(UndoLog* log, Edit* edit)
+{
+    log->bytes -= edit->bytes;
+    edit->bytes = GetEditBytes(edit);
+    log->bytes += edit->bytes;
+}
+
+void FreeEdit(UndoLog* log, Edit* edit)
+{
+    if (edit->type == EditType_Create || edit->type == EditType_Delete)
+    {
+        DestroyStashedBox(&edit->stash);
+    }
+    else if (edit->type == EditType_Move)
+    {
+        slb_Vector_Free(edit->move.boxes);
+    }
+    else if (edit->type == EditType_Text || edit->type == EditType_Event)
+    {
+        slb_StringArena_Release(&strings, edit->text.before);
+        slb_StringArena_Release(&strings, edit->text.after);
+    }
+
+    log->bytes -= edit->bytes;
+}
+
+void ClearUndoLog(UndoLog* log)
+{
+    for (int i = 0; i < log->edits->size; i++)
+    {
+        FreeEdit(log, slb_Vector_Get(log->edits, i));
+    }
+
+    slb_Vector_Clear(log->edits);
+    log->undoCount = 0;
+    log->sealed = true;
+}
+
+void DestroyUndoLog(UndoLog* log)
+{
+    ClearUndoLog(log);
+    slb_Vector_Free(log->edits);
+}
+
+// Edits recorded until the matching EndUndoGroup are undone and redone
+// as one, like everything a bulk delete removed
+void BeginUndoGroup(UndoLog* log)
+{
+    if (log->groupDepth++ == 0)
+    {
+        log->openGroup = log->nextGroup++;
+    }
+}
+
+void EndUndoGroup(UndoLog* log)
+{
+    log->groupDepth--;
+    log->sealed = true;
+}
+
+// Keeps the next edit from merging into the last one, like at the end
+// of a drag
+void SealUndo(UndoLog* log)
+{
+    log->sealed = true;
+}
+
+// Drops the oldest groups until the log fits its limit again, always
+// keeping the newest one
+void TrimUndoLog(UndoLog* log)
+{
+    size_t dropCount = 0;
+
+    while (log->bytes > log->byteLimit && dropCount < log->undoCount)
+    {
+        Edit*    oldest = slb_Vector_Get(log->edits, dropCount);
+        uint32_t group = oldest->group;
+        size_t   end = dropCount;
+
+        while (end < log->undoCount &&
+               ((Edit*)slb_Vector_Get(log->edits, end))->group == group)
+        {
+            end++;
+        }
+
+        if (end == log->undoCount)
+        {
+            break;
+        }
+
+        for (; dropCount < end; dropCount++)
+        {
+            FreeEdit(log, slb_Vector_Get(log->edits, dropCount));
+        }
     }
 
-    // Create descriptor sets
-    VkDescriptorSetLayout layouts[SLB_FRAMES_IN_FLIGHT];
-    for (int i = 0; i < SLB_FRAMES_IN_FLIGHT; i++)
+    slb_Vector_EraseRange(log->edits, 0, dropCount);
+    log->undoCount -= dropCount;
+}
+
+// Returns the last edit if [edit] can be folded into it instead of
+// being pushed, which is when both change the same thing of the same
+// box, or the same boxes, in one go
+Edit* GetMergeTarget(UndoLog* log, Edit* edit)
+{
+    if (log->sealed || log->groupDepth > 0 || log->undoCount == 0 ||
+        log->undoCount != log->edits->size)
     {
-        layouts[i] = layout;
+        return NULL;
     }
 
-    VkDescriptorSetAllocateInfo allocInfo = {0};
-    allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
-    allocInfo.descriptorPool = pool;
-    allocInfo.descriptorSetCount = SLB_FRAMES_IN_FLIGHT;
-    allocInfo.pSetLayouts = layouts;
+    Edit* last = slb_Vector_Get(log->edits, log->undoCount - 1);
 
-    if (vkAllocateDescriptorSets(
-            device->device, &allocInfo,
-            lineObj.descriptorSet.descriptorSets) != VK_SUCCESS)
+    if (last->type != edit->type ||
+        !slb_Handle_Equals(last->box, edit->box))
     {
-        slb_Error("Failed to allocate line descriptor sets",
-                  slb_ErrorType_Error);
+        return NULL;
     }
 
-    for (size_t i = 0; i < SLB_FRAMES_IN_FLIGHT; i++)
+    if (edit->type == EditType_Move &&
+        last->move.boxes->size == edit->move.boxes->size &&
+        memcmp(SLB_VECTOR_DATA(last->move.boxes, slb_Handle),
+               SLB_VECTOR_DATA(edit->move.boxes, slb_Handle),
+               edit->move.boxes->size * sizeof(slb_Handle)) == 0)
     {
-        VkDescriptorBufferInfo bufferInfo = {0};
-        bufferInfo.buffer = lineObj.descriptorSet.buffers[i].buffer;
-        bufferInfo.offset = 0;
-        bufferInfo.range = sizeof(UniformBufferObject);
-
-        // For lines, we'll use a dummy texture (you could create a
-        // white 1x1 texture)
-        VkDescriptorImageInfo imageInfo = {0};
-        imageInfo.imageLayout =
-            VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-        imageInfo.imageView =
-            fontAtlas.imageView; // Reuse font atlas as dummy texture
-        imageInfo.sampler = fontAtlas.sampler;
-
-        VkWriteDescriptorSet descriptorWrites[2] = {0};
-
-        descriptorWrites[0].sType =
-            VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-        descriptorWrites[0].dstSet =
-            lineObj.descriptorSet.descriptorSets[i];
-        descriptorWrites[0].dstBinding = 0;
-        descriptorWrites[0].dstArrayElement = 0;
-        descriptorWrites[0].descriptorType =
-            VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-        descriptorWrites[0].descriptorCount = 1;
-        descriptorWrites[0].pBufferInfo = &bufferInfo;
-
-        descriptorWrites[1].sType =
-            VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-        descriptorWrites[1].dstSet =
-            lineObj.descriptorSet.descriptorSets[i];
-        descriptorWrites[1].dstBinding = 1;
-        descriptorWrites[1].dstArrayElement = 0;
-        descriptorWrites[1].descriptorType =
-            VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-        descriptorWrites[1].descriptorCount = 1;
-        descriptorWrites[1].pImageInfo = &imageInfo;
-
-        vkUpdateDescriptorSets(device->device, 2, descriptorWrites, 0,
-                               NULL);
+        return last;
     }
 
-    return lineObj;
+    if ((edit->type == EditType_Text || edit->type == EditType_Event) &&
+        GetSeconds() - log->lastTime < UNDO_MERGE_TIME)
+    {
+        return last;
+    }
+
+    return NULL;
 }
 
+// Pushes [edit], dropping everything that could have been redone
+void PushEdit(UndoLog* log, Edit* edit)
+{
+    for (size_t i = log->undoCount; i < log->edits->size; i++)
+    {
+        FreeEdit(log, slb_Vector_Get(log->edits, i));
+    }
+    slb_Vector_EraseRange(log->edits, log->undoCount,
+                          log->edits->size - log->undoCount);
+
+    edit->group =
+        log->groupDepth > 0 ? log->openGroup : log->nextGroup++;
+    edit->bytes = GetEditBytes(edit);
+
+    slb_Vector_PushBack(log->edits, edit);
+    log->undoCount++;
+    log->bytes += edit->bytes;
+    log->lastTime = GetSeconds();
+    log->sealed = false;
+
+    TrimUndoLog(log);
+}
 
-void CreateDialogueBox(const char* text, vec2 pos, float textScale,
-                       slb_Vector*             renderObjects,
-                       slb_Vector*             textObjects,
-                       slb_Vector*             dialogueBoxes,
-                       slb_PhysicalDevice      physicalDevice,
-                       slb_Device*             device,
-                       slb_CommandPool*        commandPool,
-                       slb_DescriptorSetLayout descriptorSetLayout,
-                       slb_DescriptorPool      descriptorPool)
+void RecordCreate(UndoLog* log, slb_Handle box)
 {
-    CreateDialogueBoxAtIndex(
-        text, pos, textScale, renderObjects, textObjects,
-        dialogueBoxes, dialogueBoxes->size, physicalDevice, device,
-        commandPool, descriptorSetLayout, descriptorPool);
+    Edit edit = {0};
+    edit.type = EditType_Create;
+    edit.box = box;
+
+    PushEdit(log, &edit);
 }
 
-void LoadDialogueBoxes(
-    const char* filename, slb_Vector* renderObjects,
-    slb_Vector* textObjects, slb_Vector* dialogueBoxes,
-    slb_Vector* lineObjects, slb_PhysicalDevice physicalDevice,
-    slb_Device* device, slb_CommandPool* commandPool,
-    slb_DescriptorSetLayout descriptorSetLayout,
-    slb_DescriptorPool      descriptorPool)
+// Unlike the other Record functions this does the delete itself, the
+// box is stashed in the log whole instead of being destroyed
+void RecordDelete(UndoLog* log, slb_Handle box)
 {
-    // Clear existing dialogue boxes (keep cursor at index 0)
-    // Clean up existing dialogue boxes
-    for (int i = 1; i < renderObjects->size; i++)
+    Edit edit = {0};
+    edit.type = EditType_Delete;
+    edit.box = box;
+
+    if (StashDialogueBox(log->dialogueBoxes, log->lineObjects,
+                         log->edgeBuffer, box, &edit.stash))
     {
-        RenderObject* obj = slb_Vector_Get(renderObjects, i);
+        PushEdit(log, &edit);
+    }
+}
 
-        // Destroy render object resources
-        vkDestroyBuffer(device->device, obj->vertexBuffer.buffer,
-                        NULL);
-        vkFreeMemory(device->device, obj->vertexBuffer.memory, NULL);
-        vkDestroyBuffer(device->device, obj->indexBuffer.buffer,
-                        NULL);
-        vkFreeMemory(device->device, obj->indexBuffer.memory, NULL);
+// [boxes] is copied, so it can be the live selection
+void RecordMove(UndoLog* log, slb_Vector* boxes, vec2 delta)
+{
+    Edit edit = {0};
+    edit.type = EditType_Move;
+    edit.move.boxes = boxes;
+    glm_vec2_copy(delta, edit.move.delta);
 
-        vkDestroyImageView(device->device, obj->texture.imageView,
-                           NULL);
-        vkDestroySampler(device->device, obj->texture.sampler, NULL);
-        vkDestroyImage(device->device, obj->texture.image, NULL);
-        vkFreeMemory(device->device, obj->texture.memory, NULL);
+    Edit* last = GetMergeTarget(log, &edit);
+    if (last != NULL)
+    {
+        glm_vec2_add(last->move.delta, delta, last->move.delta);
+        return;
+    }
+
+    edit.move.boxes = CopyHandles(boxes);
+    PushEdit(log, &edit);
+}
+
+void RecordConnect(UndoLog* log, slb_Handle from, slb_Handle to)
+{
+    Edit edit = {0};
+    edit.type = EditType_Connect;
+    edit.box = from;
+    edit.connection.target = to;
+
+    PushEdit(log, &edit);
+}
+
+// [index] is where [to] was in [from]'s connections
+void RecordDisconnect(UndoLog* log, slb_Handle from, slb_Handle to,
+                      int index)
+{
+    Edit edit = {0};
+    edit.type = EditType_Disconnect;
+    edit.box = from;
+    edit.connection.target = to;
+    edit.connection.index = index;
+
+    PushEdit(log, &edit);
+}
+
+// [type] is EditType_Text or EditType_Event. Takes over the reference
+// to [before] and retains [after].
+void RecordTextEdit(UndoLog* log, EditType type, slb_Handle box,
+                    slb_StringId before, slb_StringId after)
+{
+    Edit edit = {0};
+    edit.type = type;
+    edit.box = box;
+    edit.text.before = before;
+    edit.text.after = slb_StringArena_Retain(&strings, after);
+
+    Edit* last = GetMergeTarget(log, &edit);
+    if (last != NULL)
+    {
+        slb_StringArena_Release(&strings, last->text.after);
+        last->text.after = edit.text.after;
+        slb_StringArena_Release(&strings, before);
+
+        RecountEdit(log, last);
+        log->lastTime = GetSeconds();
+        return;
+    }
+
+    PushEdit(log, &edit);
+}
+
+// Points the box's text or event at [text] and lays it out again
+void SetDialogueBoxString(slb_SlotMap* dialogueBoxes, EditType type,
+                          slb_Handle handle, slb_StringId text)
+{
+    DialogueBox* box = slb_SlotMap_Get(dialogueBoxes, handle);
+    if (box == NULL)
+    {
+        return;
+    }
+
+    slb_StringId* id = type == EditType_Text ? &box->text : &box->event;
+    slb_StringId  old = *id;
+    *id = slb_StringArena_Retain(&strings, text);
+    slb_StringArena_Release(&strings, old);
+
+    if (type == EditType_Text)
+    {
+        LayoutDialogueBox(box, 0.01f);
+        UpdateBoxBounds(handle, box);
+    }
+}
+
+// Does [edit] again, or takes it back if [undo]
+void ReplayEdit(UndoLog* log, Edit* edit, bool undo)
+{
+    slb_SlotMap* dialogueBoxes = log->dialogueBoxes;
+    slb_SlotMap* lineObjects = log->lineObjects;
+    EdgeBuffer*  edgeBuffer = log->edgeBuffer;
+
+    switch (edit->type)
+    {
+    case EditType_Create:
+    case EditType_Delete:
+        if (undo == (edit->type == EditType_Create))
+        {
+            StashDialogueBox(dialogueBoxes, lineObjects, edgeBuffer,
+                             edit->box, &edit->stash);
+        }
+        else
+        {
+            RestoreDialogueBox(dialogueBoxes, lineObjects, edgeBuffer,
+                               edit->box, &edit->stash);
+        }
 
-        for (size_t j = 0; j < SLB_FRAMES_IN_FLIGHT; j++)
+        RecountEdit(log, edit);
+        break;
+    case EditType_Move:
+    {
+        vec2 delta;
+        glm_vec2_scale(edit->move.delta, undo ? -1.0f : 1.0f, delta);
+        MoveDialogueBoxes(dialogueBoxes, lineObjects, edgeBuffer,
+                          edit->move.boxes, delta);
+        break;
+    }
+    case EditType_Connect:
+    case EditType_Disconnect:
+        if (undo == (edit->type == EditType_Connect))
+        {
+            DisconnectDialogueBoxes(dialogueBoxes, lineObjects,
+                                    edgeBuffer, edit->box,
+                                    edit->connection.target);
+        }
+        else
         {
-            vkUnmapMemory(device->device,
-                          obj->descriptorSet.buffers[j].memory);
-            vkDestroyBuffer(device->device,
-                            obj->descriptorSet.buffers[j].buffer,
-                            NULL);
-            vkFreeMemory(device->device,
-                         obj->descriptorSet.buffers[j].memory, NULL);
+            ConnectDialogueBoxes(dialogueBoxes, lineObjects, edgeBuffer,
+                                 edit->box, edit->connection.target);
+
+            // Put the connection back where it was, it was appended
+            DialogueBox* source =
+                slb_SlotMap_Get(dialogueBoxes, edit->box);
+            if (edit->type == EditType_Disconnect && source != NULL)
+            {
+                slb_Vector_Remove(source->connections,
+                                  source->connections->size - 1);
+                slb_Vector_Insert(source->connections,
+                                  edit->connection.index,
+                                  &edit->connection.target);
+            }
         }
+        break;
+    case EditType_Text:
+    case EditType_Event:
+        SetDialogueBoxString(dialogueBoxes, edit->type, edit->box,
+                             undo ? edit->text.before : edit->text.after);
+        break;
     }
+}
 
-    // Clean up text objects
-    for (int i = 0; i < textObjects->size; i++)
+// Takes back the last group of edits. Returns false if there was none.
+bool Undo(UndoLog* log)
+{
+    if (log->undoCount == 0)
     {
-        TextObject* textObj = slb_Vector_Get(textObjects, i);
-        DestroyTextObject(textObj, device);
+        return false;
     }
 
-    // Clean up line objects
-    for (int i = 0; i < lineObjects->size; i++)
+    uint32_t group =
+        ((Edit*)slb_Vector_Get(log->edits, log->undoCount - 1))->group;
+
+    while (log->undoCount > 0)
     {
-        LineObject* lineObj = slb_Vector_Get(lineObjects, i);
+        Edit* edit = slb_Vector_Get(log->edits, log->undoCount - 1);
+        if (edit->group != group)
+        {
+            break;
+        }
+
+        ReplayEdit(log, edit, true);
+        log->undoCount--;
+    }
+
+    log->sealed = true;
+    return true;
+}
+
+// Does the last undone group of edits again. Returns false if there
+// was none.
+bool Redo(UndoLog* log)
+{
+    if (log->undoCount == log->edits->size)
+    {
+        return false;
+    }
+
+    uint32_t group =
+        ((Edit*)slb_Vector_Get(log->edits, log->undoCount))->group;
+
+    while (log->undoCount < log->edits->size)
+    {
+        Edit* edit = slb_Vector_Get(log->edits, log->undoCount);
+        if (edit->group != group)
+        {
+            break;
+        }
+
+        ReplayEdit(log, edit, false);
+        log->undoCount++;
+    }
+
+    log->sealed = true;
+    return true;
+}
+
+// Times deleting boxes from random graphs of growing size, two
+// connections per box, and then undoing all the deletes at once. With
+// the adjacency lists the cost per delete should stay flat as the
+// graph grows.
+void RunDeleteBenchmark()
+{
+    const int sizes[] = {1000, 2000, 4000, 8000, 16000, 32000};
+    const int deleteCount = 1000;
+
+    printf("%8s %8s %14s %10s\n", "boxes", "lines", "us per delete",
+           "ms undo");
+
+    for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++)
+    {
+        int boxCount = sizes[s];
+        srand(1);
+
+        // Handles start over with every new slot map
+        slb_SpatialGrid_Clear(&boxGrid);
+
+        slb_SlotMap* dialogueBoxes =
+            slb_SlotMap_Create(sizeof(DialogueBox), boxCount);
+        slb_SlotMap* lineObjects =
+            slb_SlotMap_Create(sizeof(LineObject), boxCount * 2);
+
+        // No GPU buffers, and every line counts as dirty already so
+        // nothing gets queued
+        EdgeBuffer edgeBuffer = {0};
+        for (size_t i = 0; i < SLB_FRAMES_IN_FLIGHT; i++)
+        {
+            edgeBuffer.rewriteAll[i] = true;
+        }
+
+        for (int i = 0; i < boxCount; i++)
+        {
+            CreateDialogueBox("", (vec2) {(float)i, 0.0f}, 0.01f,
+                              dialogueBoxes);
+        }
+
+        for (int i = 0; i < boxCount; i++)
+        {
+            for (int j = 0; j < 2; j++)
+            {
+                ConnectDialogueBoxes(
+                    dialogueBoxes, lineObjects, &edgeBuffer,
+                    slb_SlotMap_HandleAt(dialogueBoxes, i),
+                    slb_SlotMap_HandleAt(dialogueBoxes,
+                                         rand() % boxCount));
+            }
+        }
+
+        UndoLog undoLog = CreateUndoLog(
+            SIZE_MAX, dialogueBoxes, lineObjects, &edgeBuffer);
+
+        size_t lineCount = lineObjects->size;
+        double start = GetSeconds();
+
+        BeginUndoGroup(&undoLog);
+        for (int i = 0; i < deleteCount; i++)
+        {
+            slb_Handle handle = slb_SlotMap_HandleAt(
+                dialogueBoxes, rand() % dialogueBoxes->size);
+            RecordDelete(&undoLog, handle);
+        }
+        EndUndoGroup(&undoLog);
+
+        double elapsed = GetSeconds() - start;
+
+        start = GetSeconds();
+        Undo(&undoLog);
+        double undoElapsed = GetSeconds() - start;
+
+        if (dialogueBoxes->size != (size_t)boxCount ||
+            lineObjects->size != lineCount)
+        {
+            slb_Error("Undo didn't restore every box and line",
+                      slb_ErrorType_Warning);
+        }
+
+        printf("%8d %8zu %14.3f %10.3f\n", boxCount, lineCount,
+               elapsed * 1e6 / deleteCount, undoElapsed * 1e3);
 
-        vkDestroyBuffer(device->device, lineObj->vertexBuffer.buffer,
-                        NULL);
-        vkFreeMemory(device->device, lineObj->vertexBuffer.memory,
-                     NULL);
+        DestroyUndoLog(&undoLog);
 
-        for (size_t j = 0; j < SLB_FRAMES_IN_FLIGHT; j++)
+        for (size_t i = 0; i < dialogueBoxes->size; i++)
         {
-            vkUnmapMemory(device->device,
-                          lineObj->descriptorSet.buffers[j].memory);
-            vkDestroyBuffer(device->device,
-                            lineObj->descriptorSet.buffers[j].buffer,
-                            NULL);
-            vkFreeMemory(device->device,
-                         lineObj->descriptorSet.buffers[j].memory,
-                         NULL);
+            DestroyDialogueBox(slb_SlotMap_At(dialogueBoxes, i));
         }
+
+        slb_SlotMap_Free(dialogueBoxes);
+        slb_SlotMap_Free(lineObjects);
     }
+}
+
+// Prints how long the element at a time vector API and its bulk or
+// typed replacement take for the same job, in milliseconds
+void PrintVectorTiming(const char* name, double oldSeconds,
+                       double newSeconds)
+{
+    printf("%-24s %10.3f %10.3f %8.1fx\n", name, oldSeconds * 1e3,
+           newSeconds * 1e3, oldSeconds / newSeconds);
+}
+
+typedef enum
+{
+    VectorFill_PushBack,
+    VectorFill_Reserve, // Then push back
+    VectorFill_InsertRange,
+} VectorFill;
+
+// Best of a few runs of filling a vector that starts with room for
+// one, so page faults on the first run don't count
+double TimeVectorFill(const int* values, int count, VectorFill fill)
+{
+    double best = DBL_MAX;
 
-    // Clean up dialogue boxes
-    for (int i = 0; i < dialogueBoxes->size; i++)
+    for (int run = 0; run < 5; run++)
     {
-        DialogueBox* box = slb_Vector_Get(dialogueBoxes, i);
-        if (box->connections)
+        double      start = GetSeconds();
+        slb_Vector* vector = slb_Vector_Create(sizeof(int), 1);
+
+        if (fill == VectorFill_InsertRange)
+        {
+            slb_Vector_InsertRange(vector, 0, values, count);
+        }
+        else
         {
-            slb_Vector_Free(box->connections);
+            if (fill == VectorFill_Reserve)
+            {
+                slb_Vector_Reserve(vector, count);
+            }
+
+            for (int i = 0; i < count; i++)
+            {
+                slb_Vector_PushBack(vector, &values[i]);
+            }
         }
+
+        double elapsed = GetSeconds() - start;
+        best = elapsed < best ? elapsed : best;
+
+        slb_Vector_Free(vector);
     }
 
-    // Clear vectors (keep cursor at index 0 for renderObjects)
-    while (renderObjects->size > 1)
+    return best;
+}
+
+// Times the old element at a time slb_Vector calls against Reserve,
+// the range functions, SwapRemove and typed access
+void RunVectorBenchmark()
+{
+    const int count = 250000;
+    const int editCount = 5000;
+
+    int* values = malloc(sizeof(int) * count);
+    for (int i = 0; i < count; i++)
     {
-        slb_Vector_Remove(renderObjects, renderObjects->size - 1);
+        values[i] = i;
     }
 
-    textObjects->size = 0;
-    dialogueBoxes->size = 0;
-    lineObjects->size = 0;
+    printf("%-24s %10s %10s %9s\n", "", "old ms", "new ms", "speedup");
 
-    // Load from JSON file
-    slb_Json json = slb_Json_LoadFromFile(filename);
-    if (!json)
+    double oldTime = TimeVectorFill(values, count, VectorFill_PushBack);
+    PrintVectorTiming("push back / reserve", oldTime,
+                      TimeVectorFill(values, count, VectorFill_Reserve));
+    PrintVectorTiming(
+        "push back / insert range", oldTime,
+        TimeVectorFill(values, count, VectorFill_InsertRange));
+
+    slb_Vector* oldVector = slb_Vector_Create(sizeof(int), 1);
+    slb_Vector* newVector = slb_Vector_Create(sizeof(int), 1);
+
+    for (int i = 0; i < count; i++)
     {
-        printf("Failed to load file: %s\n", filename);
-        return;
+        slb_Vector_PushBack(oldVector, &values[i]);
     }
+    slb_Vector_InsertRange(newVector, 0, values, count);
 
-    int boxCount = slb_Json_GetArraySize(json);
+    // Reading every element
+    volatile long long sink = 0;
+    long long          sum = 0;
 
-    // First pass: Create all dialogue boxes
-    for (int i = 0; i < boxCount; i++)
+    double start = GetSeconds();
+    for (int i = 0; i < count; i++)
+    {
+        sum += *(int*)slb_Vector_Get(oldVector, i);
+    }
+    sink = sum;
+    oldTime = GetSeconds() - start;
+
+    sum = 0;
+    start = GetSeconds();
+    for (int i = 0; i < count; i++)
     {
-        slb_Json boxJson = slb_Json_GetArrayElement(json, i);
+        sum += SLB_VECTOR_AT(newVector, int, i);
+    }
+    sink = sum;
+    PrintVectorTiming("get / typed access", oldTime,
+                      GetSeconds() - start);
+
+    // Inserting a block near the front
+    start = GetSeconds();
+    for (int i = 0; i < editCount; i++)
+    {
+        slb_Vector_Insert(oldVector, 1 + i, &values[i]);
+    }
+    oldTime = GetSeconds() - start;
+
+    start = GetSeconds();
+    slb_Vector_InsertRange(newVector, 1, values, editCount);
+    PrintVectorTiming("insert / insert range", oldTime,
+                      GetSeconds() - start);
+
+    // Erasing it again
+    start = GetSeconds();
+    for (int i = 0; i < editCount; i++)
+    {
+        slb_Vector_Remove(oldVector, 1);
+    }
+    oldTime = GetSeconds() - start;
 
-        vec2 position;
-        slb_Json_LoadFloat2(boxJson, "position", position);
+    start = GetSeconds();
+    slb_Vector_EraseRange(newVector, 1, editCount);
+    PrintVectorTiming("remove / erase range", oldTime,
+                      GetSeconds() - start);
 
-        char text[1024];
-        slb_Json_LoadString(boxJson, "text", text);
+    // Removing scattered elements where the order doesn't matter
+    srand(1);
+    start = GetSeconds();
+    for (int i = 0; i < editCount; i++)
+    {
+        slb_Vector_Remove(oldVector, rand() % oldVector->size);
+    }
+    oldTime = GetSeconds() - start;
 
-        CreateDialogueBox(text, position, 0.01f, renderObjects,
-                          textObjects, dialogueBoxes, physicalDevice,
-                          device, commandPool, descriptorSetLayout,
-                          descriptorPool);
+    srand(1);
+    start = GetSeconds();
+    for (int i = 0; i < editCount; i++)
+    {
+        slb_Vector_SwapRemove(newVector, rand() % newVector->size);
+    }
+    PrintVectorTiming("remove / swap remove", oldTime,
+                      GetSeconds() - start);
 
-        DialogueBox* newBox =
-            slb_Vector_Get(dialogueBoxes, dialogueBoxes->size - 1);
+    (void)sink;
+    slb_Vector_Free(oldVector);
+    slb_Vector_Free(newVector);
+    free(values);
+}
 
-        slb_Json_LoadString(boxJson, "event", newBox->event);
+// Writes [boxCount] random boxes the way Save lays out a .diagsv, with
+// quotes, line breaks and accented letters in the text
+bool WriteBenchmarkDiagsv(const char* filename, int boxCount)
+{
+    slb_JsonWriter writer;
+    if (!slb_JsonWriter_Open(&writer, filename, true))
+    {
+        return false;
     }
 
-    // Create connections
+    slb_JsonWriter_BeginArray(&writer);
+
     for (int i = 0; i < boxCount; i++)
     {
-        slb_Json boxJson = slb_Json_GetArrayElement(json, i);
+        char text[128];
+        snprintf(text, sizeof(text),
+                 "Line %d: \"Where to?\" asked the guard at the "
+                 "caf\xC3\xA9.\nNo answer.",
+                 i);
+
+        char event[32];
+        snprintf(event, sizeof(event), "event_%d", rand() % 50);
+
+        vec2 position = {(float)(rand() % 20000) * 0.05f,
+                         (float)(rand() % 20000) * -0.05f};
+
+        slb_JsonWriter_BeginObject(&writer);
+        slb_JsonWriter_Key(&writer, "position");
+        slb_JsonWriter_Float2(&writer, position);
+        slb_JsonWriter_Key(&writer, "text");
+        slb_JsonWriter_String(&writer, text);
+        slb_JsonWriter_Key(&writer, "event");
+        slb_JsonWriter_String(&writer, event);
+
+        slb_JsonWriter_Key(&writer, "connections");
+        slb_JsonWriter_BeginArray(&writer);
+        for (int j = rand() % 4; j > 0; j--)
+        {
+            slb_JsonWriter_Int(&writer, rand() % boxCount + 1);
+        }
+        slb_JsonWriter_EndArray(&writer);
+
+        slb_JsonWriter_EndObject(&writer);
+    }
+
+    slb_JsonWriter_EndArray(&writer);
+
+    return slb_JsonWriter_Close(&writer);
+}
+
+// Reads every field of every box through views, like a loader would,
+// and returns a sum of it all to check the parsers agree
+double ReadBenchmarkDiagsv(slb_Json json)
+{
+    slb_JsonView boxes = slb_Json_GetView(json);
+    size_t       boxCount = slb_JsonView_Size(boxes);
+    double       sum = 0.0;
+
+    for (size_t i = 0; i < boxCount; i++)
+    {
+        slb_JsonView box = slb_JsonView_At(boxes, i);
+
+        float position[2] = {0};
+        slb_JsonView_ReadFloats(slb_JsonView_Get(box, "position"),
+                                position, 2);
+
+        size_t textLength, eventLength;
+        slb_JsonView_String(slb_JsonView_Get(box, "text"), &textLength);
+        slb_JsonView_String(slb_JsonView_Get(box, "event"),
+                            &eventLength);
+
+        int    connections[16];
+        size_t connectionCount = slb_JsonView_ReadInts(
+            slb_JsonView_Get(box, "connections"), connections, 16);
+
+        sum += position[0] + position[1] + textLength + eventLength;
+        for (size_t j = 0; j < connectionCount && j < 16; j++)
+        {
+            sum += connections[j];
+        }
+    }
+
+    return sum;
+}
+
+typedef struct
+{
+    const char*        name;
+    slb_JsonBackend    backend;
+    slb_JsonTapeKernel kernel; // Tape only
+} JsonBenchmarkParser;
+
+// Times loading generated .diagsv files of growing size with nlohmann
+// and with the tape parser on each kernel the CPU has, then reading
+// every box back through views. Best of three runs each.
+void RunJsonBenchmark()
+{
+    const int   sizes[] = {1000, 10000, 100000};
+    const char* filename = "bench_json.diagsv";
+
+    const JsonBenchmarkParser parsers[] = {
+        {"nlohmann", slb_JsonBackend_Nlohmann, slb_JsonTapeKernel_Scalar},
+        {"tape scalar", slb_JsonBackend_Tape, slb_JsonTapeKernel_Scalar},
+        {"tape sse2", slb_JsonBackend_Tape, slb_JsonTapeKernel_Sse2},
+        {"tape avx2", slb_JsonBackend_Tape, slb_JsonTapeKernel_Avx2},
+    };
+
+    slb_JsonBackend    oldBackend = slb_Json_GetBackend();
+    slb_JsonTapeKernel bestKernel = slb_JsonTape_GetBestKernel();
+
+    printf("%8s %8s %-12s %10s %10s %10s\n", "boxes", "MB", "parser",
+           "load ms", "MB/s", "read ms");
+
+    for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++)
+    {
+        srand(1);
+        if (!WriteBenchmarkDiagsv(filename, sizes[s]))
+        {
+            slb_Error("Couldn't write the benchmark file",
+                      slb_ErrorType_Warning);
+            break;
+        }
 
-        int connectionsCount =
-            slb_Json_GetIntArraySize(boxJson, "connections");
+        FILE* file = fopen(filename, "rb");
+        if (file == NULL)
+        {
+            printf("Failed to open file: %s\n", filename);
+            break;
+        }
+
+        fseek(file, 0, SEEK_END);
+        double megabytes = ftell(file) / (1024.0 * 1024.0);
+        fclose(file);
 
-        if (connectionsCount > 0)
+        double expected = 0.0;
+
+        for (size_t p = 0; p < sizeof(parsers) / sizeof(parsers[0]); p++)
         {
-            int connections[16];
-            slb_Json_LoadIntArray(boxJson, "connections",
-                                  connections);
+            const JsonBenchmarkParser* parser = &parsers[p];
+            if (parser->backend == slb_JsonBackend_Tape &&
+                parser->kernel > bestKernel)
+            {
+                continue;
+            }
+
+            slb_Json_SetBackend(parser->backend);
+            slb_JsonTape_SetKernel(parser->kernel);
+
+            double bestLoad = DBL_MAX;
+            double bestRead = DBL_MAX;
+            double sum = 0.0;
+
+            for (int run = 0; run < 3; run++)
+            {
+                double   start = GetSeconds();
+                slb_Json json = slb_Json_LoadFromFile(filename);
+                double   loaded = GetSeconds();
+
+                if (json == NULL)
+                {
+                    printf("Failed to load file: %s\n", filename);
+                    break;
+                }
+
+                sum = ReadBenchmarkDiagsv(json);
+                double read = GetSeconds();
+
+                bestLoad = fmin(bestLoad, loaded - start);
+                bestRead = fmin(bestRead, read - loaded);
 
-            DialogueBox* sourceBox = slb_Vector_Get(dialogueBoxes, i);
-            RenderObject* sourceObj = slb_Vector_Get(
-                renderObjects, i + 1); // +1 to account for cursor
+                slb_Json_Destroy(json);
+            }
+
+            // nlohmann goes first and is taken to be right
+            if (p == 0)
+            {
+                expected = sum;
+            }
+            else if (sum != expected)
+            {
+                slb_Error("Parsers read the benchmark file differently",
+                          slb_ErrorType_Warning);
+            }
+
+            printf("%8d %8.2f %-12s %10.2f %10.1f %10.2f\n", sizes[s],
+                   megabytes, parser->name, bestLoad * 1e3,
+                   megabytes / bestLoad, bestRead * 1e3);
+        }
+    }
+
+    slb_Json_SetBackend(oldBackend);
+    slb_JsonTape_SetKernel(bestKernel);
+    remove(filename);
+}
+
+int main(int argc, char** argv)
+{
+    // --present-mode fifo|mailbox|immediate, --max-fps <n> and
+    // --always-redraw to render continuously instead of idling.
+    // --bench-delete, --bench-vector and --bench-json run a benchmark
+    // and exit without a window.
+    VkPresentModeKHR presentMode = VK_PRESENT_MODE_FIFO_KHR;
+    float            maxFps = 0.0f;
+    bool             idleRedraw = true;
+
+    strings = slb_StringArena_Create(4096);
+    boxGrid = slb_SpatialGrid_Create(BOX_GRID_CELL_SIZE);
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--present-mode") == 0 && i + 1 < argc)
+        {
+            const char* mode = argv[++i];
 
-            for (int j = 0; j < connectionsCount; j++)
+            if (strcmp(mode, "mailbox") == 0)
             {
-                int targetIndex =
-                    connections[j] -
-                    1; // Convert to 0-based index (connections are
-                       // stored as 1-based)
-
-                if (targetIndex >= 0 &&
-                    targetIndex < renderObjects->size - 1)
-                {
-                    RenderObject* targetObj = slb_Vector_Get(
-                        renderObjects,
-                        targetIndex + 1); // +1 for cursor
-
-                    LineObject line = CreateLineObject(
-                        (vec3) {sourceObj->position[0], 0.0f,
-                                sourceObj->position[1]},
-                        (vec3) {targetObj->position[0], 0.0f,
-                                targetObj->position[1]},
-                        (vec3) {1.0f, 1.0f, 1.0f}, 3.0f,
-                        physicalDevice, device, commandPool,
-                        descriptorSetLayout, descriptorPool);
-
-                    line.firstBoxIndex = i;
-                    line.secondBoxIndex = targetIndex;
-
-                    slb_Vector_PushBack(lineObjects, &line);
-
-                    // Add connection to dialogue box
-                    int connectionValue =
-                        targetIndex + 1; // Store as 1-based index
-                    slb_Vector_PushBack(sourceBox->connections,
-                                        &connectionValue);
-                }
+                presentMode = VK_PRESENT_MODE_MAILBOX_KHR;
+            }
+            else if (strcmp(mode, "immediate") == 0)
+            {
+                presentMode = VK_PRESENT_MODE_IMMEDIATE_KHR;
+            }
+            else if (strcmp(mode, "fifo") == 0)
+            {
+                presentMode = VK_PRESENT_MODE_FIFO_KHR;
+            }
+            else
+            {
+                slb_Error("Unknown present mode, using fifo",
+                          slb_ErrorType_Warning);
             }
         }
+        else if (strcmp(argv[i], "--max-fps") == 0 && i + 1 < argc)
+        {
+            maxFps = (float)atof(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--always-redraw") == 0)
+        {
+            idleRedraw = false;
+        }
+        else if (strcmp(argv[i], "--bench-delete") == 0)
+        {
+            RunDeleteBenchmark();
+            return 0;
+        }
+        else if (strcmp(argv[i], "--bench-vector") == 0)
+        {
+            RunVectorBenchmark();
+            return 0;
+        }
+        else if (strcmp(argv[i], "--bench-json") == 0)
+        {
+            RunJsonBenchmark();
+            return 0;
+        }
     }
 
-    slb_Json_Destroy(json);
-}
-
-RenderObject* currentRenderObject;
-DialogueBox*  currentDialogueBoxObject;
-
-int  firstConnectionDialogueBox = -1;
-int  secondConnectionDialogueBox = -1;
-bool isConnecting = false;
-
-bool preferencesWindow = false;
-bool manualWindow = false;
-
-int main(int argc, char** argv)
-{
     slb_Window window =
         slb_Window_Create("Diagmaker", 1600, 900, false, true);
+    slb_Window_Attach(&window);
 
     slb_Camera camera = slb_Camera_Create((vec3) {0.0f, 5.0f, 0.0f},
                                           (vec3) {0.0f, 0.0f, 1.0f},
@@ -1310,8 +3537,9 @@ int main(int argc, char** argv)
         &device, depthImage.image, VK_FORMAT_D32_SFLOAT,
         VK_IMAGE_ASPECT_DEPTH_BIT);
 
-    slb_Swapchain swapchain = slb_Swapchain_Create(
-        &window, physicalDevice, surface, &device, &depthImage);
+    slb_Swapchain swapchain =
+        slb_Swapchain_Create(&window, physicalDevice, surface, &device,
+                             &depthImage, presentMode);
 
     slb_RenderPass renderPass =
         slb_RenderPass_Create(&swapchain, &device);
@@ -1319,24 +3547,37 @@ int main(int argc, char** argv)
     slb_Swapchain_CreateFramebuffers(&swapchain, &device, renderPass,
                                      &depthImage);
 
-    // Create descriptor set layout
-    VkDescriptorSetLayoutBinding bindings[2] = {0};
+    // Create descriptor set layouts. Set 0 holds the per-frame camera
+    // and is shared by every pipeline, set 1 holds a texture.
+    VkDescriptorSetLayoutBinding cameraBinding = {0};
+    cameraBinding.binding = 0;
+    cameraBinding.descriptorCount = 1;
+    cameraBinding.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+    cameraBinding.pImmutableSamplers = NULL;
+    cameraBinding.stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
+
+    VkDescriptorSetLayoutBinding textureBinding = {0};
+    textureBinding.binding = 0;
+    textureBinding.descriptorCount = 1;
+    textureBinding.descriptorType =
+        VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    textureBinding.pImmutableSamplers = NULL;
+    textureBinding.stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
 
-    bindings[0].binding = 0;
-    bindings[0].descriptorCount = 1;
-    bindings[0].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-    bindings[0].pImmutableSamplers = NULL;
-    bindings[0].stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
+    slb_DescriptorSetLayout cameraSetLayout =
+        slb_DescriptorSetLayout_Create(&cameraBinding, 1, &device);
+    slb_DescriptorSetLayout textureSetLayout =
+        slb_DescriptorSetLayout_Create(&textureBinding, 1, &device);
 
-    bindings[1].binding = 1;
-    bindings[1].descriptorCount = 1;
-    bindings[1].descriptorType =
-        VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-    bindings[1].pImmutableSamplers = NULL;
-    bindings[1].stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+    slb_DescriptorSetLayout setLayouts[] = {cameraSetLayout,
+                                            textureSetLayout};
 
-    slb_DescriptorSetLayout descriptorSetLayout =
-        slb_DescriptorSetLayout_Create(bindings, 2, &device);
+    // Every pipeline declares the same push constant range so the
+    // camera set stays bound across pipeline switches
+    VkPushConstantRange pushConstantRange = {0};
+    pushConstantRange.stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
+    pushConstantRange.offset = 0;
+    pushConstantRange.size = sizeof(DrawPushConstants);
 
     // Create graphics pipeline
     VkVertexInputBindingDescription bindingDescription = {0};
@@ -1356,55 +3597,106 @@ int main(int argc, char** argv)
     attributeDescriptions[1].format = VK_FORMAT_R32G32_SFLOAT;
     attributeDescriptions[1].offset = offsetof(Vertex, texCoord);
 
+    // The box pipeline reads the quad per vertex and a RenderObject
+    // per instance
+    VkVertexInputBindingDescription boxBindingDescriptions[2] = {0};
+    boxBindingDescriptions[0] = bindingDescription;
+
+    boxBindingDescriptions[1].binding = 1;
+    boxBindingDescriptions[1].stride = sizeof(RenderObject);
+    boxBindingDescriptions[1].inputRate = VK_VERTEX_INPUT_RATE_INSTANCE;
+
+    VkVertexInputAttributeDescription boxAttributeDescriptions[5] = {
+        0};
+    boxAttributeDescriptions[0] = attributeDescriptions[0];
+    boxAttributeDescriptions[1] = attributeDescriptions[1];
+
+    boxAttributeDescriptions[2].binding = 1;
+    boxAttributeDescriptions[2].location = 2;
+    boxAttributeDescriptions[2].format = VK_FORMAT_R32G32_SFLOAT;
+    boxAttributeDescriptions[2].offset =
+        offsetof(RenderObject, position);
+
+    boxAttributeDescriptions[3].binding = 1;
+    boxAttributeDescriptions[3].location = 3;
+    boxAttributeDescriptions[3].format = VK_FORMAT_R32G32_SFLOAT;
+    boxAttributeDescriptions[3].offset = offsetof(RenderObject, scale);
+
+    boxAttributeDescriptions[4].binding = 1;
+    boxAttributeDescriptions[4].location = 4;
+    boxAttributeDescriptions[4].format = VK_FORMAT_R32_UINT;
+    boxAttributeDescriptions[4].offset = offsetof(RenderObject, flags);
+
     slb_Pipeline graphicsPipeline = slb_Pipeline_Create(
         &device, &swapchain, renderPass, "shaders/vert.spv",
-        "shaders/frag.spv", &bindingDescription,
-        attributeDescriptions, 2, &descriptorSetLayout, 1,
-        VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST);
+        "shaders/frag.spv", boxBindingDescriptions, 2,
+        boxAttributeDescriptions, 5, setLayouts, 2, &pushConstantRange,
+        1, VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST);
+
+    // Text samples the atlas array, so its coordinates carry the page
+    VkVertexInputBindingDescription textBindingDescription =
+        bindingDescription;
+    textBindingDescription.stride = sizeof(TextVertex);
+
+    VkVertexInputAttributeDescription textAttributeDescriptions[2] = {
+        0};
+    textAttributeDescriptions[0] = attributeDescriptions[0];
+    textAttributeDescriptions[0].offset = offsetof(TextVertex, pos);
+
+    textAttributeDescriptions[1] = attributeDescriptions[1];
+    textAttributeDescriptions[1].format = VK_FORMAT_R32G32B32_SFLOAT;
+    textAttributeDescriptions[1].offset = offsetof(TextVertex, texCoord);
 
     slb_Pipeline textPipeline = slb_Pipeline_Create(
         &device, &swapchain, renderPass, "shaders/text_vert.spv",
-        "shaders/text_frag.spv", &bindingDescription,
-        attributeDescriptions, 2, &descriptorSetLayout, 1,
-        VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST);
+        "shaders/text_frag.spv", &textBindingDescription, 1,
+        textAttributeDescriptions, 2, setLayouts, 2, &pushConstantRange,
+        1, VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST);
 
     slb_Pipeline linePipeline = slb_Pipeline_Create(
         &device, &swapchain, renderPass, "shaders/line_vert.spv",
-        "shaders/line_frag.spv", &bindingDescription,
-        attributeDescriptions, 2, &descriptorSetLayout, 1,
+        "shaders/line_frag.spv", &bindingDescription, 1,
+        attributeDescriptions, 2, setLayouts, 1, &pushConstantRange, 1,
         VK_PRIMITIVE_TOPOLOGY_LINE_LIST);
 
     slb_CommandPool commandPool =
         slb_CommandPool_Create(physicalDevice, &device, surface);
 
-    // Initialize FreeType and create font atlas
-    if (InitializeFreeType("res/fonts/arial.ttf", 48, physicalDevice,
-                           &device, &commandPool) != 0)
+    // Every startup upload goes out in one submit
+    slb_UploadContext uploadContext = slb_UploadContext_Create(
+        physicalDevice, &device, &commandPool);
+
+    // Glyphs are rasterized as text asks for them
+    glyphCache = slb_GlyphCache_Create("res/fonts/arial.ttf", 48,
+                                       physicalDevice, &device,
+                                       &uploadContext);
+    if (glyphCache.face == NULL)
     {
         slb_Error("Failed to initialize FreeType",
                   slb_ErrorType_Error);
         return -1;
     }
 
-    VkDescriptorPoolSize poolSizes[2] = {0};
-    poolSizes[0].type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-    poolSizes[0].descriptorCount =
-        SLB_FRAMES_IN_FLIGHT *
-        (MAX_RENDER_OBJECTS + MAX_TEXT_OBJECTS);
-    poolSizes[1].type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-    poolSizes[1].descriptorCount =
-        SLB_FRAMES_IN_FLIGHT *
-            (MAX_RENDER_OBJECTS + MAX_TEXT_OBJECTS) +
-        SLB_FRAMES_IN_FLIGHT;
-
-    slb_DescriptorPool descriptorPool = slb_DescriptorPool_Create(
-        poolSizes, 2,
-        SLB_FRAMES_IN_FLIGHT *
-                (MAX_RENDER_OBJECTS + MAX_TEXT_OBJECTS) +
-            SLB_FRAMES_IN_FLIGHT,
-        &device);
-
-    slb_ImGui_Init(window.window, instance, descriptorPool,
+    // Scene descriptor sets come out of pools chained on demand, each
+    // set holds either the camera buffer or one texture
+    slb_DescriptorPoolRatio descriptorRatios[] = {
+        {VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 0.5f},
+        {VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1.0f},
+    };
+
+    slb_DescriptorAllocator descriptorAllocator =
+        slb_DescriptorAllocator_Create(&device, descriptorRatios, 2,
+                                       16);
+
+    // ImGui allocates its own font set, keep it out of the scene pools
+    VkDescriptorPoolSize imguiPoolSize = {0};
+    imguiPoolSize.type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    imguiPoolSize.descriptorCount = 16;
+
+    slb_DescriptorPool imguiDescriptorPool =
+        slb_DescriptorPool_Create(&imguiPoolSize, 1, 16, &device);
+
+    slb_ImGui_Init(window.window, instance, imguiDescriptorPool,
                    renderPass, physicalDevice, device.device,
                    commandPool.commandPool, device.graphicsQueue);
 
@@ -1439,33 +3731,65 @@ int main(int argc, char** argv)
 
     int currentFrame = 0;
 
-    slb_Vector* renderObjects =
-        slb_Vector_Create(sizeof(RenderObject), 1);
+    slb_SlotMap* dialogueBoxes =
+        slb_SlotMap_Create(sizeof(DialogueBox), 16);
 
-    slb_Vector* textObjects =
-        slb_Vector_Create(sizeof(TextObject), 1);
+    slb_SlotMap* lineObjects = slb_SlotMap_Create(sizeof(LineObject), 16);
 
-    slb_Vector* dialogueBoxes =
-        slb_Vector_Create(sizeof(DialogueBox), 1);
+    slb_DescriptorSet cameraSet = CreateCameraDescriptorSet(
+        physicalDevice, &device, cameraSetLayout, &descriptorAllocator);
 
-    slb_Vector* lineObjects =
-        slb_Vector_Create(sizeof(LineObject), 1);
+    EdgeBuffer edgeBuffer =
+        CreateEdgeBuffer(64, physicalDevice, &device);
 
-    RenderObject curs = CreateRenderObject(
-        "res/textures/cursor.png", (vec2) {0.0f, 0.0f},
-        (vec2) {0.2f, 0.2f}, physicalDevice, &device, &commandPool,
-        descriptorSetLayout, descriptorPool);
+    TextBatcher textBatcher =
+        CreateTextBatcher(4096, physicalDevice, &device,
+                          textureSetLayout, &descriptorAllocator);
 
-    slb_Vector_PushBack(renderObjects, &curs);
+    slb_TextureCache textureCache = slb_TextureCache_Create(
+        physicalDevice, &device, &uploadContext);
 
-    CreateDialogueBox(
-        "Hello, world!",
-        (vec2) {0.0f, 1.0f}, 0.01f, renderObjects, textObjects,
-        dialogueBoxes, physicalDevice, &device, &commandPool,
-        descriptorSetLayout, descriptorPool);
+    BoxRenderer boxRenderer = CreateBoxRenderer(
+        64, &textureCache, physicalDevice, &device, &uploadContext,
+        textureSetLayout, &descriptorAllocator);
+
+    RenderObject cursor =
+        CreateRenderObject((vec2) {0.0f, 0.0f}, (vec2) {0.2f, 0.2f});
+
+    CreateDialogueBox("Hello, world!", (vec2) {0.0f, 1.0f}, 0.01f,
+                      dialogueBoxes);
 
     bool isDragging = false;
 
+    // slb_Handle of every selected box, the inspected one included
+    slb_Vector* selection = slb_Vector_Create(sizeof(slb_Handle), 16);
+
+    // Rubber band selection, [bandBase] is what was selected before it
+    // started so the band can grow and shrink over it
+    bool        isBandSelecting = false;
+    vec2        bandStart = {0.0f, 0.0f};
+    slb_Vector* bandBase = slb_Vector_Create(sizeof(slb_Handle), 16);
+
+    UndoLog undoLog = CreateUndoLog(UNDO_BYTE_LIMIT, dialogueBoxes,
+                                    lineObjects, &edgeBuffer);
+
+    // Set by the Edit menu, handled with the shortcuts next frame
+    bool undoRequested = false;
+    bool redoRequested = false;
+
+    // Inspector edit buffers and the box they were filled from
+    slb_Handle inspectedDialogueBox = SLB_NULL_HANDLE;
+    char*      editText = NULL;
+    size_t     editTextCapacity = 0;
+    char*      editEvent = NULL;
+    size_t     editEventCapacity = 0;
+
+    CullStats cullStats = {0};
+
+    // Reused every frame for grid queries
+    slb_Vector* gridResults = slb_Vector_Create(sizeof(slb_Handle), 64);
+    slb_Vector* visibleBoxes = slb_Vector_Create(sizeof(uint32_t), 64);
+
     float lastFrame = 0.0f;
     float currentTime = 0.0f;
     float deltaTime = 0.0f;
@@ -1475,8 +3799,33 @@ int main(int argc, char** argv)
     float timeAccumulator = 0.0f;
     char  fpsString[16] = {0};
 
+    int redrawFrames = REDRAW_FRAMES;
+
     while (!slb_Window_ShouldClose(&window))
     {
+        if (slb_Window_ConsumeRedraw(&window))
+        {
+            redrawFrames = REDRAW_FRAMES;
+        }
+
+        // Nothing happened since the last few frames, so the next one
+        // would look the same. Sleep until an event arrives instead.
+        if (idleRedraw && redrawFrames == 0)
+        {
+            slb_Window_WaitEvents(&window, IDLE_TIMEOUT);
+
+            // Don't count the idle time as a frame
+            lastFrame = (float)glfwGetTime();
+            continue;
+        }
+
+        if (redrawFrames > 0)
+        {
+            redrawFrames--;
+        }
+
+        float frameStart = (float)glfwGetTime();
+
         currentTime = (float)glfwGetTime();
         deltaTime = currentTime - lastFrame;
         float elapsed = currentTime - lastTime;
@@ -1484,291 +3833,225 @@ int main(int argc, char** argv)
 
         bool mouseOverGui = slb_ImGui_IsHovering();
 
-        // DIALOUGE BOX SYSTEM
+        // Keys typed into the inspector belong to the text field
+        bool typing = slb_ImGui_IsTyping();
+
+        // UNDO AND REDO
         // ---
 
-        if (slb_Input_GetKeyDown(&window, SLB_KEY_DELETE))
+        bool control =
+            slb_Input_GetKey(&window, SLB_KEY_LEFT_CONTROL) ||
+            slb_Input_GetKey(&window, SLB_KEY_RIGHT_CONTROL);
+        bool shift = slb_Input_GetKey(&window, SLB_KEY_LEFT_SHIFT) ||
+                     slb_Input_GetKey(&window, SLB_KEY_RIGHT_SHIFT);
+
+        // Read every frame, since reading is what updates the key state
+        bool zDown = slb_Input_GetKeyDown(&window, SLB_KEY_Z);
+        bool yDown = slb_Input_GetKeyDown(&window, SLB_KEY_Y);
+
+        if (control && !typing && zDown)
         {
-            // DELETE THE SELECTED DIALOGUE BOX
-            if (currentDialogueBox != -1 &&
-                currentDialogueBox != 0) // Don't delete cursor
+            if (shift)
             {
-                int dialogueIndex =
-                    currentDialogueBox -
-                    1; // Convert to dialogue box index
-                DialogueBox* boxToDelete =
-                    slb_Vector_Get(dialogueBoxes, dialogueIndex);
-                RenderObject* objToDelete =
-                    slb_Vector_Get(renderObjects, currentDialogueBox);
-
-                // Clean up text objects associated with this dialogue
-                // box
-                for (int i = boxToDelete->beginningTextIndex;
-                     i < boxToDelete->numTextObjects +
-                             boxToDelete->beginningTextIndex;
-                     i++)
-                {
-                    TextObject* textObj =
-                        slb_Vector_Get(textObjects, i);
-                    DestroyTextObject(textObj, &device);
-                }
+                redoRequested = true;
+            }
+            else
+            {
+                undoRequested = true;
+            }
+        }
 
-                // Clean up render object
-                DestroyRenderObject(objToDelete, &device);
+        if (control && !typing && yDown)
+        {
+            redoRequested = true;
+        }
 
-                // Remove associated line objects that connect to or
-                // from this dialogue box
-                for (int i = lineObjects->size - 1; i >= 0; i--)
-                {
-                    LineObject* line = slb_Vector_Get(lineObjects, i);
+        if ((undoRequested && Undo(&undoLog)) ||
+            (redoRequested && Redo(&undoLog)))
+        {
+            // The boxes may be gone or have new text
+            PruneSelection(dialogueBoxes, selection);
+            if (!slb_SlotMap_Contains(dialogueBoxes, currentDialogueBox))
+            {
+                currentDialogueBox = SLB_NULL_HANDLE;
+            }
+            if (!slb_SlotMap_Contains(dialogueBoxes, connectionStart))
+            {
+                isConnecting = false;
+            }
 
-                    if (line->firstBoxIndex == dialogueIndex ||
-                        line->secondBoxIndex == dialogueIndex)
-                    {
-                        // Clean up line resources
-                        vkDestroyBuffer(device.device,
-                                        line->vertexBuffer.buffer,
-                                        NULL);
-                        vkFreeMemory(device.device,
-                                     line->vertexBuffer.memory, NULL);
-
-                        for (size_t j = 0; j < SLB_FRAMES_IN_FLIGHT;
-                             j++)
-                        {
-                            vkUnmapMemory(
-                                device.device,
-                                line->descriptorSet.buffers[j]
-                                    .memory);
-                            vkDestroyBuffer(
-                                device.device,
-                                line->descriptorSet.buffers[j].buffer,
-                                NULL);
-                            vkFreeMemory(
-                                device.device,
-                                line->descriptorSet.buffers[j].memory,
-                                NULL);
-                        }
-
-                        slb_Vector_Remove(lineObjects, i);
-                    }
-                }
+            inspectedDialogueBox = SLB_NULL_HANDLE;
+            isDragging = false;
+            isBandSelecting = false;
+        }
 
-                // Update line indices for remaining lines (shift down
-                // indices that are higher than deleted box)
-                for (int i = 0; i < lineObjects->size; i++)
-                {
-                    LineObject* line = slb_Vector_Get(lineObjects, i);
+        undoRequested = false;
+        redoRequested = false;
 
-                    if (line->firstBoxIndex > dialogueIndex)
-                        line->firstBoxIndex--;
-                    if (line->secondBoxIndex > dialogueIndex)
-                        line->secondBoxIndex--;
-                }
+        // ---
 
-                // Remove connections from other dialogue boxes that
-                // point to this one
-                for (int i = 0; i < dialogueBoxes->size; i++)
-                {
-                    if (i != dialogueIndex)
-                    {
-                        DialogueBox* box =
-                            slb_Vector_Get(dialogueBoxes, i);
-
-                        for (int j = box->connections->size - 1;
-                             j >= 0; j--)
-                        {
-                            int* connection =
-                                slb_Vector_Get(box->connections, j);
-
-                            // Remove connection if it points to
-                            // deleted box
-                            if (*connection == currentDialogueBox)
-                            {
-                                slb_Vector_Remove(box->connections,
-                                                  j);
-                            }
-                            // Update connection indices that are
-                            // higher than deleted box
-                            else if (*connection > currentDialogueBox)
-                            {
-                                (*connection)--;
-                            }
-                        }
-                    }
-                }
+        // DIALOUGE BOX SYSTEM
+        // ---
 
-                // Remove text objects (from highest index to lowest
-                // to avoid shifting issues)
-                for (int i = boxToDelete->numTextObjects +
-                             boxToDelete->beginningTextIndex - 1;
-                     i >= boxToDelete->beginningTextIndex; i--)
+        if (slb_Input_GetKeyDown(&window, SLB_KEY_DELETE) && !typing)
+        {
+            // DELETE THE SELECTED DIALOGUE BOXES, UNDONE AS ONE
+            if (selection->size > 0)
+            {
+                BeginUndoGroup(&undoLog);
+                for (size_t i = 0; i < selection->size; i++)
                 {
-                    slb_Vector_Remove(textObjects, i);
+                    RecordDelete(&undoLog,
+                                 SLB_VECTOR_AT(selection, slb_Handle, i));
                 }
+                EndUndoGroup(&undoLog);
 
-                // Update text indices for dialogue boxes that come
-                // after this one
-                for (int i = dialogueIndex + 1;
-                     i < dialogueBoxes->size; i++)
+                // If we were in the middle of connecting from one of
+                // them, reset that too
+                if (isConnecting &&
+                    !slb_SlotMap_Contains(dialogueBoxes, connectionStart))
                 {
-                    DialogueBox* laterBox =
-                        slb_Vector_Get(dialogueBoxes, i);
-                    laterBox->beginningTextIndex -=
-                        boxToDelete->numTextObjects;
+                    isConnecting = false;
+                    connectionStart = SLB_NULL_HANDLE;
                 }
 
-                // Remove render object
-                slb_Vector_Remove(renderObjects, currentDialogueBox);
-
-                // Free dialogue box connections and remove dialogue
-                // box
-                slb_Vector_Free(boxToDelete->connections);
-                slb_Vector_Remove(dialogueBoxes, dialogueIndex);
-
                 // Reset current selection
-                currentDialogueBox = -1;
-                currentDialogueBoxObject = NULL;
-                currentRenderObject = NULL;
+                ClearSelection(dialogueBoxes, selection);
+                currentDialogueBox = SLB_NULL_HANDLE;
                 isDragging = false;
-
-                // If we were in the middle of connecting, reset that
-                // too
-                if (isConnecting && (firstConnectionDialogueBox ==
-                                     currentDialogueBox))
-                {
-                    isConnecting = false;
-                    firstConnectionDialogueBox = -1;
-                }
             }
         }
 
-        for (int i = 1; i < renderObjects->size; i++)
+        // The buttons are polled once and the box under the cursor is
+        // found with a single grid query
+        bool leftDown =
+            slb_Input_GetMouseButtonDown(&window, SLB_MOUSE_BUTTON_LEFT);
+        bool leftUp =
+            slb_Input_GetMouseButtonUp(&window, SLB_MOUSE_BUTTON_LEFT);
+        bool rightDown =
+            slb_Input_GetMouseButtonDown(&window, SLB_MOUSE_BUTTON_RIGHT);
+
+        slb_Handle hovered = SLB_NULL_HANDLE;
+        if (!mouseOverGui)
         {
-            RenderObject* obj = slb_Vector_Get(renderObjects, i);
+            hovered = PickDialogueBox(
+                dialogueBoxes,
+                (vec2) {cursorPosition[0], cursorPosition[2]},
+                gridResults);
+        }
 
-            if (cursorPosition[0] >=
-                    obj->position[0] - obj->scale[0] / 2 &&
-                cursorPosition[0] <=
-                    obj->position[0] + obj->scale[0] / 2 &&
-                cursorPosition[2] >=
-                    obj->position[1] - obj->scale[1] / 2 &&
-                cursorPosition[2] <=
-                    obj->position[1] + obj->scale[1] / 2 &&
-                !mouseOverGui)
+        if (leftDown && !slb_Handle_IsNull(hovered))
+        {
+            if (shift && IsBoxSelected(dialogueBoxes, hovered))
             {
-                if (slb_Input_GetMouseButtonDown(
-                        &window, SLB_MOUSE_BUTTON_LEFT))
+                DeselectDialogueBox(dialogueBoxes, selection, hovered);
+                if (slb_Handle_Equals(currentDialogueBox, hovered))
                 {
-                    currentDialogueBox = i;
-                    currentDialogueBoxObject =
-                        slb_Vector_Get(dialogueBoxes, i - 1);
-                    currentRenderObject =
-                        slb_Vector_Get(dialogueBoxes, i);
-                    isDragging = true;
+                    currentDialogueBox = SLB_NULL_HANDLE;
                 }
-
-                if (slb_Input_GetMouseButtonUp(&window,
-                                               SLB_MOUSE_BUTTON_LEFT))
+            }
+            else
+            {
+                // Clicking into the selection keeps it, so all of it
+                // can be dragged
+                if (!shift && !IsBoxSelected(dialogueBoxes, hovered))
                 {
-                    isDragging = false;
+                    ClearSelection(dialogueBoxes, selection);
                 }
 
-                if (slb_Input_GetMouseButtonDown(
-                        &window, SLB_MOUSE_BUTTON_RIGHT))
-                {
-                    if (!isConnecting)
-                    {
-                        firstConnectionDialogueBox = i;
-                        isConnecting = true;
-                    }
-                    else
-                    {
-                        secondConnectionDialogueBox = i;
-
-                        RenderObject* obj2 = slb_Vector_Get(
-                            renderObjects,
-                            firstConnectionDialogueBox);
-
-                        LineObject line = CreateLineObject(
-                            (vec3) {obj2->position[0], 0.0f,
-                                    obj2->position[1]},
-                            (vec3) {obj->position[0], 0.0f,
-                                    obj->position[1]},
-                            (vec3) {1.0f, 1.0f, 1.0f}, 3.0f,
-                            physicalDevice, &device, &commandPool,
-                            descriptorSetLayout, descriptorPool);
-
-                        line.firstBoxIndex =
-                            firstConnectionDialogueBox - 1;
-                        line.secondBoxIndex =
-                            secondConnectionDialogueBox - 1;
+                SelectDialogueBox(dialogueBoxes, selection, hovered);
+                currentDialogueBox = hovered;
+                isDragging = true;
+            }
+        }
+        else if (leftDown && !mouseOverGui)
+        {
+            // Dragging from empty space selects what the band touches,
+            // adding to the selection while shift is held
+            if (!shift)
+            {
+                ClearSelection(dialogueBoxes, selection);
+                currentDialogueBox = SLB_NULL_HANDLE;
+            }
 
-                        slb_Vector_PushBack(lineObjects, &line);
+            slb_Vector_Clear(bandBase);
+            slb_Vector_InsertRange(bandBase, 0,
+                                   SLB_VECTOR_DATA(selection, slb_Handle),
+                                   selection->size);
 
-                        DialogueBox* diagBox = slb_Vector_Get(
-                            dialogueBoxes,
-                            firstConnectionDialogueBox - 1);
+            bandStart[0] = cursorPosition[0];
+            bandStart[1] = cursorPosition[2];
+            isBandSelecting = true;
+        }
 
-                        slb_Vector_PushBack(diagBox->connections, &i);
+        if (isBandSelecting)
+        {
+            vec2 bandMin = {fminf(bandStart[0], cursorPosition[0]),
+                            fminf(bandStart[1], cursorPosition[2])};
+            vec2 bandMax = {fmaxf(bandStart[0], cursorPosition[0]),
+                            fmaxf(bandStart[1], cursorPosition[2])};
+
+            // Boxes light up as the band passes over them
+            ClearSelection(dialogueBoxes, selection);
+            for (size_t i = 0; i < bandBase->size; i++)
+            {
+                SelectDialogueBox(dialogueBoxes, selection,
+                                  SLB_VECTOR_AT(bandBase, slb_Handle, i));
+            }
 
-                        isConnecting = false;
-                    }
-                }
+            slb_Vector_Clear(gridResults);
+            slb_SpatialGrid_QueryRect(&boxGrid, bandMin, bandMax,
+                                      gridResults);
+            for (size_t i = 0; i < gridResults->size; i++)
+            {
+                SelectDialogueBox(
+                    dialogueBoxes, selection,
+                    SLB_VECTOR_AT(gridResults, slb_Handle, i));
             }
         }
 
-        // ---
-
-        // LINE OBJECT UPDATE SYSTEM
-        // ---
-
-        for (int i = 0; i < lineObjects->size; i++)
+        if (leftUp)
         {
-            LineObject* line = slb_Vector_Get(lineObjects, i);
+            isDragging = false;
+            isBandSelecting = false;
+        }
 
-            if (line->firstBoxIndex != -1 &&
-                line->secondBoxIndex != -1)
+        if (!slb_Handle_IsNull(hovered))
+        {
+            if (rightDown)
             {
-                RenderObject* renderObj1 = slb_Vector_Get(
-                    renderObjects, line->firstBoxIndex + 1);
-                RenderObject* renderObj2 = slb_Vector_Get(
-                    renderObjects, line->secondBoxIndex + 1);
-
-                // Create new vertices with updated positions
-                Vertex lineVertices[2] = {
-                    {{renderObj1->position[0], 0.0f,
-                      renderObj1->position[1]},
-                     {0.0f, 0.0f}},
-                    {{renderObj2->position[0], 0.0f,
-                      renderObj2->position[1]},
-                     {1.0f, 0.0f}}};
-
-                // Update the vertex buffer with new positions
-                VkDeviceSize bufferSize = sizeof(lineVertices);
-
-                // Create staging buffer
-                slb_Buffer stagingBuffer = slb_Buffer_Create(
-                    bufferSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-                    VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
-                        VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-                    physicalDevice, &device);
-
-                void* data;
-                vkMapMemory(device.device, stagingBuffer.memory, 0,
-                            bufferSize, 0, &data);
-                memcpy(data, lineVertices, bufferSize);
-                vkUnmapMemory(device.device, stagingBuffer.memory);
-
-                // Copy to line's vertex buffer
-                slb_CopyBuffer(stagingBuffer.buffer,
-                               line->vertexBuffer.buffer, bufferSize,
-                               &device, &commandPool);
-
-                // Clean up staging buffer
-                vkDestroyBuffer(device.device, stagingBuffer.buffer,
-                                NULL);
-                vkFreeMemory(device.device, stagingBuffer.memory,
-                             NULL);
+                if (!isConnecting)
+                {
+                    connectionStart = hovered;
+                    isConnecting = true;
+                }
+                else
+                {
+                    DialogueBox* diagBox = slb_SlotMap_Get(
+                        dialogueBoxes, connectionStart);
+
+                    // Connecting the same pair again takes the
+                    // connection away
+                    int index = FindHandle(diagBox->connections, hovered);
+
+                    if (index >= 0)
+                    {
+                        DisconnectDialogueBoxes(dialogueBoxes, lineObjects,
+                                                &edgeBuffer,
+                                                connectionStart, hovered);
+                        RecordDisconnect(&undoLog, connectionStart,
+                                         hovered, index);
+                    }
+                    else
+                    {
+                        ConnectDialogueBoxes(dialogueBoxes, lineObjects,
+                                             &edgeBuffer, connectionStart,
+                                             hovered);
+                        RecordConnect(&undoLog, connectionStart, hovered);
+                    }
+
+                    isConnecting = false;
+                }
             }
         }
 
@@ -1781,12 +4064,11 @@ int main(int argc, char** argv)
                                          SLB_MOUSE_BUTTON_MIDDLE) &&
             !mouseOverGui)
         {
-            CreateDialogueBox(
+            slb_Handle handle = CreateDialogueBox(
                 "Hello world",
                 (vec2) {cursorPosition[0], cursorPosition[2]}, 0.01f,
-                renderObjects, textObjects, dialogueBoxes,
-                physicalDevice, &device, &commandPool,
-                descriptorSetLayout, descriptorPool);
+                dialogueBoxes);
+            RecordCreate(&undoLog, handle);
         }
 
         // ---
@@ -1794,27 +4076,19 @@ int main(int argc, char** argv)
         // BOX DRAGGING
         // ---
 
-        if (isDragging)
+        if (isDragging &&
+            (mouseDifference[0] != 0.0f || mouseDifference[2] != 0.0f))
         {
-            RenderObject* obj =
-                slb_Vector_Get(renderObjects, currentDialogueBox);
-            DialogueBox* diagBox =
-                slb_Vector_Get(dialogueBoxes, currentDialogueBox - 1);
-
-            for (int i = diagBox->beginningTextIndex;
-                 i < diagBox->numTextObjects +
-                         diagBox->beginningTextIndex;
-                 i++)
-            {
-
-                TextObject* text = slb_Vector_Get(textObjects, i);
-
-                text->position[0] += mouseDifference[0];
-                text->position[1] += mouseDifference[2];
-            }
+            // A whole drag is undone as one move of the selection
+            vec2 delta = {mouseDifference[0], mouseDifference[2]};
+            MoveDialogueBoxes(dialogueBoxes, lineObjects, &edgeBuffer,
+                              selection, delta);
+            RecordMove(&undoLog, selection, delta);
+        }
 
-            obj->position[0] += mouseDifference[0];
-            obj->position[1] += mouseDifference[2];
+        if (leftUp)
+        {
+            SealUndo(&undoLog);
         }
 
         // ---
@@ -1833,6 +4107,9 @@ int main(int argc, char** argv)
         proj[1][1] *= -1;
         proj[0][0] *= -1;
 
+        VisibleRect visibleRect;
+        ComputeVisibleRect(view, proj, &visibleRect);
+
         vkWaitForFences(device.device, 1,
                         &inFlightFences[currentFrame], VK_TRUE,
                         UINT64_MAX);
@@ -1846,6 +4123,31 @@ int main(int argc, char** argv)
         vkResetFences(device.device, 1,
                       &inFlightFences[currentFrame]);
 
+        // Free the staging memory of uploads that have landed
+        slb_UploadContext_Poll(&uploadContext);
+
+        slb_GlyphCache_BeginFrame(&glyphCache);
+
+        CameraUniforms cameraUniforms = {0};
+        glm_mat4_copy(view, cameraUniforms.view);
+        glm_mat4_copy(proj, cameraUniforms.proj);
+        memcpy(cameraSet.buffersMap[currentFrame], &cameraUniforms,
+               sizeof(cameraUniforms));
+
+        cullStats = (CullStats) {0};
+
+        UpdateEdgeBuffer(&edgeBuffer, currentFrame, lineObjects,
+                         dialogueBoxes, &visibleRect, &cullStats,
+                         physicalDevice, &device);
+        GetVisibleBoxes(dialogueBoxes, &visibleRect, gridResults,
+                        visibleBoxes);
+        UpdateBoxRenderer(&boxRenderer, currentFrame, &cursor,
+                          dialogueBoxes, visibleBoxes, &cullStats,
+                          physicalDevice, &device);
+        UpdateTextBatcher(&textBatcher, currentFrame, dialogueBoxes,
+                          visibleBoxes, &visibleRect, &cullStats,
+                          physicalDevice, &device);
+
         vkResetCommandBuffer(commandPool.commandBuffers[currentFrame],
                              0);
         // RECORD COMMAND BUFFER
@@ -1890,6 +4192,17 @@ int main(int argc, char** argv)
                           VK_PIPELINE_BIND_POINT_GRAPHICS,
                           graphicsPipeline.pipeline);
 
+        // Bound once, every pipeline layout is compatible for set 0
+        vkCmdBindDescriptorSets(
+            commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS,
+            graphicsPipeline.layout, 0, 1,
+            &cameraSet.descriptorSets[currentFrame], 0, NULL);
+
+        // Nothing is transformed per draw yet, the box transforms come
+        // from the instance data and text and lines are baked
+        DrawPushConstants pushConstants = {0};
+        glm_mat4_identity(pushConstants.model);
+
         VkViewport viewport = {0};
         viewport.x = 0.0f;
         viewport.y = 0.0f;
@@ -1904,85 +4217,71 @@ int main(int argc, char** argv)
         scissor.extent = swapchain.swapchainExtent;
         vkCmdSetScissor(commandBuffer, 0, 1, &scissor);
 
-        // Render sprites
-        for (int i = 0; i < renderObjects->size; i++)
+        // Render sprites, the cursor first and then every box in one
+        // instanced draw
         {
-            RenderObject* object = slb_Vector_Get(renderObjects, i);
-
-            VkBuffer vertexBuffers[] = {object->vertexBuffer.buffer};
-            VkDeviceSize offsets[] = {0};
-            vkCmdBindVertexBuffers(commandBuffer, 0, 1, vertexBuffers,
+            VkBuffer vertexBuffers[] = {
+                boxRenderer.vertexBuffer.buffer,
+                boxRenderer.instanceBuffers[currentFrame].buffer};
+            VkDeviceSize offsets[] = {0, 0};
+            vkCmdBindVertexBuffers(commandBuffer, 0, 2, vertexBuffers,
                                    offsets);
             vkCmdBindIndexBuffer(commandBuffer,
-                                 object->indexBuffer.buffer, 0,
+                                 boxRenderer.indexBuffer.buffer, 0,
                                  VK_INDEX_TYPE_UINT16);
 
-            vkCmdBindDescriptorSets(
-                commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS,
-                graphicsPipeline.layout, 0, 1,
-                &object->descriptorSet.descriptorSets[currentFrame],
-                0, NULL);
+            uint32_t indexCount = sizeof(indices) / sizeof(indices[0]);
 
-            vkCmdDrawIndexed(commandBuffer,
-                             sizeof(indices) / sizeof(indices[0]), 1,
-                             0, 0, 0);
+            vkCmdPushConstants(commandBuffer, graphicsPipeline.layout,
+                               VK_SHADER_STAGE_VERTEX_BIT, 0,
+                               sizeof(pushConstants), &pushConstants);
 
-            // UPDATE UNIFORM BUFFERS
-            // ---
+            vkCmdBindDescriptorSets(
+                commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS,
+                graphicsPipeline.layout, 1, 1,
+                &boxRenderer.cursorTextureSet, 0, NULL);
 
-            UniformBufferObject ubo = {0};
+            vkCmdDrawIndexed(commandBuffer, indexCount, 1, 0, 0, 0);
 
-            // Model matrix
-            glm_mat4_identity(ubo.model);
-            glm_translate(ubo.model,
-                          (vec3) {object->position[0], 0.0f,
-                                  object->position[1]});
-            glm_scale(ubo.model, (vec3) {object->scale[0], 0.0f,
-                                         object->scale[1]});
+            uint32_t instanceCount =
+                boxRenderer.instanceCount[currentFrame];
 
-            glm_mat4_copy(proj, ubo.proj);
-            glm_mat4_copy(view, ubo.view);
+            if (instanceCount > 1)
+            {
+                vkCmdBindDescriptorSets(
+                    commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS,
+                    graphicsPipeline.layout, 1, 1,
+                    &boxRenderer.boxTextureSet, 0, NULL);
 
-            memcpy(object->descriptorSet.buffersMap[currentFrame],
-                   &ubo, sizeof(ubo));
+                vkCmdDrawIndexed(commandBuffer, indexCount,
+                                 instanceCount - 1, 0, 0, 1);
+            }
         }
 
         vkCmdBindPipeline(commandBuffer,
                           VK_PIPELINE_BIND_POINT_GRAPHICS,
                           textPipeline.pipeline);
 
-        // Render text
-        for (int i = 0; i < textObjects->size; i++)
+        // Render text, all of it in one draw
+        if (textBatcher.vertexCount[currentFrame] > 0)
         {
-            TextObject* textObj = slb_Vector_Get(textObjects, i);
-
-            VkBuffer vertexBuffers[] = {textObj->vertexBuffer.buffer};
-            VkDeviceSize offsets[] = {0};
+            VkBuffer vertexBuffers[] = {textBatcher.vertexBuffer.buffer};
+            VkDeviceSize offsets[] = {
+                GetTextBatchOffset(&textBatcher, currentFrame)};
             vkCmdBindVertexBuffers(commandBuffer, 0, 1, vertexBuffers,
                                    offsets);
 
+            vkCmdPushConstants(commandBuffer, textPipeline.layout,
+                               VK_SHADER_STAGE_VERTEX_BIT, 0,
+                               sizeof(pushConstants), &pushConstants);
+
             vkCmdBindDescriptorSets(
                 commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS,
-                graphicsPipeline.layout, 0, 1,
-                &textObj->descriptorSet.descriptorSets[currentFrame],
-                0, NULL);
-
-            vkCmdDraw(commandBuffer, textObj->vertexCount, 1, 0, 0);
-
-            // UPDATE TEXT UNIFORM BUFFERS
-            UniformBufferObject textUbo = {0};
-
-            // Model matrix for text
-            glm_mat4_identity(textUbo.model);
-            glm_translate(textUbo.model,
-                          (vec3) {textObj->position[0], 0.01f,
-                                  textObj->position[1]});
-
-            glm_mat4_copy(proj, textUbo.proj);
-            glm_mat4_copy(view, textUbo.view);
+                textPipeline.layout, 1, 1, &textBatcher.textureSet, 0,
+                NULL);
 
-            memcpy(textObj->descriptorSet.buffersMap[currentFrame],
-                   &textUbo, sizeof(textUbo));
+            vkCmdDraw(commandBuffer,
+                      textBatcher.vertexCount[currentFrame], 1, 0, 0);
         }
 
         vkCmdBindPipeline(commandBuffer,
@@ -1992,53 +4291,128 @@ int main(int argc, char** argv)
         // Set line width
         vkCmdSetLineWidth(commandBuffer, 2.0f);
 
-        // Render lines
-        for (int i = 0; i < lineObjects->size; i++)
+        // Render the visible lines, all of them in one draw
+        if (edgeBuffer.indexCount[currentFrame] > 0)
         {
-            LineObject* lineObj = slb_Vector_Get(lineObjects, i);
-
-            VkBuffer vertexBuffers[] = {lineObj->vertexBuffer.buffer};
+            VkBuffer vertexBuffers[] = {
+                edgeBuffer.vertexBuffers[currentFrame].buffer};
             VkDeviceSize offsets[] = {0};
             vkCmdBindVertexBuffers(commandBuffer, 0, 1, vertexBuffers,
                                    offsets);
+            vkCmdBindIndexBuffer(
+                commandBuffer,
+                edgeBuffer.indexBuffers[currentFrame].buffer, 0,
+                VK_INDEX_TYPE_UINT32);
 
-            vkCmdBindDescriptorSets(
-                commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS,
-                linePipeline.layout, 0, 1,
-                &lineObj->descriptorSet.descriptorSets[currentFrame],
-                0, NULL);
-
-            vkCmdDraw(commandBuffer, lineObj->vertexCount, 1, 0, 0);
-
-            UniformBufferObject lineUbo = {0};
-            glm_mat4_copy(lineObj->transform, lineUbo.model);
-            glm_mat4_copy(proj, lineUbo.proj);
-            glm_mat4_copy(view, lineUbo.view);
+            vkCmdPushConstants(commandBuffer, linePipeline.layout,
+                               VK_SHADER_STAGE_VERTEX_BIT, 0,
+                               sizeof(pushConstants), &pushConstants);
 
-            memcpy(lineObj->descriptorSet.buffersMap[currentFrame],
-                   &lineUbo, sizeof(lineUbo));
+            vkCmdDrawIndexed(commandBuffer,
+                             edgeBuffer.indexCount[currentFrame], 1, 0,
+                             0, 0);
         }
 
         slb_ImGui_NewFrame();
 
         slb_ImGui_Begin("Inspector");
 
-        if (currentDialogueBox != -1)
+        DialogueBox* box =
+            slb_SlotMap_Get(dialogueBoxes, currentDialogueBox);
+
+        // The inspector edits copies of the box's strings, which are
+        // interned again whenever they change
+        if (box != NULL && !slb_Handle_Equals(inspectedDialogueBox,
+                                              currentDialogueBox))
         {
-            DialogueBox* box =
-                slb_Vector_Get(dialogueBoxes, currentDialogueBox - 1);
+            SetEditBuffer(&editText, &editTextCapacity,
+                          slb_StringArena_Get(&strings, box->text));
+            SetEditBuffer(&editEvent, &editEventCapacity,
+                          slb_StringArena_Get(&strings, box->event));
+        }
+        inspectedDialogueBox = currentDialogueBox;
+
+        if (box != NULL)
+        {
+            if (slb_ImGui_InputTextMultilineResize(
+                    "Text", &editText, &editTextCapacity, 0))
+            {
+                slb_StringId before =
+                    slb_StringArena_Retain(&strings, box->text);
+                ReplaceString(&box->text, editText);
+                LayoutDialogueBox(box, 0.01f);
+                UpdateBoxBounds(currentDialogueBox, box);
+
+                RecordTextEdit(&undoLog, EditType_Text,
+                               currentDialogueBox, before, box->text);
+            }
 
-            if (slb_ImGui_InputTextMultiline("Text", box->text, 1024,
-                                             0))
+            if (slb_ImGui_InputTextResize("Event", &editEvent,
+                                          &editEventCapacity, 0))
             {
-                UpdateDialogueBox(
-                    currentDialogueBox - 1, renderObjects,
-                    textObjects, dialogueBoxes, lineObjects,
-                    physicalDevice, &device, &commandPool,
-                    descriptorSetLayout, descriptorPool);
+                slb_StringId before =
+                    slb_StringArena_Retain(&strings, box->event);
+                ReplaceString(&box->event, editEvent);
+
+                RecordTextEdit(&undoLog, EditType_Event,
+                               currentDialogueBox, before, box->event);
             }
+        }
 
-            slb_ImGui_InputText("Event", box->event, 1024, 0);
+        if (slb_ImGui_CollapsingHeader("Memory"))
+        {
+            slb_AllocatorStats stats =
+                slb_Allocator_GetStats(device.allocator);
+
+            char statsString[128];
+            snprintf(statsString, sizeof(statsString),
+                     "Blocks: %u (%u dedicated)", stats.blockCount,
+                     stats.dedicatedBlockCount);
+            slb_ImGui_Text(statsString);
+
+            snprintf(statsString, sizeof(statsString),
+                     "Allocations: %u", stats.allocationCount);
+            slb_ImGui_Text(statsString);
+
+            snprintf(statsString, sizeof(statsString),
+                     "Used: %.2f / %.2f MiB",
+                     stats.usedBytes / (1024.0 * 1024.0),
+                     stats.reservedBytes / (1024.0 * 1024.0));
+            slb_ImGui_Text(statsString);
+
+            slb_DescriptorAllocatorStats descriptorStats =
+                slb_DescriptorAllocator_GetStats(&descriptorAllocator);
+
+            snprintf(statsString, sizeof(statsString),
+                     "Descriptor pools: %u (%u sets)",
+                     descriptorStats.poolCount,
+                     descriptorStats.setCapacity);
+            slb_ImGui_Text(statsString);
+
+            snprintf(statsString, sizeof(statsString),
+                     "Descriptor sets: %u live, %u recycled",
+                     descriptorStats.liveSets,
+                     descriptorStats.recycledSets);
+            slb_ImGui_Text(statsString);
+        }
+
+        if (slb_ImGui_CollapsingHeader("Culling"))
+        {
+            char statsString[128];
+            snprintf(statsString, sizeof(statsString),
+                     "Boxes: %u drawn, %u culled", cullStats.drawnBoxes,
+                     cullStats.culledBoxes);
+            slb_ImGui_Text(statsString);
+
+            snprintf(statsString, sizeof(statsString),
+                     "Text: %u drawn, %u culled", cullStats.drawnText,
+                     cullStats.culledText);
+            slb_ImGui_Text(statsString);
+
+            snprintf(statsString, sizeof(statsString),
+                     "Edges: %u drawn, %u culled", cullStats.drawnEdges,
+                     cullStats.culledEdges);
+            slb_ImGui_Text(statsString);
         }
 
         slb_ImGui_End();
@@ -2049,75 +4423,69 @@ int main(int argc, char** argv)
             {
                 if (slb_ImGui_MenuItem("Save"))
                 {
-                    slb_Json json = slb_Json_Create();
-
-                    for (int i = 0; i < dialogueBoxes->size; i++)
+                    if (!SaveDialogueBoxes("untitled.diagsv",
+                                           dialogueBoxes, true, true))
                     {
-                        slb_Json j = slb_Json_Create();
-
-                        DialogueBox* box =
-                            slb_Vector_Get(dialogueBoxes, i);
-                        RenderObject* obj =
-                            slb_Vector_Get(renderObjects, i + 1);
-
-                        slb_Json_SaveFloat2(j, "position",
-                                            obj->position);
-                        slb_Json_SaveString(j, "text", box->text);
-                        slb_Json_SaveString(j, "event", box->event);
-
-                        slb_Json_CreateIntArray(j, "connections");
-                        slb_Json_SaveIntArray(
-                            j, "connections",
-                            (int*)box->connections->data,
-                            box->connections->size);
-
-                        slb_Json_PushBack(json, j);
-
-                        slb_Json_Destroy(j);
+                        slb_Error("Failed to save untitled.diagsv",
+                                  slb_ErrorType_Warning);
+                    }
+                }
+                if (slb_ImGui_MenuItem("Save Binary"))
+                {
+                    if (!SaveDiagb("untitled.diagb", dialogueBoxes))
+                    {
+                        slb_Error("Failed to save untitled.diagb",
+                                  slb_ErrorType_Warning);
                     }
-
-                    slb_Json_SaveToFile(json, "untitled.diagsv");
-
-                    slb_Json_Destroy(json);
                 }
+
+                const char* loadPath = NULL;
                 if (slb_ImGui_MenuItem("Load"))
                 {
-                    LoadDialogueBoxes(
-                        "untitled.diagsv", renderObjects, textObjects,
-                        dialogueBoxes, lineObjects, physicalDevice,
-                        &device, &commandPool, descriptorSetLayout,
-                        descriptorPool);
+                    loadPath = "untitled.diagsv";
                 }
-                if (slb_ImGui_MenuItem("Export"))
+                if (slb_ImGui_MenuItem("Load Binary"))
                 {
-                    slb_Json json = slb_Json_Create();
+                    loadPath = "untitled.diagb";
+                }
 
-                    for (int i = 0; i < dialogueBoxes->size; i++)
+                if (loadPath != NULL)
+                {
+                    // The history refers to the boxes being replaced
+                    ClearUndoLog(&undoLog);
+                    LoadDialogueBoxes(loadPath, dialogueBoxes,
+                                      lineObjects, &edgeBuffer);
+
+                    // Every handle from before the load is stale
+                    slb_Vector_Clear(selection);
+                    currentDialogueBox = SLB_NULL_HANDLE;
+                    isConnecting = false;
+                    isDragging = false;
+                    isBandSelecting = false;
+                }
+                if (slb_ImGui_MenuItem("Export"))
+                {
+                    // Exports are read by the game, not people
+                    if (!SaveDialogueBoxes("untitled.diag", dialogueBoxes,
+                                           false, false))
                     {
-                        slb_Json j = slb_Json_Create();
-
-                        DialogueBox* box =
-                            slb_Vector_Get(dialogueBoxes, i);
-                        RenderObject* obj =
-                            slb_Vector_Get(renderObjects, i + 1);
-
-                        slb_Json_SaveString(j, "text", box->text);
-                        slb_Json_SaveString(j, "event", box->event);
-
-                        slb_Json_CreateIntArray(j, "connections");
-                        slb_Json_SaveIntArray(
-                            j, "connections",
-                            (int*)box->connections->data,
-                            box->connections->size);
-
-                        slb_Json_PushBack(json, j);
-
-                        slb_Json_Destroy(j);
+                        slb_Error("Failed to export untitled.diag",
+                                  slb_ErrorType_Warning);
                     }
+                }
 
-                    slb_Json_SaveToFile(json, "untitled.diag");
+                slb_ImGui_EndMenu();
+            }
 
-                    slb_Json_Destroy(json);
+            if (slb_ImGui_BeginMenu("Edit"))
+            {
+                if (slb_ImGui_MenuItem("Undo"))
+                {
+                    undoRequested = true;
+                }
+                if (slb_ImGui_MenuItem("Redo"))
+                {
+                    redoRequested = true;
                 }
 
                 slb_ImGui_EndMenu();
@@ -2188,6 +4556,11 @@ int main(int argc, char** argv)
         submitInfo.pCommandBuffers =
             &commandPool.commandBuffers[currentFrame];
 
+        // Anything recorded this frame is submitted ahead of the draw,
+        // including glyphs rasterized while building the UI
+        slb_GlyphCache_Flush(&glyphCache);
+        slb_UploadContext_Flush(&uploadContext);
+
         VkSemaphore signalSemaphores[] = {
             renderFinishedSemaphores[currentFrame]};
         submitInfo.signalSemaphoreCount = 1;
@@ -2224,51 +4597,77 @@ int main(int argc, char** argv)
         glm_vec3_sub(cursorPosition, prevMousePosition,
                      mouseDifference);
 
-        glm_vec2_copy(
-            (vec2) {cursorPosition[0], cursorPosition[2]},
-            ((RenderObject*)slb_Vector_Get(renderObjects, 0))
-                ->position);
+        glm_vec2_copy((vec2) {cursorPosition[0], cursorPosition[2]},
+                      cursor.position);
 
         glm_vec3_copy(cursorPosition, prevMousePosition);
 
-        ControlCamera(&camera, &window, deltaTime * 15.0f);
+        if (ControlCamera(&camera, &window, deltaTime * 15.0f))
+        {
+            redrawFrames = REDRAW_FRAMES;
+        }
+
+        // Glyphs that found no room in the atlas are retried next frame
+        if (glyphCache.glyphsDeferred)
+        {
+            redrawFrames = REDRAW_FRAMES;
+        }
 
         slb_Window_Update(&window);
+
+        // Events still wake the loop up while it waits out the cap
+        if (maxFps > 0.0f)
+        {
+            double frameEnd = frameStart + 1.0 / maxFps;
+            while (true)
+            {
+                double remaining = frameEnd - glfwGetTime();
+                if (remaining <= 0.0)
+                {
+                    break;
+                }
+
+                slb_Window_WaitEvents(&window, remaining);
+            }
+        }
     }
 
     // Cleanup
     vkDeviceWaitIdle(device.device);
 
-    // Destroy text objects
-    for (int i = 0; i < textObjects->size; i++)
+    // Destroy dialogue boxes and their text objects, including the
+    // ones only the undo log still holds
+    DestroyUndoLog(&undoLog);
+    for (size_t i = 0; i < dialogueBoxes->size; i++)
     {
-        TextObject* textObj = slb_Vector_Get(textObjects, i);
-        vkDestroyBuffer(device.device, textObj->vertexBuffer.buffer,
-                        NULL);
-        vkFreeMemory(device.device, textObj->vertexBuffer.memory,
-                     NULL);
-
-        for (size_t j = 0; j < SLB_FRAMES_IN_FLIGHT; j++)
-        {
-            vkUnmapMemory(device.device,
-                          textObj->descriptorSet.buffers[j].memory);
-            vkDestroyBuffer(device.device,
-                            textObj->descriptorSet.buffers[j].buffer,
-                            NULL);
-            vkFreeMemory(device.device,
-                         textObj->descriptorSet.buffers[j].memory,
-                         NULL);
-        }
+        DialogueBox* box = slb_SlotMap_At(dialogueBoxes, i);
+        DestroyDialogueBox(box);
     }
 
-    // Cleanup font atlas
-    vkDestroyImageView(device.device, fontAtlas.imageView, NULL);
-    vkDestroySampler(device.device, fontAtlas.sampler, NULL);
-    vkDestroyImage(device.device, fontAtlas.image, NULL);
-    vkFreeMemory(device.device, fontAtlas.memory, NULL);
+    DestroyTextBatcher(&textBatcher, &descriptorAllocator, &device);
+    DestroyEdgeBuffer(&edgeBuffer, &device);
+    DestroyBoxRenderer(&boxRenderer, &textureCache,
+                       &descriptorAllocator, &device);
+    DestroyCameraDescriptorSet(&cameraSet, &device, cameraSetLayout,
+                               &descriptorAllocator);
+    slb_DescriptorAllocator_Destroy(&descriptorAllocator);
+    slb_TextureCache_Destroy(&textureCache);
+    slb_UploadContext_Destroy(&uploadContext);
 
-    slb_Vector_Free(renderObjects);
-    slb_Vector_Free(textObjects);
+    // Cleanup font atlas
+    slb_GlyphCache_Destroy(&glyphCache);
+
+    slb_SlotMap_Free(dialogueBoxes);
+    slb_SlotMap_Free(lineObjects);
+
+    free(editText);
+    free(editEvent);
+    slb_Vector_Free(gridResults);
+    slb_Vector_Free(visibleBoxes);
+    slb_Vector_Free(selection);
+    slb_Vector_Free(bandBase);
+    slb_SpatialGrid_Destroy(&boxGrid);
+    slb_StringArena_Destroy(&strings);
 
     return 0;
 }